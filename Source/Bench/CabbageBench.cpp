@@ -0,0 +1,935 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+#include "../CabbageUtils.h"
+#include "../Plugin/CabbagePluginProcessor.h"
+
+#if JUCE_LINUX || JUCE_MAC
+#include <sys/resource.h>
+#endif
+
+//==============================================================================
+// cabbage-bench: micro benchmarks for the plugin's hot paths, followed by a
+// run over every .csd in the examples corpus. Results are printed to stdout
+// as JSON so they can be compared between releases.
+//
+// usage: cabbage-bench [--corpus dir] [--no-corpus] [--dump-widgets]
+//                      [--verify-widgets file] [--verify-midi] [--verify-state]
+//
+// The corpus defaults to ./Examples. Any folder of instruments can be passed
+// to compare them against the examples. --dump-widgets prints the identifiers
+// every widget line in the corpus parses to instead, along with what they are
+// after two identchannel() messages, so the output of two builds can be
+// diffed to check the parser. --verify-widgets parses the corpus again and
+// compares it with a dump, printing any difference and returning 1 if there
+// is one. Source/Bench/ExamplesWidgets.txt is the dump of ./Examples, run
+// from the top of the tree:
+//
+//   cabbage-bench --verify-widgets Source/Bench/ExamplesWidgets.txt
+//
+// --verify-midi plays a fixed pattern of notes through processBlock() with
+// 1024 sample host blocks and checks that the sound and the MIDI they cause
+// start within one k-cycle of where the notes were, returning 1 if not.
+// --verify-state saves a plugin state with values other than the defaults,
+// restores it into a processor that has to reload the instrument to do so,
+// and returns 1 unless Csound's channels hold the saved values afterwards.
+//==============================================================================
+
+//these are normally provided by StandaloneFilterApp.cpp
+ApplicationProperties* appProperties = nullptr;
+PropertySet* defaultPropSet = nullptr;
+String currentApplicationDirectory;
+StringArray undoHistory;
+
+extern CabbagePluginAudioProcessor* JUCE_CALLTYPE createCabbagePluginFilter(String inputfile, bool guiOnOff, int plugType);
+
+typedef double BenchSample;     //MYFLT in a 64-bit Csound build
+
+//the copy into and out of spin/spout that processBlock() does for each span,
+//on its own. Returns nanoseconds per sample frame
+static double timeExchange(int numChannels, int blockSize, int ksmps, BenchSample scale)
+{
+    const int numBlocks = jmax(1, (1<<20)/blockSize);
+    AudioSampleBuffer buffer(numChannels, blockSize);
+    HeapBlock<BenchSample> spin(ksmps*numChannels, true), spout(ksmps*numChannels, true);
+    Random rand;
+    for(int i=0; i<ksmps*numChannels; i++)
+        spout[i] = rand.nextDouble();
+
+    const float outputScale = 1.f/scale;
+    float** audioBuffers = buffer.getArrayOfWritePointers();
+    int index = ksmps;
+    const int64 start = Time::getHighResolutionTicks();
+    for(int block=0; block<numBlocks; block++)
+    {
+        for(int i=0; i<blockSize;)
+        {
+            if(index==ksmps)
+                index = 0;
+            const int span = jmin(blockSize-i, ksmps-index);
+            const int pos = index*numChannels;
+            cUtils::interleaveSamples(spin+pos, audioBuffers, i, numChannels, span, scale);
+            cUtils::deinterleaveSamples(audioBuffers, i, spout+pos, numChannels, span, outputScale);
+            index += span;
+            i += span;
+        }
+    }
+    const double seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-start);
+    return seconds*1.0e9/(double(numBlocks)*blockSize);
+}
+
+//an up and down pass through the oversampling filters, without Csound in between.
+//Returns nanoseconds per host sample frame
+static double timeOversampling(int factor, int numChannels, int ksmps)
+{
+    const int numSpans = jmax(1, (1<<20)/ksmps);
+    AudioSampleBuffer buffer(numChannels, ksmps);
+    Random rand;
+    for(int channel=0; channel<numChannels; channel++)
+        for(int i=0; i<ksmps; i++)
+            buffer.setSample(channel, i, rand.nextFloat()*2.f-1.f);
+
+    CabbageOversampler oversampler(factor);
+    oversampler.prepare(numChannels, ksmps);
+    const int64 start = Time::getHighResolutionTicks();
+    for(int span=0; span<numSpans; span++)
+    {
+        oversampler.upsample(buffer.getArrayOfReadPointers(), 0, ksmps);
+        for(int channel=0; channel<numChannels; channel++)
+            FloatVectorOperations::copy(oversampler.getDownsamplerInput()[channel],
+                                        oversampler.getUpsampledChannels()[channel], ksmps*factor);
+        oversampler.downsample(buffer.getArrayOfWritePointers(), 0, ksmps);
+    }
+    const double seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-start);
+    return seconds*1.0e9/(double(numSpans)*ksmps);
+}
+
+static String benchmarkOversampling()
+{
+    const int factors[] = {2, 4, 8};
+    const int channelCounts[] = {1, 2, 8};
+    const int ksmps = 32;
+    StringArray results;
+
+    for(int f=0; f<3; f++)
+        for(int c=0; c<3; c++)
+        {
+            CabbageOversampler oversampler(factors[f]);
+            results.add("    {\"factor\": "+String(factors[f])
+                        +", \"channels\": "+String(channelCounts[c])
+                        +", \"hostKsmps\": "+String(ksmps)
+                        +", \"latencySamples\": "+String(oversampler.getLatencyInSamples())
+                        +", \"nsPerFrame\": "+String(timeOversampling(factors[f], channelCounts[c], ksmps), 3)+"}");
+        }
+
+    return "  \"oversampling\": [\n"+results.joinIntoString(",\n")+"\n  ]";
+}
+
+//==============================================================================
+//the reads getParameter() makes for each widget, first through the property
+//set as it worked before widgets kept a typed descriptor, then through the
+//descriptor. Returns nanoseconds per widget
+static double timeWidgetReads(const Array<CabbageGUIType>& widgets, bool typed, float& sum)
+{
+    const int numPasses = 2000;
+    const int64 start = Time::getHighResolutionTicks();
+    for(int pass=0; pass<numPasses; pass++)
+        for(int i=0; i<widgets.size(); i++)
+        {
+            const CabbageGUIType& widget = widgets.getReference(i);
+            if(typed)
+            {
+                if(widget.getKind()==CabbageGUIType::comboboxWidget)
+                    sum += widget.getValue()/widget.getComboRange();
+                else if(widget.getKind()==CabbageGUIType::checkboxWidget ||
+                        widget.getKind()==CabbageGUIType::buttonWidget)
+                    sum += widget.getValue();
+                else
+                    sum += (widget.getValue()-widget.getMin())/widget.getRange();
+            }
+            else
+            {
+                const NamedValueSet& props = widget.cabbageIdentifiers;
+                const String type = props.getWithDefault(CabbageIDs::type, "").toString();
+                const float value = props.getWithDefault(CabbageIDs::value, 0);
+                if(type==CabbageIDs::combobox)
+                    sum += value/float(props.getWithDefault(CabbageIDs::comborange, 1));
+                else if(type==CabbageIDs::checkbox || type==CabbageIDs::button)
+                    sum += value;
+                else
+                    sum += (value-float(props.getWithDefault(CabbageIDs::min, 0)))
+                           /float(props.getWithDefault(CabbageIDs::range, 1));
+            }
+        }
+    const double seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-start);
+    return seconds*1.0e9/(double(numPasses)*widgets.size());
+}
+
+static String benchmarkWidgetReads()
+{
+    const char* lines[] = {"rslider bounds(10, 10, 60, 60), channel(\"gain\"), range(0, 1, .5)",
+                           "combobox bounds(10, 80, 80, 20), channel(\"wave\"), items(\"sine\", \"saw\", \"square\")",
+                           "checkbox bounds(10, 110, 80, 20), channel(\"bypass\"), value(1)",
+                           "button bounds(10, 140, 80, 20), channel(\"trigger\"), text(\"off\", \"on\")",
+                           "hslider bounds(10, 170, 200, 30), channel(\"freq\"), range(20, 20000, 1000, .25)"
+                          };
+    Array<CabbageGUIType> widgets;
+    for(int i=0; i<500; i++)
+        widgets.add(CabbageGUIType(lines[i%5], i));
+
+    float sum = 0;
+    const double propertySetNs = timeWidgetReads(widgets, false, sum);
+    const double descriptorNs = timeWidgetReads(widgets, true, sum);
+    return "  \"widgetReads\": {\"widgets\": "+String(widgets.size())
+           +", \"propertySetNsPerWidget\": "+String(propertySetNs, 3)
+           +", \"descriptorNsPerWidget\": "+String(descriptorNs, 3)
+           +", \"checksum\": "+String(sum, 3)+"}";
+}
+
+//==============================================================================
+//what the editor does with the layout widgets on each refresh, first by
+//checking every widget's type and identchannel message as it did before the
+//processor marked dirty widgets, then by taking the marked ones. Returns
+//nanoseconds per refresh
+static double timeRefreshScan(Array<CabbageGUIType>& widgets, bool dirtySet, int& touched)
+{
+    const int numPasses = 2000;
+    CabbageDirtyWidgetSet dirtyWidgets;
+    dirtyWidgets.clear(widgets.size());
+    Array<int> indices;
+
+    const int64 start = Time::getHighResolutionTicks();
+    for(int pass=0; pass<numPasses; pass++)
+    {
+        //two widgets get an identchannel message between refreshes
+        const int first = pass%widgets.size(), second = (pass*7)%widgets.size();
+        if(dirtySet)
+        {
+            dirtyWidgets.mark(first);
+            dirtyWidgets.mark(second);
+            dirtyWidgets.takeMarked(indices);
+            for(int n=0; n<indices.size(); n++)
+                if(widgets.getReference(indices.getUnchecked(n)).getKind()!=CabbageGUIType::otherWidget)
+                    touched++;
+        }
+        else
+        {
+            widgets.getReference(first).setStringProp(CabbageIDs::identchannelmessage, "visible(1)");
+            widgets.getReference(second).setStringProp(CabbageIDs::identchannelmessage, "visible(1)");
+            for(int i=0; i<widgets.size(); i++)
+            {
+                CabbageGUIType& widget = widgets.getReference(i);
+                const String type = widget.getStringProp(CabbageIDs::type);
+                if((type.equalsIgnoreCase("label") || type.equalsIgnoreCase("image") || type.equalsIgnoreCase("groupbox"))
+                        && widget.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+                {
+                    widget.setStringProp(CabbageIDs::identchannelmessage, "");
+                    touched++;
+                }
+            }
+        }
+    }
+    const double seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-start);
+    return seconds*1.0e9/numPasses;
+}
+
+static String benchmarkRefreshScan()
+{
+    const char* lines[] = {"label bounds(10, 10, 80, 20), text(\"Gain\"), identchannel(\"labelIdent\")",
+                           "image bounds(10, 40, 80, 80), colour(40, 40, 40), identchannel(\"imageIdent\")",
+                           "groupbox bounds(100, 10, 200, 120), text(\"Filter\"), identchannel(\"groupIdent\")"
+                          };
+    Array<CabbageGUIType> widgets;
+    for(int i=0; i<500; i++)
+        widgets.add(CabbageGUIType(lines[i%3], i));
+
+    int touched = 0;
+    const double scanNs = timeRefreshScan(widgets, false, touched);
+    const double dirtySetNs = timeRefreshScan(widgets, true, touched);
+    return "  \"refreshScan\": {\"layoutWidgets\": "+String(widgets.size())
+           +", \"dirtyPerRefresh\": 2"
+           +", \"scanNsPerRefresh\": "+String(scanNs, 3)
+           +", \"dirtySetNsPerRefresh\": "+String(dirtySetNs, 3)
+           +", \"touched\": "+String(touched)+"}";
+}
+
+//==============================================================================
+//draws an svg knob into a slider sized image at a sweep of angles, first
+//parsing and rendering it rotated on every call as cUtils::drawFromSVG() used
+//to, then as drawRotarySlider() does, through CabbageSVGCache. Returns
+//microseconds per draw
+static double timeSVGDraws(const String& svgText, bool cached, int numDraws)
+{
+    const Rectangle<float> bounds(2.f, 2.f, 60.f, 60.f);
+    Image slider(Image::ARGB, 64, 64, true);
+    Graphics g(slider);
+    const int64 start = Time::getHighResolutionTicks();
+    for(int i=0; i<numDraws; i++)
+    {
+        const float angle = (i%300)/300.f*float_Pi*1.5f;
+        if(cached)
+            cUtils::drawRotatedSVG(g, svgText, svgRSliderDiameter, svgRSliderDiameter, bounds, angle);
+        else
+        {
+            Image image(Image::ARGB, svgRSliderDiameter, svgRSliderDiameter, true);
+            ScopedPointer<XmlElement> svg(XmlDocument::parse(svgText));
+            ScopedPointer<Drawable> drawable(Drawable::createFromSVG(*svg));
+            {
+                Graphics graph(image);
+                drawable->draw(graph, 1.f, AffineTransform::rotation(angle, svgRSliderDiameter/2, svgRSliderDiameter/2));
+            }
+            g.drawImage(image, bounds.getX(), bounds.getY(), bounds.getWidth(), bounds.getHeight(),
+                        0, 0, svgRSliderDiameter, svgRSliderDiameter, false);
+        }
+    }
+    const double seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-start);
+    return seconds*1.0e6/numDraws;
+}
+
+static String benchmarkSVGDraws()
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    const String knob = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+                        "<circle cx=\"50\" cy=\"50\" r=\"45\" fill=\"#303030\" stroke=\"#a0a0a0\" stroke-width=\"3\"/>"
+                        "<circle cx=\"50\" cy=\"50\" r=\"30\" fill=\"#505050\"/>"
+                        "<rect x=\"47\" y=\"8\" width=\"6\" height=\"30\" rx=\"3\" fill=\"#f0f0f0\"/></svg>";
+    const int numDraws = 3000;
+    const double parsedUs = timeSVGDraws(knob, false, numDraws);
+    CabbageSVGCache::getInstance()->clear();
+    const double cachedUs = timeSVGDraws(knob, true, numDraws);
+    return "  \"svgDraws\": {\"draws\": "+String(numDraws)
+           +", \"parsedUsPerDraw\": "+String(parsedUs, 3)
+           +", \"cachedUsPerDraw\": "+String(cachedUs, 3)
+           +", \"renderings\": "+String(CabbageSVGCache::getInstance()->getNumRenderings())
+           +", \"cacheBytes\": "+String((int64)CabbageSVGCache::getInstance()->getMemoryUsed())+"}";
+}
+
+//==============================================================================
+static double elapsedMs(int64 startTicks)
+{
+    return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-startTicks)*1000.0;
+}
+
+//peak resident set size of the whole process so far, in kilobytes
+static int64 getPeakMemoryKb()
+{
+#if JUCE_LINUX
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage)==0)
+        return usage.ru_maxrss;
+#elif JUCE_MAC
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage)==0)
+        return usage.ru_maxrss/1024;
+#endif
+    return 0;
+}
+
+//parses every line of the <Cabbage> section the way compileCsoundAndCreateGUI() does
+static double timeGUIParse(const String& csdText, int& numLines)
+{
+    StringArray lines;
+    lines.addLines(csdText.fromFirstOccurrenceOf("<Cabbage>", false, false)
+                          .upToFirstOccurrenceOf("</Cabbage>", false, false));
+    numLines = 0;
+    const int64 start = Time::getHighResolutionTicks();
+    for(int i=0; i<lines.size(); i++)
+    {
+        const String line = lines[i].trim();
+        if(line.isEmpty() || line.startsWithChar(';'))
+            continue;
+        CabbageGUIType cAttr(line, i);
+        numLines++;
+    }
+    return elapsedMs(start);
+}
+
+//runs a second of audio through processBlock() and returns nanoseconds per sample
+//frame, or -1 if Csound stopped performing part way through
+static double timeProcessBlock(CabbagePluginAudioProcessor& processor, int blockSize)
+{
+    const double sampleRate = processor.getCsoundSamplingRate();
+    const int numChannels = jmax(processor.getNumInputChannels(), processor.getNumOutputChannels());
+    const int numBlocks = jmax(1, roundToInt(sampleRate/blockSize));
+    AudioSampleBuffer buffer(numChannels, blockSize);
+    MidiBuffer midiBuffer;
+
+    processor.prepareToPlay(sampleRate, blockSize);
+    const int64 start = Time::getHighResolutionTicks();
+    for(int block=0; block<numBlocks; block++)
+    {
+        buffer.clear();
+        midiBuffer.clear();
+        processor.processBlock(buffer, midiBuffer);
+        if(processor.getCompileStatus()!=OK)
+            return -1;
+    }
+    const double ms = elapsedMs(start);
+
+    //let the identchannel and change messages that were posted be handled
+    MessageManager::getInstance()->runDispatchLoopUntil(0);
+    return ms*1.0e6/(double(numBlocks)*blockSize);
+}
+
+static String benchmarkInstrument(const File& csdFile, const File& corpus)
+{
+    const int blockSizes[] = {64, 256, 1024};
+    String result;
+    result << "    {\"file\": \"" << csdFile.getRelativePathFrom(corpus).replace("\\", "/") << "\"";
+
+    int numLines = 0;
+    const double parseMs = timeGUIParse(csdFile.loadFileAsString(), numLines);
+    result << ", \"guiLines\": " << numLines << ", \"parseMs\": " << String(parseMs, 3);
+
+    //the constructor runs compileCsoundAndCreateGUI()
+    int64 start = Time::getHighResolutionTicks();
+    ScopedPointer<CabbagePluginAudioProcessor> processor = createCabbagePluginFilter(csdFile.getFullPathName(), false, AUDIO_PLUGIN);
+    result << ", \"compileMs\": " << String(elapsedMs(start), 3);
+
+    if(processor->getCompileStatus()!=OK)
+        return result << ", \"compiled\": false, \"peakMemoryKb\": " << getPeakMemoryKb() << "}";
+
+    result << ", \"compiled\": true"
+           << ", \"channels\": " << processor->getNumOutputChannels()
+           << ", \"sampleRate\": " << processor->getCsoundSamplingRate()
+           << ", \"ksmps\": " << processor->getCsoundKsmpsSize()
+           << ", \"oversampling\": " << processor->getOversampling();
+
+    StringArray blocks;
+    for(int b=0; b<3; b++)
+        blocks.add("{\"blockSize\": "+String(blockSizes[b])
+                   +", \"nsPerFrame\": "+String(timeProcessBlock(*processor, blockSizes[b]), 3)+"}");
+    result << ", \"processBlock\": [" << blocks.joinIntoString(", ") << "]";
+
+    //GUI updates as often as the scheduler allows, then effectively never
+    processor->setGuiRefreshRate(1);
+    const double guiOn = timeProcessBlock(*processor, 256);
+    processor->setGuiRefreshRate(1<<20);
+    const double guiOff = timeProcessBlock(*processor, 256);
+    result << ", \"guiUpdatesOnNsPerFrame\": " << String(guiOn, 3)
+           << ", \"guiUpdatesOffNsPerFrame\": " << String(guiOff, 3);
+
+    processor = nullptr;
+    return result << ", \"peakMemoryKb\": " << getPeakMemoryKb() << "}";
+}
+
+//an instrument that copies numChannels inputs straight to its outputs, so
+//that timing processBlock() with it is mostly the audio exchange. 0dbfs is
+//left at 32768 so the scaling is included
+static File writeThroughInstrument(int numChannels, int ksmps)
+{
+    String csd;
+    csd << "<Cabbage>\nform size(200, 100), text(\"bench\")\n</Cabbage>\n"
+        << "<CsoundSynthesizer>\n<CsOptions>\n-n -d\n</CsOptions>\n<CsInstruments>\n"
+        << "sr = 44100\nksmps = " << ksmps << "\nnchnls = " << numChannels << "\n\ninstr 1\n";
+    for(int channel=1; channel<=numChannels; channel++)
+        csd << "a" << channel << " inch " << channel << "\noutch " << channel << ", a" << channel << "\n";
+    csd << "endin\n</CsInstruments>\n<CsScore>\ni1 0 z\n</CsScore>\n</CsoundSynthesizer>\n";
+
+    const File file(File::getSpecialLocation(File::tempDirectory)
+                    .getChildFile("cabbage-bench-"+String(numChannels)+"ch.csd"));
+    file.replaceWithText(csd);
+    return file;
+}
+
+//processBlock() on a pass-through instrument at each channel count, next to
+//the cost of the spin/spout copy on its own
+static String benchmarkAudioExchange()
+{
+    const int channelCounts[] = {2, 8, 32};
+    const int blockSizes[] = {64, 256, 1024};
+    const int ksmps = 32;
+    StringArray results;
+
+    for(int c=0; c<3; c++)
+    {
+        const File csdFile = writeThroughInstrument(channelCounts[c], ksmps);
+        ScopedPointer<CabbagePluginAudioProcessor> processor = createCabbagePluginFilter(csdFile.getFullPathName(), false, AUDIO_PLUGIN);
+        for(int b=0; b<3; b++)
+        {
+            const double exchange = timeExchange(channelCounts[c], blockSizes[b], ksmps, 32768.0);
+            const double processBlock = processor->getCompileStatus()==OK ? timeProcessBlock(*processor, blockSizes[b]) : -1;
+            results.add("    {\"channels\": "+String(channelCounts[c])
+                        +", \"blockSize\": "+String(blockSizes[b])
+                        +", \"ksmps\": "+String(ksmps)
+                        +", \"exchangeNsPerFrame\": "+String(exchange, 3)
+                        +", \"processBlockNsPerFrame\": "+String(processBlock, 3)+"}");
+        }
+        processor = nullptr;
+        csdFile.deleteFile();
+    }
+
+    return "  \"audioExchange\": [\n"+results.joinIntoString(",\n")+"\n  ]";
+}
+
+class FileSorter
+{
+public:
+    static int compareElements(const File& a, const File& b)
+    {
+        return a.getFullPathName().compare(b.getFullPathName());
+    }
+};
+
+//every widget line in the corpus, in file order
+static StringArray getCorpusWidgetLines(const File& corpus)
+{
+    Array<File> csdFiles;
+    corpus.findChildFiles(csdFiles, File::findFiles, true, "*.csd");
+    FileSorter sorter;
+    csdFiles.sort(sorter);
+
+    StringArray widgetLines;
+    for(int i=0; i<csdFiles.size(); i++)
+    {
+        StringArray lines;
+        lines.addLines(csdFiles[i].loadFileAsString().fromFirstOccurrenceOf("<Cabbage>", false, false)
+                                  .upToFirstOccurrenceOf("</Cabbage>", false, false));
+        for(int j=0; j<lines.size(); j++)
+        {
+            const String line = lines[j].trim();
+            if(line.isNotEmpty() && !line.startsWithChar(';'))
+                widgetLines.add(line);
+        }
+    }
+    return widgetLines;
+}
+
+//parse throughput over the whole corpus, for a full widget line and for the
+//kind of identchannel() message that updates a widget while it's running
+static String benchmarkGUIParse(const File& corpus)
+{
+    const StringArray lines = getCorpusWidgetLines(corpus);
+    const String message("bounds(10, 10, 100, 20), colour(255, 0, 0), text(\"on\"), visible(1)");
+    const int numPasses = 10;
+
+    int64 start = Time::getHighResolutionTicks();
+    for(int pass=0; pass<numPasses; pass++)
+        for(int i=0; i<lines.size(); i++)
+            CabbageGUIType cAttr(lines[i], i);
+    const double lineUs = elapsedMs(start)*1000.0/(double(numPasses)*jmax(1, lines.size()));
+
+    Array<CabbageGUIType> widgets;
+    for(int i=0; i<lines.size(); i++)
+        widgets.add(CabbageGUIType(lines[i], i));
+    start = Time::getHighResolutionTicks();
+    for(int pass=0; pass<numPasses; pass++)
+        for(int i=0; i<widgets.size(); i++)
+        {
+            CabbageGUIType& widget = widgets.getReference(i);
+            widget.parse(widget.getStringProp(CabbageIDs::type)+" "+message, message);
+        }
+    const double messageUs = elapsedMs(start)*1000.0/(double(numPasses)*jmax(1, widgets.size()));
+
+    return "  \"guiParse\": {\"lines\": "+String(lines.size())
+           +", \"usPerLine\": "+String(lineUs, 3)
+           +", \"linesPerSecond\": "+String(roundToInt(1.0e6/jmax(1.0e-6, lineUs)))
+           +", \"usPerIdentChannelMessage\": "+String(messageUs, 3)+"}";
+}
+
+//values are tagged with their type, so a number that comes back as a string
+//counts as a difference
+static String dumpVar(const var& value)
+{
+    if(value.isArray())
+    {
+        StringArray elements;
+        for(int i=0; i<value.size(); i++)
+            elements.add(dumpVar(value[i]));
+        return "["+elements.joinIntoString("|")+"]";
+    }
+    if(value.isDouble())
+        return "d:"+String((double)value, 6);
+    if(value.isInt() || value.isInt64())
+        return "i:"+value.toString();
+    if(value.isBool())
+        return "b:"+value.toString();
+    return "s:"+value.toString();
+}
+
+static StringArray dumpIdentifiers(const CabbageGUIType& cAttr)
+{
+    StringArray props;
+    for(int j=0; j<cAttr.cabbageIdentifiers.size(); j++)
+        props.add(cAttr.cabbageIdentifiers.getName(j).toString()+"="+dumpVar(cAttr.cabbageIdentifiers.getValueAt(j)));
+    props.sort(false);
+    return props;
+}
+
+//identifiers a message changed, and those it removed with a leading '-'
+static String dumpChanges(const StringArray& before, const StringArray& after)
+{
+    StringArray changes;
+    for(int i=0; i<after.size(); i++)
+        if(!before.contains(after[i]))
+            changes.add(after[i]);
+    for(int i=0; i<before.size(); i++)
+    {
+        const String name = before[i].upToFirstOccurrenceOf("=", true, false);
+        bool removed = true;
+        for(int j=0; j<after.size() && removed; j++)
+            removed = !after[j].startsWith(name);
+        if(removed)
+            changes.add("-"+name.dropLastCharacters(1));
+    }
+    return "    > "+changes.joinIntoString("; ");
+}
+
+//each widget line, what it parses to, and what changes after an identchannel()
+//message for a layout widget and then one for a control
+static StringArray dumpWidgets(const File& corpus)
+{
+    const StringArray lines = getCorpusWidgetLines(corpus);
+    const String layoutMessage("bounds(5, 6, 7, 8), colour(255, 0, 0), text(\"hi\"), visible(0)");
+    const String controlMessage("value(2), fontcolour(1, 2, 3)");
+    StringArray dump;
+    for(int i=0; i<lines.size(); i++)
+    {
+        //names are generated from the widget's position, so leave them out
+        CabbageGUIType cAttr(lines[i], 0);
+        const StringArray parsed = dumpIdentifiers(cAttr);
+        dump.add(lines[i]);
+        dump.add("    "+parsed.joinIntoString("; "));
+        cAttr.parse(cAttr.getStringProp(CabbageIDs::type)+" "+layoutMessage, layoutMessage);
+        const StringArray afterLayoutMessage = dumpIdentifiers(cAttr);
+        dump.add(dumpChanges(parsed, afterLayoutMessage));
+        cAttr.parse(cAttr.getStringProp(CabbageIDs::type)+" "+controlMessage, controlMessage);
+        dump.add(dumpChanges(afterLayoutMessage, dumpIdentifiers(cAttr)));
+    }
+    return dump;
+}
+
+//compares the corpus with a dump written by --dump-widgets
+static bool verifyWidgets(const File& corpus, const File& expectedFile)
+{
+    if(!expectedFile.existsAsFile())
+    {
+        std::cerr << "no widget dump found at " << expectedFile.getFullPathName() << std::endl;
+        return false;
+    }
+
+    StringArray expected;
+    expected.addLines(expectedFile.loadFileAsString());
+    while(expected.size()>0 && expected[expected.size()-1].isEmpty())
+        expected.remove(expected.size()-1);
+    const StringArray actual = dumpWidgets(corpus);
+
+    int differences = 0;
+    for(int i=0; i<jmax(expected.size(), actual.size()); i++)
+    {
+        if(expected[i]==actual[i])
+            continue;
+        if(++differences<=20)
+            std::cerr << "line " << i+1 << "\n  expected: " << expected[i] << "\n  actual:   " << actual[i] << std::endl;
+    }
+
+    std::cerr << actual.size() << " lines checked, " << differences << " different" << std::endl;
+    return differences==0 && actual.size()>0;
+}
+
+//==============================================================================
+//every note starts a constant at the output and sends a note-on back out
+static const char* midiJitterCsd =
+    "<Cabbage>\n"
+    "form caption(\"MIDI jitter\"), size(100, 100)\n"
+    "</Cabbage>\n"
+    "<CsoundSynthesizer>\n"
+    "<CsOptions>\n"
+    "-n -d -+rtmidi=NULL -M0 -Q0\n"
+    "</CsOptions>\n"
+    "<CsInstruments>\n"
+    "sr = 44100\n"
+    "ksmps = 16\n"
+    "nchnls = 2\n"
+    "0dbfs = 1\n"
+    "massign 0, 1\n"
+    "instr 1\n"
+    "inote notnum\n"
+    "noteon 1, inote, 100\n"
+    "aout = 0.5\n"
+    "outs aout, aout\n"
+    "endin\n"
+    "</CsInstruments>\n"
+    "<CsScore>\n"
+    "f0 3600\n"
+    "</CsScore>\n"
+    "</CsoundSynthesizer>\n";
+
+//how far each onset came after the note-on that caused it. They may all be late,
+//but they should all be late by about the same amount
+static bool checkOnsetJitter(const String& name, const Array<int>& noteOns, const Array<int>& onsets, int tolerance)
+{
+    if(onsets.size()!=noteOns.size())
+    {
+        std::cerr << name << ": " << noteOns.size() << " notes sent, " << onsets.size() << " onsets found" << std::endl;
+        return false;
+    }
+
+    int minDelay = 0, maxDelay = 0;
+    for(int i=0; i<onsets.size(); i++)
+    {
+        const int delay = onsets[i]-noteOns[i];
+        minDelay = i==0 ? delay : jmin(minDelay, delay);
+        maxDelay = i==0 ? delay : jmax(maxDelay, delay);
+    }
+
+    std::cerr << name << ": " << onsets.size() << " onsets, " << minDelay << " to " << maxDelay
+              << " samples late, jitter " << maxDelay-minDelay << ", tolerance " << tolerance << std::endl;
+    return onsets.size()>0 && minDelay>=0 && maxDelay-minDelay<=tolerance;
+}
+
+//notes are spaced so that they land at every offset into a k-cycle and a host
+//block. Csound reads MIDI once per k-cycle, so onsets can't be expected to spread
+//by less than ksmps-1 samples, but they shouldn't depend on the host block
+static bool verifyMidiJitter()
+{
+    const int blockSize = 1024, numNotes = 64, firstNote = 1000, noteSpacing = 1531, noteLength = 400;
+    const double sampleRate = 44100;
+
+    TemporaryFile csdFile(".csd");
+    csdFile.getFile().replaceWithText(midiJitterCsd);
+    ScopedPointer<CabbagePluginAudioProcessor> processor = createCabbagePluginFilter(csdFile.getFile().getFullPathName(), false, AUDIO_PLUGIN);
+    if(processor->getCompileStatus()!=OK)
+    {
+        std::cerr << "the MIDI test instrument didn't compile" << std::endl;
+        return false;
+    }
+
+    processor->prepareToPlay(sampleRate, blockSize);
+    AudioSampleBuffer buffer(jmax(processor->getNumInputChannels(), processor->getNumOutputChannels()), blockSize);
+    MidiBuffer midiBuffer;
+    Array<int> noteOns, audioOnsets, midiOnsets;
+    float previousSample = 0.f;
+
+    const int numBlocks = (firstNote+numNotes*noteSpacing)/blockSize+2;
+    for(int block=0; block<numBlocks; block++)
+    {
+        const int blockStart = block*blockSize;
+        buffer.clear();
+        midiBuffer.clear();
+        for(int note=0; note<numNotes; note++)
+        {
+            const int noteOn = firstNote+note*noteSpacing;
+            if(noteOn>=blockStart && noteOn<blockStart+blockSize)
+            {
+                midiBuffer.addEvent(MidiMessage::noteOn(1, 60, (uint8)100), noteOn-blockStart);
+                noteOns.add(noteOn);
+            }
+            if(noteOn+noteLength>=blockStart && noteOn+noteLength<blockStart+blockSize)
+                midiBuffer.addEvent(MidiMessage::noteOff(1, 60), noteOn+noteLength-blockStart);
+        }
+
+        processor->processBlock(buffer, midiBuffer);
+        if(processor->getCompileStatus()!=OK)
+        {
+            std::cerr << "Csound stopped performing" << std::endl;
+            return false;
+        }
+
+        const float* output = buffer.getReadPointer(0);
+        for(int i=0; i<blockSize; i++)
+        {
+            if(previousSample<0.25f && output[i]>=0.25f)
+                audioOnsets.add(blockStart+i);
+            previousSample = output[i];
+        }
+
+        //processBlock() hands back the MIDI Csound wrote in place of what it was given
+        MidiBuffer::Iterator iterator(midiBuffer);
+        MidiMessage message;
+        int samplePosition;
+        while(iterator.getNextEvent(message, samplePosition))
+            if(message.isNoteOn())
+                midiOnsets.add(blockStart+samplePosition);
+    }
+
+    const int tolerance = processor->getCsoundKsmpsSize()-1;
+    const bool audioPassed = checkOnsetJitter("audio", noteOns, audioOnsets, tolerance);
+    const bool midiPassed = checkOnsetJitter("midi out", noteOns, midiOnsets, tolerance);
+    return audioPassed && midiPassed;
+}
+
+//==============================================================================
+//the sourcebutton makes the state name the .csd, so restoring it reloads the
+//instrument. Ranges of 0 to 1 mean setParameter() takes the same values in
+//plugin and standalone builds
+static const char* stateCsd =
+    "<Cabbage>\n"
+    "form caption(\"State\"), size(300, 100)\n"
+    "sourcebutton bounds(10, 10, 80, 20), text(\"Open\")\n"
+    "hslider bounds(10, 40, 200, 20), channel(\"gain\"), range(0, 1, 0.25)\n"
+    "hslider bounds(10, 60, 200, 20), channel(\"mix\"), range(0, 1, 0.5)\n"
+    "checkbox bounds(220, 40, 60, 20), channel(\"bypass\"), value(0)\n"
+    "</Cabbage>\n"
+    "<CsoundSynthesizer>\n"
+    "<CsOptions>\n"
+    "-n -d\n"
+    "</CsOptions>\n"
+    "<CsInstruments>\n"
+    "sr = 44100\n"
+    "ksmps = 32\n"
+    "nchnls = 2\n"
+    "0dbfs = 1\n"
+    "instr 1\n"
+    "kgain chnget \"gain\"\n"
+    "endin\n"
+    "</CsInstruments>\n"
+    "<CsScore>\n"
+    "i1 0 3600\n"
+    "</CsScore>\n"
+    "</CsoundSynthesizer>\n";
+
+//runs about a second of silence through the processor, then lets the
+//messages it posted be handled
+static bool runProcessor(CabbagePluginAudioProcessor& processor, double sampleRate, int blockSize)
+{
+    AudioSampleBuffer buffer(jmax(processor.getNumInputChannels(), processor.getNumOutputChannels()), blockSize);
+    MidiBuffer midiBuffer;
+    for(int block=0; block<roundToInt(sampleRate/blockSize); block++)
+    {
+        buffer.clear();
+        midiBuffer.clear();
+        processor.processBlock(buffer, midiBuffer);
+        if(processor.getCompileStatus()!=OK)
+            return false;
+    }
+    MessageManager::getInstance()->runDispatchLoopUntil(0);
+    return true;
+}
+
+static bool verifyStateRestore()
+{
+    const char* channels[] = {"gain", "mix", "bypass"};
+    const float values[] = {0.8f, 0.1f, 1.f};
+    const int blockSize = 256;
+    const double sampleRate = 44100;
+
+    TemporaryFile savedCsd(".csd"), otherCsd(".csd");
+    savedCsd.getFile().replaceWithText(stateCsd);
+    otherCsd.getFile().replaceWithText(stateCsd);
+
+    MemoryBlock state;
+    {
+        ScopedPointer<CabbagePluginAudioProcessor> processor = createCabbagePluginFilter(savedCsd.getFile().getFullPathName(), false, AUDIO_PLUGIN);
+        if(processor->getCompileStatus()!=OK)
+        {
+            std::cerr << "the state test instrument didn't compile" << std::endl;
+            return false;
+        }
+        processor->prepareToPlay(sampleRate, blockSize);
+        for(int i=0; i<processor->getNumParameters(); i++)
+            for(int c=0; c<3; c++)
+                if(processor->getGUICtrls(i).getChannel()==channels[c])
+                    processor->setParameter(i, values[c]);
+        if(!runProcessor(*processor, sampleRate, blockSize))
+            return false;
+        processor->getStateInformation(state);
+    }
+
+    ScopedPointer<CabbagePluginAudioProcessor> processor = createCabbagePluginFilter(otherCsd.getFile().getFullPathName(), false, AUDIO_PLUGIN);
+    processor->prepareToPlay(sampleRate, blockSize);
+    processor->setStateInformation(state.getData(), (int)state.getSize());
+    if(!runProcessor(*processor, sampleRate, blockSize))
+    {
+        std::cerr << "the restored instrument didn't compile" << std::endl;
+        return false;
+    }
+
+    int differences = 0;
+    for(int c=0; c<3; c++)
+    {
+        const float value = (float)processor->getCsound()->GetChannel(channels[c]);
+        std::cerr << channels[c] << ": saved " << values[c] << ", restored " << value << std::endl;
+        if(std::abs(value-values[c])>1.0e-4f)
+            differences++;
+    }
+    return differences==0;
+}
+
+static String benchmarkCorpus(const File& corpus)
+{
+    Array<File> csdFiles;
+    corpus.findChildFiles(csdFiles, File::findFiles, true, "*.csd");
+    FileSorter sorter;
+    csdFiles.sort(sorter);
+
+    StringArray results;
+    for(int i=0; i<csdFiles.size(); i++)
+    {
+        std::cerr << "[" << i+1 << "/" << csdFiles.size() << "] " << csdFiles[i].getFileName() << std::endl;
+        results.add(benchmarkInstrument(csdFiles[i], corpus));
+    }
+
+    return "  \"corpus\": {\"path\": \""+corpus.getFullPathName()+"\", \"instruments\": [\n"
+           +results.joinIntoString(",\n")+"\n  ]}";
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    StringArray args;
+    for(int i=1; i<argc; i++)
+        args.add(argv[i]);
+
+    const int index = args.indexOf("--corpus");
+    const int verifyIndex = args.indexOf("--verify-widgets");
+    if((index>=0 && (index+1>=args.size() || args[index+1].startsWith("--")))
+            || (verifyIndex>=0 && (verifyIndex+1>=args.size() || args[verifyIndex+1].startsWith("--"))))
+    {
+        std::cerr << "usage: cabbage-bench [--corpus dir] [--no-corpus] [--dump-widgets] [--verify-widgets file] [--verify-midi] [--verify-state]" << std::endl;
+        return 1;
+    }
+    const File corpus(File::getCurrentWorkingDirectory().getChildFile(index>=0 ? args[index+1] : "Examples"));
+    if(args.contains("--dump-widgets"))
+    {
+        std::cout << dumpWidgets(corpus).joinIntoString("\n") << std::endl;
+        return 0;
+    }
+    if(verifyIndex>=0)
+        return verifyWidgets(corpus, File::getCurrentWorkingDirectory().getChildFile(args[verifyIndex+1])) ? 0 : 1;
+
+    //the processor needs the message manager, even without an editor
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    if(args.contains("--verify-midi"))
+        return verifyMidiJitter() ? 0 : 1;
+    if(args.contains("--verify-state"))
+        return verifyStateRestore() ? 0 : 1;
+
+    StringArray sections;
+    sections.add(benchmarkAudioExchange());
+    sections.add(benchmarkOversampling());
+    sections.add(benchmarkWidgetReads());
+    sections.add(benchmarkRefreshScan());
+    sections.add(benchmarkSVGDraws());
+
+    if(!args.contains("--no-corpus"))
+    {
+        if(corpus.isDirectory())
+        {
+            sections.add(benchmarkGUIParse(corpus));
+            sections.add(benchmarkCorpus(corpus));
+        }
+        else
+            std::cerr << "no corpus found at " << corpus.getFullPathName() << std::endl;
+    }
+
+    std::cout << "{\n" << sections.joinIntoString(",\n") << "\n}" << std::endl;
+    return 0;
+}
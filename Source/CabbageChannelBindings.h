@@ -0,0 +1,280 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+#ifndef CABBAGECHANNELBINDINGS_H
+#define CABBAGECHANNELBINDINGS_H
+
+#include "CabbageUtils.h"
+
+#ifndef Cabbage_No_Csound
+#include "csound.hpp"
+#include "csdl.h"
+
+//==============================================================================
+// Table of pointers into Csound's channel memory. Every widget channel,
+// identchannel and host channel is resolved once through csoundGetChannelPtr()
+// after a successful compile, so the k-cycle loop can read and write them
+// without the name lookup and UTF8 conversion that GetChannel()/SetChannel()
+// do on each call. Pointers belong to the Csound instance they were resolved
+// against and must be rebound after every Compile()/Reset().
+//==============================================================================
+class CabbageChannelBindings
+{
+public:
+    enum HostChannel
+    {
+        hostBpm = 0,
+        timeInSeconds,
+        isPlaying,
+        isRecording,
+        hostPPQPos,
+        timeInSamples,
+        timeSigDenom,
+        timeSigNum,
+        cpuLoad,
+        presetMorph,            //read rather than written, see CabbagePresetBank
+        numHostChannels
+    };
+
+    CabbageChannelBindings()
+    {
+        clear();
+    }
+
+    ~CabbageChannelBindings() {}
+
+    //only call this while the audio thread is locked out
+    void clear()
+    {
+        controlChannels.clearQuick();
+        controlSlots.clearQuick();
+        identChannels.clearQuick();
+        identChannelNames.clearQuick();
+        layoutIdentChannels.clearQuick();
+        layoutIdentChannelNames.clearQuick();
+        tableChannels.clear();
+        slotControlChannels.clearQuick();
+        slotControlIndexes.clearQuick();
+        for(int i=0; i<numHostChannels; i++)
+            hostChannels[i] = nullptr;
+    }
+
+    //exchanges every pointer with other, which was resolved against the
+    //instance that is about to take over. Doesn't allocate
+    void swapWith(CabbageChannelBindings& other) noexcept
+    {
+        controlChannels.swapWith(other.controlChannels);
+        controlSlots.swapWith(other.controlSlots);
+        identChannels.swapWith(other.identChannels);
+        identChannelNames.swapWith(other.identChannelNames);
+        layoutIdentChannels.swapWith(other.layoutIdentChannels);
+        layoutIdentChannelNames.swapWith(other.layoutIdentChannelNames);
+        tableChannels.swapWith(other.tableChannels);
+        slotControlChannels.swapWith(other.slotControlChannels);
+        slotControlIndexes.swapWith(other.slotControlIndexes);
+        for(int i=0; i<numHostChannels; i++)
+            std::swap(hostChannels[i], other.hostChannels[i]);
+    }
+
+    static MYFLT* resolveControlChannel(Csound* csound, const String& name)
+    {
+        MYFLT* ptr = nullptr;
+        if(name.isEmpty())
+            return nullptr;
+        if(csound->GetChannelPtr(ptr, name.toUTF8().getAddress(),
+                                 CSOUND_CONTROL_CHANNEL | CSOUND_INPUT_CHANNEL | CSOUND_OUTPUT_CHANNEL)!=CSOUND_SUCCESS)
+            return nullptr;
+        return ptr;
+    }
+
+    static STRINGDAT* resolveStringChannel(Csound* csound, const String& name)
+    {
+        MYFLT* ptr = nullptr;
+        if(name.isEmpty())
+            return nullptr;
+        if(csound->GetChannelPtr(ptr, name.toUTF8().getAddress(),
+                                 CSOUND_STRING_CHANNEL | CSOUND_INPUT_CHANNEL | CSOUND_OUTPUT_CHANNEL)!=CSOUND_SUCCESS)
+            return nullptr;
+        return (STRINGDAT*)ptr;
+    }
+
+    //============ interactive widgets, indexed as guiCtrls ===============
+    //slot is the channel's message queue slot, or -1
+    void addControl(MYFLT* value, int slot, STRINGDAT* ident, const String& identName)
+    {
+        controlChannels.add(value);
+        controlSlots.add(slot);
+        identChannels.add(ident);
+        identChannelNames.add(identName);
+    }
+
+    inline MYFLT* getControlChannel(int index) const
+    {
+        return controlChannels[index];
+    }
+
+    inline int getControlSlot(int index) const
+    {
+        return isPositiveAndBelow(index, controlSlots.size()) ? controlSlots.getUnchecked(index) : -1;
+    }
+
+    inline STRINGDAT* getIdentChannel(int index) const
+    {
+        return identChannels[index];
+    }
+
+    inline const String& getIdentChannelName(int index) const
+    {
+        return identChannelNames[index];
+    }
+
+    inline int getNumControls() const
+    {
+        return controlChannels.size();
+    }
+
+    //============ layout widgets, indexed as guiLayoutCtrls ==============
+    void addLayoutControl(STRINGDAT* ident, const String& identName, const Array<MYFLT*>& tableChans)
+    {
+        layoutIdentChannels.add(ident);
+        layoutIdentChannelNames.add(identName);
+        tableChannels.add(new Array<MYFLT*>(tableChans));
+    }
+
+    inline STRINGDAT* getLayoutIdentChannel(int index) const
+    {
+        return layoutIdentChannels[index];
+    }
+
+    inline const String& getLayoutIdentChannelName(int index) const
+    {
+        return layoutIdentChannelNames[index];
+    }
+
+    inline MYFLT* getTableChannel(int index, int channel) const
+    {
+        if(const Array<MYFLT*>* chans = tableChannels[index])
+            return (*chans)[channel];
+        return nullptr;
+    }
+
+    inline int getNumLayoutControls() const
+    {
+        return layoutIdentChannels.size();
+    }
+
+    //============ channels addressed from the message queue ==============
+    //slot is the id CabbageMessageQueue::getChannelSlot() gave the channel,
+    //control the index of the smoothed widget writing to it, or -1
+    void addSlotControl(int slot, MYFLT* value, int control=-1)
+    {
+        if(slot<0 || value==nullptr)
+            return;
+        while(slotControlChannels.size()<=slot)
+        {
+            slotControlChannels.add(nullptr);
+            slotControlIndexes.add(-1);
+        }
+        slotControlChannels.set(slot, value);
+        if(control>=0)
+            slotControlIndexes.set(slot, control);
+    }
+
+    inline MYFLT* getSlotControlChannel(int slot) const
+    {
+        return slotControlChannels[slot];
+    }
+
+    inline int getSlotControlIndex(int slot) const
+    {
+        return isPositiveAndBelow(slot, slotControlIndexes.size()) ? slotControlIndexes.getUnchecked(slot) : -1;
+    }
+
+    //============ host transport channels ================================
+    void setHostChannelPtr(HostChannel chan, MYFLT* value)
+    {
+        hostChannels[chan] = value;
+    }
+
+    inline void setHostChannel(HostChannel chan, MYFLT value)
+    {
+        if(hostChannels[chan])
+            *hostChannels[chan] = value;
+    }
+
+    inline MYFLT getHostChannel(HostChannel chan) const
+    {
+        return hostChannels[chan] ? *hostChannels[chan] : 0;
+    }
+
+    //Csound locks a string channel while chnset or the API writes to it, and may
+    //reallocate its data, so hold the same lock while reading or clearing one.
+    //The name is the one the channel was resolved with
+    class ScopedChannelLock
+    {
+    public:
+        ScopedChannelLock(Csound* csound, const String& channelName)
+            : cs(csound->GetCsound()), name(channelName.toRawUTF8())
+        {
+            csoundLockChannel(cs, name);
+        }
+
+        ~ScopedChannelLock()
+        {
+            csoundUnlockChannel(cs, name);
+        }
+
+    private:
+        CSOUND* cs;
+        const char* name;
+        JUCE_DECLARE_NON_COPYABLE(ScopedChannelLock)
+    };
+
+    //returns the identchannel's pending string, or nullptr if nothing was sent.
+    //Only call this, and clearIdentChannel(), while holding a ScopedChannelLock
+    static inline const char* getIdentChannelMessage(STRINGDAT* ident)
+    {
+        if(ident==nullptr || ident->data==nullptr || ident->data[0]==0)
+            return nullptr;
+        return ident->data;
+    }
+
+    //zero the channel so we don't keep picking up the same string
+    static inline void clearIdentChannel(STRINGDAT* ident)
+    {
+        if(ident!=nullptr && ident->data!=nullptr)
+            ident->data[0] = 0;
+    }
+
+private:
+    Array<MYFLT*> controlChannels;
+    Array<int> controlSlots;
+    Array<STRINGDAT*> identChannels;
+    StringArray identChannelNames;
+    Array<STRINGDAT*> layoutIdentChannels;
+    StringArray layoutIdentChannelNames;
+    OwnedArray<Array<MYFLT*> > tableChannels;
+    Array<MYFLT*> slotControlChannels;
+    Array<int> slotControlIndexes;
+    MYFLT* hostChannels[numHostChannels];
+};
+
+#endif
+#endif
@@ -0,0 +1,231 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGECHANNELSMOOTHER_H
+#define CABBAGECHANNELSMOOTHER_H
+
+#include "CabbageChannelBindings.h"
+
+#ifndef Cabbage_No_Csound
+
+//==============================================================================
+// De-zippers the channels of widgets that use smooth(ms). Instead of being
+// written straight into Csound, a new value from the GUI, the host or
+// automation becomes a target that the channel moves towards a little on
+// every k-cycle. By default this is a one-pole lowpass with a time constant
+// of ms; smooth(ms, "linear") ramps there in a straight line over ms instead.
+//
+// Slot state is kept in parallel arrays with the one-pole slots first, so
+// each k-cycle is one tight loop over the one-pole slots, one over the linear
+// ones, and one to write the channels that are still moving. Nothing runs
+// once every channel has settled.
+//==============================================================================
+class CabbageChannelSmoother
+{
+public:
+    CabbageChannelSmoother() : numSlots(0), numOnePoleSlots(0), numMoving(0) {}
+    ~CabbageChannelSmoother() {}
+
+    //====================== message thread ===================================
+    //these change what the audio thread reads, so only call them while it is
+    //locked out. Call clear(), addControl() for each smoothed widget and then
+    //prepare() once the control rate is known
+    void clear(int numControls)
+    {
+        pending.clearQuick();
+        slotForControl.clearQuick();
+        slotForControl.insertMultiple(0, -1, numControls);
+        numSlots = numOnePoleSlots = numMoving = 0;
+    }
+
+    //range is the widget's max-min, which sets how close counts as arrived
+    void addControl(int control, MYFLT* channel, float timeMs, bool linear, float range)
+    {
+        if(channel==nullptr || timeMs<=0 || !isPositiveAndBelow(control, slotForControl.size()))
+            return;
+
+        PendingSlot slot = { control, channel, timeMs, linear, range };
+        pending.add(slot);
+    }
+
+    void prepare(double controlRate)
+    {
+        numSlots = pending.size();
+        channels.allocate(jmax(1, numSlots), true);
+        targets.allocate(jmax(1, numSlots), true);
+        currents.allocate(jmax(1, numSlots), true);
+        coefficients.allocate(jmax(1, numSlots), true);
+        increments.allocate(jmax(1, numSlots), true);
+        thresholds.allocate(jmax(1, numSlots), true);
+        remaining.allocate(jmax(1, numSlots), true);
+        rampLengths.allocate(jmax(1, numSlots), true);
+        moving.allocate(jmax(1, numSlots), true);
+
+        numOnePoleSlots = 0;
+        for(int i=0; i<pending.size(); i++)
+            if(!pending.getReference(i).linear)
+                numOnePoleSlots++;
+
+        int onePole = 0, linear = numOnePoleSlots;
+        for(int i=0; i<pending.size(); i++)
+        {
+            const PendingSlot& slot = pending.getReference(i);
+            const int index = slot.linear ? linear++ : onePole++;
+            const double cycles = jmax(1.0, slot.timeMs*0.001*controlRate);
+
+            channels[index] = slot.channel;
+            targets[index] = currents[index] = (float)*slot.channel;
+            coefficients[index] = (float)(1.0-std::exp(-1.0/cycles));
+            rampLengths[index] = roundToInt(cycles);
+            thresholds[index] = jmax(1.0e-6f, std::abs(slot.range)*1.0e-5f);
+            slotForControl.set(slot.control, index);
+        }
+
+        pending.clearQuick();
+        numMoving = 0;
+    }
+
+    //exchanges everything with other, which was prepared for the instance
+    //that is about to take over. Doesn't allocate
+    void swapWith(CabbageChannelSmoother& other) noexcept
+    {
+        pending.swapWith(other.pending);
+        slotForControl.swapWith(other.slotForControl);
+        std::swap(numSlots, other.numSlots);
+        std::swap(numOnePoleSlots, other.numOnePoleSlots);
+        std::swap(numMoving, other.numMoving);
+        channels.swapWith(other.channels);
+        targets.swapWith(other.targets);
+        currents.swapWith(other.currents);
+        coefficients.swapWith(other.coefficients);
+        increments.swapWith(other.increments);
+        thresholds.swapWith(other.thresholds);
+        remaining.swapWith(other.remaining);
+        rampLengths.swapWith(other.rampLengths);
+        moving.swapWith(other.moving);
+    }
+
+    bool isSmoothed(int control) const
+    {
+        return isPositiveAndBelow(control, slotForControl.size()) && slotForControl.getUnchecked(control)>=0;
+    }
+
+    //======================== audio thread ===================================
+    //returns false if the control isn't smoothed, in which case the caller
+    //should write the value itself
+    bool setTarget(int control, float value)
+    {
+        if(!isPositiveAndBelow(control, slotForControl.size()))
+            return false;
+
+        const int i = slotForControl.getUnchecked(control);
+        if(i<0)
+            return false;
+
+        //a channel at rest starts from whatever is in it, which might
+        //have been written by a preset or by Csound itself
+        if(moving[i]==0)
+        {
+            currents[i] = (float)*channels[i];
+            moving[i] = 1;
+            numMoving++;
+        }
+
+        targets[i] = value;
+        if(i>=numOnePoleSlots)
+        {
+            remaining[i] = rampLengths[i];
+            increments[i] = (value-currents[i])/rampLengths[i];
+        }
+        return true;
+    }
+
+    //the value a smoothed widget is heading for, so that reading its channel
+    //back mid-ramp doesn't drag the widget along with it
+    inline bool getTarget(int control, float& value) const
+    {
+        if(!isPositiveAndBelow(control, slotForControl.size()))
+            return false;
+
+        const int slot = slotForControl.getUnchecked(control);
+        if(slot<0 || moving[slot]==0)
+            return false;
+        value = targets[slot];
+        return true;
+    }
+
+    //call once per k-cycle, before performKsmps()
+    void process()
+    {
+        if(numMoving==0)
+            return;
+
+        for(int i=0; i<numOnePoleSlots; i++)
+            currents[i] += coefficients[i]*(targets[i]-currents[i]);
+
+        for(int i=numOnePoleSlots; i<numSlots; i++)
+        {
+            if(remaining[i]>0)
+            {
+                currents[i] += increments[i];
+                remaining[i]--;
+            }
+        }
+
+        for(int i=0; i<numSlots; i++)
+        {
+            if(moving[i]==0)
+                continue;
+
+            if(std::abs(targets[i]-currents[i])<=thresholds[i]
+                    || (i>=numOnePoleSlots && remaining[i]==0))
+            {
+                currents[i] = targets[i];
+                moving[i] = 0;
+                numMoving--;
+            }
+            *channels[i] = currents[i];
+        }
+    }
+
+private:
+    struct PendingSlot
+    {
+        int control;
+        MYFLT* channel;
+        float timeMs;
+        bool linear;
+        float range;
+    };
+
+    Array<PendingSlot> pending;
+    Array<int> slotForControl;
+
+    int numSlots, numOnePoleSlots, numMoving;
+    HeapBlock<MYFLT*> channels;
+    HeapBlock<float> targets, currents, coefficients, increments, thresholds;
+    HeapBlock<int> remaining, rampLengths, moving;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageChannelSmoother);
+};
+
+#endif
+#endif
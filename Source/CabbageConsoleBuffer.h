@@ -0,0 +1,210 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGECONSOLEBUFFER_H
+#define CABBAGECONSOLEBUFFER_H
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <cstdarg>
+#include <cstdio>
+
+//==============================================================================
+// Csound's console output, kept as the last maxLines lines. post() is called
+// from Csound's message callback on whatever thread Csound happens to be
+// running, so it formats each message into one of a fixed set of slots and
+// never blocks or allocates. If the message thread falls numSlots messages
+// behind, the rest are counted and reported as dropped. Everything else runs
+// on the message thread, which moves the messages into a ring of lines.
+// Every line gets a sequence number, so consumers keep a Reader and only
+// append what was added since they last looked.
+//==============================================================================
+class CabbageConsoleBuffer
+{
+public:
+    enum { defaultMaxLines = 2000, numSlots = 128, maxMessageLength = 1024 };
+
+    //where a consumer is up to. Zero-initialised readers start at the oldest line
+    struct Reader
+    {
+        Reader() : position(0), shownFrom(0) {}
+        int64 position;     //sequence number of the next line to hand out
+        int64 shownFrom;    //first line the consumer is showing
+    };
+
+    CabbageConsoleBuffer()
+        : messageText(numSlots*maxMessageLength),
+          enqueuePosition(0),
+          dequeuePosition(0),
+          droppedMessages(0),
+          firstLine(0),
+          nextLine(0),
+          clearedAt(0)
+    {
+        for(int i=0; i<numSlots; i++)
+            slotSequence[i].set((uint32)i);
+        setMaxLines(defaultMaxLines);
+    }
+
+    ~CabbageConsoleBuffer() {}
+
+    //any thread
+    void post(const char* format, va_list args)
+    {
+        uint32 position = enqueuePosition.get();
+        int slot;
+        for(;;)
+        {
+            slot = (int)(position & (numSlots-1));
+            const int diff = (int)(slotSequence[slot].get()-position);
+            if(diff==0)
+            {
+                if(enqueuePosition.compareAndSetBool(position+1, position))
+                    break;
+                position = enqueuePosition.get();
+            }
+            else if(diff<0)
+            {
+                //the message thread hasn't emptied this slot yet
+                ++droppedMessages;
+                return;
+            }
+            else
+                position = enqueuePosition.get();
+        }
+
+        vsnprintf(messageText+slot*maxMessageLength, maxMessageLength, format, args);
+        slotSequence[slot].set(position+1);
+    }
+
+    //========================= message thread ===============================
+    void setMaxLines(int newMaxLines)
+    {
+        newMaxLines = jmax(1, newMaxLines);
+        StringArray kept;
+        for(int64 i=jmax(firstLine, nextLine-newMaxLines); i<nextLine; i++)
+            kept.add(lines[(int)(i%lines.size())]);
+
+        lines.clearQuick();
+        lines.insertMultiple(0, String::empty, newMaxLines);
+        firstLine = nextLine-kept.size();
+        for(int64 i=firstLine; i<nextLine; i++)
+            lines.getReference((int)(i%newMaxLines)) = kept[(int)(i-firstLine)];
+    }
+
+    int getMaxLines() const
+    {
+        return lines.size();
+    }
+
+    //forget the lines held so far, readers will be told to start again
+    void clear()
+    {
+        update();
+        firstLine = clearedAt = nextLine;
+    }
+
+    //all lines currently held
+    String getText()
+    {
+        update();
+        return getLines(firstLine);
+    }
+
+    //Fills text with whatever reader hasn't seen yet. Returns true if it should be
+    //appended to what the reader is showing, or false if it should replace it, which
+    //happens after clear(), when lines the reader missed have been discarded, or when
+    //the reader would otherwise end up showing more than twice maxLines
+    bool read(Reader& reader, String& text)
+    {
+        update();
+        const bool append = reader.position>=firstLine && reader.shownFrom>=clearedAt
+                            && nextLine-reader.shownFrom<=2*(int64)lines.size();
+        if(!append)
+            reader.position = reader.shownFrom = firstLine;
+
+        text = getLines(reader.position);
+        reader.position = nextLine;
+        return append;
+    }
+
+private:
+    //moves posted messages into the line ring
+    void update()
+    {
+        for(;;)
+        {
+            const int slot = (int)(dequeuePosition & (numSlots-1));
+            if(slotSequence[slot].get()!=dequeuePosition+1)
+                break;
+
+            pendingLine += String::fromUTF8(messageText+slot*maxMessageLength);
+            slotSequence[slot].set(dequeuePosition+numSlots);
+            ++dequeuePosition;
+        }
+
+        int newLine;
+        while((newLine = pendingLine.indexOfChar('\n'))>=0)
+        {
+            addLine(pendingLine.substring(0, newLine));
+            pendingLine = pendingLine.substring(newLine+1);
+        }
+
+        if(pendingLine.length()>maxMessageLength)
+        {
+            addLine(pendingLine);
+            pendingLine = String::empty;
+        }
+
+        const int dropped = droppedMessages.exchange(0);
+        if(dropped>0)
+            addLine("["+String(dropped)+" Csound messages were dropped]");
+    }
+
+    void addLine(const String& line)
+    {
+        lines.getReference((int)(nextLine%lines.size())) = line;
+        ++nextLine;
+        firstLine = jmax(firstLine, nextLine-lines.size());
+    }
+
+    String getLines(int64 from) const
+    {
+        String text;
+        for(int64 i=jmax(from, firstLine); i<nextLine; i++)
+            text << lines[(int)(i%lines.size())] << "\n";
+        return text;
+    }
+
+    HeapBlock<char> messageText;
+    Atomic<uint32> slotSequence[numSlots];
+    Atomic<uint32> enqueuePosition;
+    uint32 dequeuePosition;
+    Atomic<int> droppedMessages;
+
+    Array<String> lines;
+    String pendingLine;
+    int64 firstLine, nextLine;
+    int64 clearedAt;                //readers showing lines from before this start again
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageConsoleBuffer);
+};
+
+#endif
@@ -1270,7 +1270,10 @@ public:
         setName(name);
 
         if(file.containsIgnoreCase(".svg"))
-            img = cUtils::drawFromSVG(File(file).loadFileAsString(), cUtils::getSVGWidth(File(file).loadFileAsString()), cUtils::getSVGHeight(File(file).loadFileAsString()), AffineTransform::identity);
+        {
+            const String svgText = cUtils::loadSVGFile(File(file));
+            img = cUtils::drawFromSVG(svgText, cUtils::getSVGWidth(svgText), cUtils::getSVGHeight(svgText), AffineTransform::identity);
+        }
         else
             img = ImageCache::getFromFile (File (file));
         this->setWantsKeyboardFocus(false);
@@ -1116,18 +1116,316 @@ CabbageGUIType::CabbageGUIType(String compStr, int ID):
 
 //parse the text now that all default values ahve been assigned
     parse(compStr, "");
+    descriptor.declaredValue = descriptor.value;
+}
+
+CabbageGUIType::CabbageGUIType():
+    width(0),
+    height(0),
+    left(0),
+    top(0),
+    warningMessages("")
+{
+    updateDescriptor();
+    descriptor.declaredValue = descriptor.value;
 }
 
 CabbageGUIType::~CabbageGUIType()
 {
 
 }
+
 //===========================================================================================
-// this method parsing the Cabbage text and set each of the Cabbage indentifers
+// parses the text and brings the typed descriptor up to date with the result
 //===========================================================================================
 void CabbageGUIType::parse(String inStr, String identifier)
 {
-    //Logger::writeToLog(str);
+    parseIdentifiers(inStr, identifier);
+    updateDescriptor();
+}
+
+CabbageGUIType::WidgetKind CabbageGUIType::getKindFromType(const String& type)
+{
+    if(type.contains("slider"))
+        return sliderWidget;
+    if(type==CabbageIDs::hrange || type==CabbageIDs::vrange)
+        return rangeWidget;
+    if(type==CabbageIDs::combobox)
+        return comboboxWidget;
+    if(type==CabbageIDs::checkbox)
+        return checkboxWidget;
+    if(type==CabbageIDs::button)
+        return buttonWidget;
+    if(type==CabbageIDs::encoder)
+        return encoderWidget;
+    if(type==CabbageIDs::numberbox)
+        return numberboxWidget;
+    if(type==CabbageIDs::xypad)
+        return xypadWidget;
+    if(type==CabbageIDs::form)
+        return formWidget;
+    if(type==CabbageIDs::table)
+        return tableWidget;
+    if(type==CabbageIDs::gentable)
+        return gentableWidget;
+    if(type=="soundfiler")
+        return soundfilerWidget;
+    if(type==CabbageIDs::texteditor)
+        return texteditorWidget;
+    if(type=="textbox")
+        return textboxWidget;
+    if(type==CabbageIDs::filebutton)
+        return filebuttonWidget;
+    if(type==CabbageIDs::csoundoutput)
+        return csoundoutputWidget;
+    if(type==CabbageIDs::fftdisplay)
+        return fftdisplayWidget;
+    if(type==CabbageIDs::keyboard)
+        return keyboardWidget;
+    if(type==CabbageIDs::label)
+        return labelWidget;
+    if(type==CabbageIDs::image)
+        return imageWidget;
+    if(type==CabbageIDs::groupbox)
+        return groupboxWidget;
+    if(type=="stepper")
+        return stepperWidget;
+    return otherWidget;
+}
+
+//the descriptor field that mirrors a numeric property, if there is one
+float* CabbageGUIType::getDescriptorField(const Identifier& prop)
+{
+    if(prop==CabbageIDs::value)
+        return &descriptor.value;
+    if(prop==CabbageIDs::min)
+        return &descriptor.min;
+    if(prop==CabbageIDs::range)
+        return &descriptor.range;
+    if(prop==CabbageIDs::max)
+        return &descriptor.max;
+    if(prop==CabbageIDs::comborange)
+        return &descriptor.comboRange;
+    if(prop==CabbageIDs::sliderskew)
+        return &descriptor.skew;
+    if(prop==CabbageIDs::left)
+        return &descriptor.left;
+    if(prop==CabbageIDs::top)
+        return &descriptor.top;
+    if(prop==CabbageIDs::width)
+        return &descriptor.width;
+    if(prop==CabbageIDs::height)
+        return &descriptor.height;
+    return nullptr;
+}
+
+void CabbageGUIType::updateDescriptor(const Identifier& prop)
+{
+    if(prop==CabbageIDs::type)
+        descriptor.kind = getKindFromType(getStringProp(CabbageIDs::type));
+    else if(prop==CabbageIDs::channel)
+    {
+        var strings = cabbageIdentifiers.getWithDefault(CabbageIDs::channel, "");
+        descriptor.channel = strings.size()>0 ? strings[0].toString() : strings.toString();
+    }
+    else if(prop==CabbageIDs::channeltype)
+        descriptor.stringChannel = getStringProp(CabbageIDs::channeltype).equalsIgnoreCase(CabbageIDs::stringchannel);
+    else if(float* field = getDescriptorField(prop))
+        *field = getNumPropFromIdentifiers(prop);
+}
+
+//true if both would build the same component. The line number and anything
+//that changes while the instrument runs are left out. So is the value, which
+//a component can take on after it's built, see getDeclaredValue()
+//names end in a count of the widgets before them, so a widget that has only
+//moved can be matched with ignoreName set
+bool CabbageGUIType::isEquivalentTo(const CabbageGUIType& other, bool ignoreName) const
+{
+    for(int pass=0; pass<2; pass++)
+    {
+        const NamedValueSet& props = (pass==0 ? cabbageIdentifiers : other.cabbageIdentifiers);
+        const NamedValueSet& otherProps = (pass==0 ? other.cabbageIdentifiers : cabbageIdentifiers);
+        for(int i=0; i<props.size(); i++)
+        {
+            const Identifier name = props.getName(i);
+            if(name==CabbageIDs::lineNumber || name==CabbageIDs::value || name==CabbageIDs::identchannelmessage
+                    || (ignoreName && name==CabbageIDs::name))
+                continue;
+            const var* otherValue = otherProps.getVarPointer(name);
+            if(otherValue==nullptr || (pass==0 && *otherValue!=props.getValueAt(i)))
+                return false;
+        }
+    }
+    return true;
+}
+
+//exchanges everything without copying, so a widget parsed elsewhere can be
+//put in place while the audio thread is briefly locked out
+void CabbageGUIType::swapWith(CabbageGUIType& other) noexcept
+{
+    std::swap(width, other.width);
+    std::swap(height, other.height);
+    std::swap(top, other.top);
+    std::swap(left, other.left);
+    vuConfig.swapWith(other.vuConfig);
+    tableNumbers.swapWith(other.tableNumbers);
+    tableChannelValues.swapWith(other.tableChannelValues);
+    warningMessages.swapWith(other.warningMessages);
+    std::swap(descriptor, other.descriptor);
+    std::swap(cabbageIdentifiers, other.cabbageIdentifiers);
+}
+
+//the audio thread only ever writes a widget's value and its table channel values,
+//and does so in place. This takes those over from another copy of the widget
+//without allocating, so it can be done while the audio thread is locked out
+void CabbageGUIType::copyAudioThreadValuesFrom(const CabbageGUIType& other, bool includingValue) noexcept
+{
+    if(includingValue)
+    {
+        if(var* value = cabbageIdentifiers.getVarPointer(CabbageIDs::value))
+            if(value->isDouble() || value->isInt())
+                *value = (double)other.descriptor.value;
+        descriptor.value = other.descriptor.value;
+    }
+
+    const int numValues = jmin(tableChannelValues.size(), other.tableChannelValues.size());
+    for(int i=0; i<numValues; i++)
+        tableChannelValues.getReference(i) = other.tableChannelValues.getUnchecked(i);
+}
+
+void CabbageGUIType::updateDescriptor()
+{
+    updateDescriptor(CabbageIDs::type);
+    updateDescriptor(CabbageIDs::channel);
+    updateDescriptor(CabbageIDs::channeltype);
+    updateDescriptor(CabbageIDs::value);
+    updateDescriptor(CabbageIDs::min);
+    updateDescriptor(CabbageIDs::range);
+    updateDescriptor(CabbageIDs::max);
+    updateDescriptor(CabbageIDs::comborange);
+    updateDescriptor(CabbageIDs::sliderskew);
+    updateDescriptor(CabbageIDs::left);
+    updateDescriptor(CabbageIDs::top);
+    updateDescriptor(CabbageIDs::width);
+    updateDescriptor(CabbageIDs::height);
+}
+//===========================================================================================
+// A widget line is read once, left to right. Each ' ident(' or ',ident(' is
+// picked out along with everything up to the next ')', and the identifiers we
+// know are looked up in a table sorted by name. They are then applied in
+// IdentArray order, as they were when each identifier had its own search of
+// the line, so the identifier that wins when two set the same property is the
+// same as it always was.
+//===========================================================================================
+struct CabbageIdentifierToken
+{
+    String name, args;
+    int rank, position;
+    bool repeatable;
+};
+
+struct CabbageIdentifierTokenSorter
+{
+    static int compareElements(const CabbageIdentifierToken& first, const CabbageIdentifierToken& second)
+    {
+        if(first.rank!=second.rank)
+            return first.rank<second.rank ? -1 : 1;
+        return first.position<second.position ? -1 : (first.position>second.position ? 1 : 0);
+    }
+};
+
+class CabbageIdentifierTable
+{
+public:
+    CabbageIdentifierTable()
+    {
+        IdentArray identifiers;
+        names.addArray(identifiers);
+        names.sort(false);
+        for(int i=0; i<names.size(); i++)
+            ranks.add(identifiers.indexOf(names[i]));
+    }
+
+    //position of the identifier in IdentArray, or -1 if it isn't one of ours
+    int getRank(const String& name) const
+    {
+        int start = 0, end = names.size();
+        while(start<end)
+        {
+            const int mid = (start+end)/2;
+            const int comparison = name.compare(names[mid]);
+            if(comparison==0)
+                return ranks[mid];
+            if(comparison<0)
+                end = mid;
+            else
+                start = mid+1;
+        }
+        return -1;
+    }
+
+    static const CabbageIdentifierTable& getInstance()
+    {
+        static const CabbageIdentifierTable table;
+        return table;
+    }
+
+private:
+    StringArray names;
+    Array<int> ranks;
+};
+
+static inline bool isIdentifierChar(char c)
+{
+    return CharacterFunctions::isLetterOrDigit(c) || c==':';
+}
+
+//fills tokens with the identifiers found in line, in the order they should be applied.
+//If identArray isn't empty only the identifiers it lists are returned
+static void tokeniseIdentifiers(const String& line, const StringArray& identArray, Array<CabbageIdentifierToken>& tokens)
+{
+    const CabbageIdentifierTable& table = CabbageIdentifierTable::getInstance();
+    const char* const text = line.toRawUTF8();
+    const int length = (int)strlen(text);
+    HeapBlock<char> name(length+1);
+
+    for(int i=0; i<length; i++)
+    {
+        if(text[i]!=' ' && text[i]!=',')
+            continue;
+
+        int nameEnd = i+1;
+        while(nameEnd<length && isIdentifierChar(text[nameEnd]))
+        {
+            name[nameEnd-i-1] = (char)CharacterFunctions::toLowerCase((juce_wchar)text[nameEnd]);
+            nameEnd++;
+        }
+        if(nameEnd==i+1 || nameEnd>=length || text[nameEnd]!='(')
+            continue;
+
+        CabbageIdentifierToken token;
+        token.name = String(CharPointer_UTF8(name), nameEnd-i-1);
+        token.rank = identArray.size()>0 ? identArray.indexOf(token.name) : table.getRank(token.name);
+        if(token.rank<0)
+            continue;
+
+        const char* const argsEnd = strchr(text+nameEnd, ')');
+        if(argsEnd!=nullptr)
+            token.args = String::fromUTF8(text+nameEnd+1, int(argsEnd-text)-nameEnd-1);
+        token.position = i;
+        token.repeatable = (token.name=="channelarray" || token.name=="svgfile" || token.name=="amprange");
+        tokens.add(token);
+    }
+
+    CabbageIdentifierTokenSorter sorter;
+    tokens.sort(sorter, true);
+}
+
+//===========================================================================================
+// this method parsing the Cabbage text and set each of the Cabbage indentifers
+//===========================================================================================
+void CabbageGUIType::parseIdentifiers(String inStr, String identifier)
+{
     //remove any text after a semicolon and take out tabs..
     String str = inStr.replace("\t", " ");
     if(str.indexOf(0, ";")!=-1)
@@ -1136,8 +1434,8 @@ void CabbageGUIType::parse(String inStr, String identifier)
     StringArray identArray;
 
     String parameters;
-    //if identifier string is not empty, use that, otherwise
-    //search through identArray list of known identifiers
+    //if identifier string is not empty only those identifiers are set, in the
+    //order given, otherwise every identifier we know about is, in IdentArray order
     if(identifier.isNotEmpty())
     {
         while(identifier.indexOf("(")>0)
@@ -1147,916 +1445,914 @@ void CabbageGUIType::parse(String inStr, String identifier)
         }
         identArray.addTokens(identifier, " ");
     }
-    else
-    {
-        IdentArray idententifiers;
-        identArray = idententifiers;
-    }
 
-    String typeOfWidget="";
-    StringArray strTokens, tempTokens;
-    tempTokens.addTokens(str, ", \t", "\"");
-    typeOfWidget = tempTokens[0];
-    //Logger::writeToLog(typeOfWidget);
+    Array<CabbageIdentifierToken> tokens;
+    tokeniseIdentifiers(str, identArray, tokens);
 
-    for(int indx=0; indx<identArray.size(); indx++)
+    const String typeOfWidget = str.initialSectionNotContaining(", ");
+    StringArray strTokens;
+
+    for(int indx=0; indx<tokens.size(); indx++)
     {
-        //cUtils::debug(identArray[indx]);
-        //check to see if identifier is part of input string..turn to lowercase first..
-        //Logger::writeToLog("index:"+String(indx)+" arrayItem:"+identArray.getReference(indx)+" line:\n"+str);
-        //int identPos = str.toLowerCase().replaceCharacters("()", "  ").indexOfWholeWordIgnoreCase(identArray[indx]);
-        //if(str.substring(identPos).toLowerCase().contains(identArray[indx]+"("))
-        int identPos = str.toLowerCase().indexOf(" "+identArray[indx]+"(");
-        if(identPos<0)
-            identPos = str.toLowerCase().indexOf(","+identArray[indx]+"(");
-        if(identPos>-1)
-        {
-            String newString = str.substring(identPos+identArray[indx].length());
-            //showMessage(newString, nullptr);
-            String tstr = newString.substring(newString.indexOf("(")+1, newString.indexOf(0, ")"));
-            //showMessage(tstr, nullptr);
-
-            if(tstr.length()==0)
-                return;
-
-            //find current identifier and remove it from main string so that we can
-            //check for multiple instances of an identifier such as amprange
-            String deleteStr = str.substring(identPos+1);
-            deleteStr = deleteStr.substring(0, deleteStr.indexOf(")")+1);
-            str = str.replace(deleteStr, "");
-
-            strTokens.addTokens(tstr.removeCharacters("\t)\""), ",", "\"");
-
-
-            //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-            //string paramters
-            //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-            if(identArray[indx].equalsIgnoreCase("name"))
+        const String& ident = tokens.getReference(indx).name;
+        const String& tstr = tokens.getReference(indx).args;
+
+        //only the first instance of most identifiers counts
+        if(indx>0 && ident==tokens.getReference(indx-1).name && !tokens.getReference(indx).repeatable)
+            continue;
+
+        if(tstr.length()==0)
+            return;
+
+        strTokens.addTokens(tstr.removeCharacters("\t)\""), ",", "\"");
+
+
+        //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        //string paramters
+        //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        if(ident.equalsIgnoreCase("name"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::name, strTokens[0].trim());
+        }
+        else if(ident.equalsIgnoreCase("plant"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::plant, strTokens[0].trim());
+        }
+        else if(ident.equalsIgnoreCase("caption"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::caption, strTokens[0].trim());
+        }
+
+        else if(ident.equalsIgnoreCase("channel")||
+                ident.equalsIgnoreCase("channels")||
+                ident.equalsIgnoreCase("channelarray")||
+                ident.equalsIgnoreCase("widgetarray"))
+        {
+            var array;
+            array.append(strTokens[0].trim());
+            cUtils::debug(strTokens[0].trim());
+            if(typeOfWidget.containsIgnoreCase("xypad"))
             {
-                cabbageIdentifiers.set(CabbageIDs::name, strTokens[0].trim());
+                cabbageIdentifiers.set(CabbageIDs::xchannel, strTokens[0].trim());
+                cabbageIdentifiers.set(CabbageIDs::ychannel, strTokens[1].trim());
             }
-            else if(identArray[indx].equalsIgnoreCase("plant"))
+            else if(typeOfWidget.containsIgnoreCase("vumeter"))
             {
-                cabbageIdentifiers.set(CabbageIDs::plant, strTokens[0].trim());
+                array.resize(0);
+                for(int u=0; u<strTokens.size(); u++)
+                {
+                    array.append(strTokens[u].trim());
+                }
             }
-            else if(identArray[indx].equalsIgnoreCase("caption"))
+            else
             {
-                cabbageIdentifiers.set(CabbageIDs::caption, strTokens[0].trim());
+                if(strTokens.size()>1)
+                    for(int i=1; i<strTokens.size(); i++)
+                    {
+                        array.append(strTokens[i].trim());
+                    }
             }
 
-            else if(identArray[indx].equalsIgnoreCase("channel")||
-                    identArray[indx].equalsIgnoreCase("channels")||
-                    identArray[indx].equalsIgnoreCase("channelarray")||
-                    identArray[indx].equalsIgnoreCase("widgetarray"))
+            if(ident.equalsIgnoreCase("channelarray"))
             {
-                var array;
-                array.append(strTokens[0].trim());
-                cUtils::debug(strTokens[0].trim());
-                if(str.containsIgnoreCase("xypad"))
-                {
-                    cabbageIdentifiers.set(CabbageIDs::xchannel, strTokens[0].trim());
-                    cabbageIdentifiers.set(CabbageIDs::ychannel, strTokens[1].trim());
-                }
-                else if(str.containsIgnoreCase("vumeter"))
-                {
-                    array.resize(0);
-                    for(int u=0; u<strTokens.size(); u++)
-                    {
-                        array.append(strTokens[u].trim());
-                    }
-                }
-                else
-                {
-                    if(strTokens.size()>1)
-                        for(int i=1; i<strTokens.size(); i++)
-                        {
-                            array.append(strTokens[i].trim());
-                        }
-                }
+                //if there are already channels declared we want to keep them
+                array.resize(0);
+                for(int i=0; i<getStringArrayProp(CabbageIDs::channel).size(); i++)
+                    array.append(getStringArrayPropValue(CabbageIDs::channel, i));
 
-                if(identArray[indx].equalsIgnoreCase("channelarray"))
+                var channelArray, identChannelArray;
+                int size = strTokens[1].getIntValue();
+                for(int i=0; i<size; i++)
                 {
-                    //if there are already channels declared we want to keep them
-                    array.resize(0);
-                    for(int i=0; i<getStringArrayProp(CabbageIDs::channel).size(); i++)
-                        array.append(getStringArrayPropValue(CabbageIDs::channel, i));
-
-                    var channelArray, identChannelArray;
-                    int size = strTokens[1].getIntValue();
-                    for(int i=0; i<size; i++)
-                    {
-                        array.append(strTokens[0]+String(i+1));
-                    }
-                    cabbageIdentifiers.set(CabbageIDs::channel, array);
-                    //identifiers that appear more than once need to use indx-- so we can check for another instance
-                    indx--;
+                    array.append(strTokens[0]+String(i+1));
                 }
-
                 cabbageIdentifiers.set(CabbageIDs::channel, array);
-                if(identArray[indx].equalsIgnoreCase("widgetarray"))
-                {
-                    var channelArray, identChannelArray;
-                    int size = strTokens[1].getIntValue();
-                    for(int i=0; i<size; i++)
-                    {
-                        channelArray.append(String(strTokens[0])+String(i+1));
-                        identChannelArray.append(String(strTokens[0])+String("_ident")+String(i+1));
-
-                    }
-                    cabbageIdentifiers.set(CabbageIDs::channelarray, channelArray);
-                    cabbageIdentifiers.set(CabbageIDs::identchannelarray, identChannelArray);
-                }
-            }
-
-            else if(identArray[indx].equalsIgnoreCase("colour:0")||
-                    identArray[indx].equalsIgnoreCase("colours("))
-            {
-                cabbageIdentifiers.set(CabbageIDs::colour, getColourFromText(strTokens.joinIntoString(",")).toString());
             }
 
-            else if(identArray[indx].equalsIgnoreCase("colour:1") ||
-                    identArray[indx].equalsIgnoreCase("colour"))
+            cabbageIdentifiers.set(CabbageIDs::channel, array);
+            //channelarray() has always set up the widget arrays as well
+            if(ident.equalsIgnoreCase("widgetarray") || ident.equalsIgnoreCase("channelarray"))
             {
-                if(typeOfWidget.contains("checkbox") || typeOfWidget.contains("button"))
+                var channelArray, identChannelArray;
+                int size = strTokens[1].getIntValue();
+                for(int i=0; i<size; i++)
                 {
-                    cabbageIdentifiers.set(CabbageIDs::oncolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+                    channelArray.append(String(strTokens[0])+String(i+1));
+                    identChannelArray.append(String(strTokens[0])+String("_ident")+String(i+1));
+
                 }
-                else
-                    cabbageIdentifiers.set(CabbageIDs::colour, getColourFromText(strTokens.joinIntoString(",")).toString());
+                cabbageIdentifiers.set(CabbageIDs::channelarray, channelArray);
+                cabbageIdentifiers.set(CabbageIDs::identchannelarray, identChannelArray);
             }
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("fontcolour")||
-                    identArray[indx].equalsIgnoreCase("fontcolour:1"))
-            {
-                if(typeOfWidget.contains("button"))
-                    cabbageIdentifiers.set(CabbageIDs::onfontcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
-                else
-                    cabbageIdentifiers.set(CabbageIDs::fontcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        else if(ident.equalsIgnoreCase("colour:0")||
+                ident.equalsIgnoreCase("colours("))
+        {
+            cabbageIdentifiers.set(CabbageIDs::colour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-            }
-            else if(identArray[indx].equalsIgnoreCase("fontcolour:0"))
+        else if(ident.equalsIgnoreCase("colour:1") ||
+                ident.equalsIgnoreCase("colour"))
+        {
+            if(typeOfWidget.contains("checkbox") || typeOfWidget.contains("button"))
             {
-                cabbageIdentifiers.set(CabbageIDs::fontcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+                cabbageIdentifiers.set(CabbageIDs::oncolour, getColourFromText(strTokens.joinIntoString(",")).toString());
             }
+            else
+                cabbageIdentifiers.set(CabbageIDs::colour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("tablebackgroundcolour"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::tablebackgroundcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
-            }
+        else if(ident.equalsIgnoreCase("fontcolour")||
+                ident.equalsIgnoreCase("fontcolour:1"))
+        {
+            if(typeOfWidget.contains("button"))
+                cabbageIdentifiers.set(CabbageIDs::onfontcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+            else
+                cabbageIdentifiers.set(CabbageIDs::fontcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
 
-            else if(identArray[indx].equalsIgnoreCase("tablegridcolour"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::tablegridcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
-            }
+        }
+        else if(ident.equalsIgnoreCase("fontcolour:0"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::fontcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("tablecolour") ||
-                    identArray[indx].equalsIgnoreCase("tablecolours"))
-            {
-                var colours;
-                for(int i=0; i<strTokens.size(); i++)
-                {
-                    colours.append(strTokens[i].trim());
-                    //Logger::writeToLog(strTokens[i].trim());
-                }
-                cabbageIdentifiers.set(CabbageIDs::tablecolour, colours);
-            }
+        else if(ident.equalsIgnoreCase("tablebackgroundcolour"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::tablebackgroundcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("trackercolour"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::trackercolour, getColourFromText(strTokens.joinIntoString(",")).toString());
-            }
+        else if(ident.equalsIgnoreCase("tablegridcolour"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::tablegridcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("highlightcolour"))
+        else if(ident.equalsIgnoreCase("tablecolour") ||
+                ident.equalsIgnoreCase("tablecolours"))
+        {
+            var colours;
+            for(int i=0; i<strTokens.size(); i++)
             {
-                cabbageIdentifiers.set(CabbageIDs::highlightcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+                colours.append(strTokens[i].trim());
+                //Logger::writeToLog(strTokens[i].trim());
             }
+            cabbageIdentifiers.set(CabbageIDs::tablecolour, colours);
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("kind"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::kind, strTokens[0].trim());
-            }
+        else if(ident.equalsIgnoreCase("trackercolour"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::trackercolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("file"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::file, strTokens[0].trim());
-            }
+        else if(ident.equalsIgnoreCase("highlightcolour"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::highlightcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("svgpath"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::svgpath, strTokens[0].trim());
-            }
+        else if(ident.equalsIgnoreCase("kind"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::kind, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("svgfile"))
-            {
-                if(typeOfWidget=="groupbox")
-                    cabbageIdentifiers.set(CabbageIDs::svggroupbox, strTokens[0].trim());
-                else if(typeOfWidget.contains("slider"))
-                {
-                    if(strTokens[0].trim().contains("background"))
-                        cabbageIdentifiers.set(CabbageIDs::svgsliderbg, strTokens[1].trim());
-                    else
-                        cabbageIdentifiers.set(CabbageIDs::svgslider, strTokens[1].trim());
-                }
-                else if(typeOfWidget.contains("button"))
-                {
-                    if(strTokens[0].trim().contains("off"))
-                        cabbageIdentifiers.set(CabbageIDs::svgbuttonoff, strTokens[1].trim());
-                    else
-                        cabbageIdentifiers.set(CabbageIDs::svgbuttonon, strTokens[1].trim());
-                }
-                //identifiers that appear more than once need to use indx-- so we can check for another instance
-                indx--;
-            }
+        else if(ident.equalsIgnoreCase("file"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::file, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("fillcolour"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::fillcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
-            }
+        else if(ident.equalsIgnoreCase("svgpath"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::svgpath, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("shape"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::shape, strTokens[0].trim());
-            }
-            else if(identArray[indx].equalsIgnoreCase("outlinecolour"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::outlinecolour, getColourFromText(strTokens.joinIntoString(",")).toString());
-            }
-            else if(identArray[indx].equalsIgnoreCase("textcolour"))
+        else if(ident.equalsIgnoreCase("svgfile"))
+        {
+            if(typeOfWidget=="groupbox")
+                cabbageIdentifiers.set(CabbageIDs::svggroupbox, strTokens[0].trim());
+            else if(typeOfWidget.contains("slider"))
             {
-                cabbageIdentifiers.set(CabbageIDs::textcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+                if(strTokens[0].trim().contains("background"))
+                    cabbageIdentifiers.set(CabbageIDs::svgsliderbg, strTokens[1].trim());
+                else
+                    cabbageIdentifiers.set(CabbageIDs::svgslider, strTokens[1].trim());
             }
-
-            else if(identArray[indx].equalsIgnoreCase("pluginid"))
+            else if(typeOfWidget.contains("button"))
             {
-                cabbageIdentifiers.set(CabbageIDs::pluginid, strTokens[0].trim());
+                if(strTokens[0].trim().contains("off"))
+                    cabbageIdentifiers.set(CabbageIDs::svgbuttonoff, strTokens[1].trim());
+                else
+                    cabbageIdentifiers.set(CabbageIDs::svgbuttonon, strTokens[1].trim());
             }
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("popuptext"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::popuptext, strTokens[0]);
-            }
+        else if(ident.equalsIgnoreCase("fillcolour"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::fillcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("items")||
-                    identArray[indx].equalsIgnoreCase("text"))
-            {
-                //cUtils::showMessage(typeOfWidget+":"+text);
-                var value;
-                int comboRange = 0;
-                for(int i= 0; i<(int)strTokens.size(); i++)
-                {
-                    //Logger::writeToLog(strTokens[i]);
-                    String test = strTokens[i];
-                    value.append(strTokens[i].trim());
-                    //if((int)strTokens.size()<2) {
-                    //	items.add(strTokens[i]);
-                    //	value.append(strTokens[i].trim());
-                    //	i++;
-                    //	}
-                    comboRange = i+1;
-                }
-                //Logger::writeToLog(String(value.size())+typeOfWidget);
-                if((value.size()==1) && ((typeOfWidget=="button") || (typeOfWidget=="filebutton")))
-                {
-                    value.append(strTokens[0]);
-                    //Logger::writeToLog(strTokens[0].trim());
-                }
+        else if(ident.equalsIgnoreCase("shape"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::shape, strTokens[0].trim());
+        }
+        else if(ident.equalsIgnoreCase("outlinecolour"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::outlinecolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
+        else if(ident.equalsIgnoreCase("textcolour"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::textcolour, getColourFromText(strTokens.joinIntoString(",")).toString());
+        }
 
-                cabbageIdentifiers.set(CabbageIDs::text, value);
-                cabbageIdentifiers.set(CabbageIDs::comborange, comboRange);
-            }
+        else if(ident.equalsIgnoreCase("pluginid"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::pluginid, strTokens[0].trim());
+        }
 
+        else if(ident.equalsIgnoreCase("popuptext"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::popuptext, strTokens[0]);
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("preset"))
-            {
-                //cUtils::showMessage("preset is no longer supported, see docs");
-            }
+        else if(ident.equalsIgnoreCase("items")||
+                ident.equalsIgnoreCase("text"))
+        {
+            //cUtils::showMessage(typeOfWidget+":"+text);
+            var value;
+            int comboRange = 0;
+            for(int i= 0; i<(int)strTokens.size(); i++)
+            {
+                //Logger::writeToLog(strTokens[i]);
+                String test = strTokens[i];
+                value.append(strTokens[i].trim());
+                //if((int)strTokens.size()<2) {
+                //	items.add(strTokens[i]);
+                //	value.append(strTokens[i].trim());
+                //	i++;
+                //	}
+                comboRange = i+1;
+            }
+            //Logger::writeToLog(String(value.size())+typeOfWidget);
+            if((value.size()==1) && ((typeOfWidget=="button") || (typeOfWidget=="filebutton")))
+            {
+                value.append(strTokens[0]);
+                //Logger::writeToLog(strTokens[0].trim());
+            }
+
+            cabbageIdentifiers.set(CabbageIDs::text, value);
+            cabbageIdentifiers.set(CabbageIDs::comborange, comboRange);
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("mode") ||
-                    identArray[indx].equalsIgnoreCase(",mode"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::mode, strTokens[0].trim());
-            }
 
-            else if(identArray[indx].equalsIgnoreCase("native"))
-            {
-                cabbageIdentifiers.set("native", strTokens[0].trim());
-            }
+        else if(ident.equalsIgnoreCase("preset"))
+        {
+            //cUtils::showMessage("preset is no longer supported, see docs");
+        }
 
+        else if(ident.equalsIgnoreCase("mode") ||
+                ident.equalsIgnoreCase(",mode"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::mode, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("channeltype"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::channeltype, strTokens[0].trim());
-            }
+        else if(ident.equalsIgnoreCase("native"))
+        {
+            cabbageIdentifiers.set("native", strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("identchannel"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::identchannel, strTokens[0].trim());
-            }
 
-            else if(identArray[indx].equalsIgnoreCase("populate"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::filetype, strTokens[0].trim());
+        else if(ident.equalsIgnoreCase("channeltype"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::channeltype, strTokens[0].trim());
+        }
 
-                if(strTokens.size()>1)
-                {
-                    cabbageIdentifiers.set(CabbageIDs::workingdir, strTokens[1].trim());
-                }
-            }
+        else if(ident.equalsIgnoreCase("identchannel"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::identchannel, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("author"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::author, strTokens[0].trim());
-            }
+        else if(ident.equalsIgnoreCase("populate"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::filetype, strTokens[0].trim());
 
-            else if(identArray[indx].equalsIgnoreCase("align"))
+            if(strTokens.size()>1)
             {
-                cabbageIdentifiers.set(CabbageIDs::align, strTokens[0].trim());
+                cabbageIdentifiers.set(CabbageIDs::workingdir, strTokens[1].trim());
             }
+        }
 
+        else if(ident.equalsIgnoreCase("author"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::author, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("tabs"))
-            {
-                var value;
-                for(int i= 0; i<(int)strTokens.size(); i++)
-                {
-                    value.append(strTokens[i].trim());
-                }
-                cabbageIdentifiers.set(CabbageIDs::tabs, strTokens[0].trim());
-            }
+        else if(ident.equalsIgnoreCase("align"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::align, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("tabpage"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::tabpage, strTokens[0].trim());
-            }
 
-            else if(identArray[indx].equalsIgnoreCase("displaytype"))
+        else if(ident.equalsIgnoreCase("tabs"))
+        {
+            var value;
+            for(int i= 0; i<(int)strTokens.size(); i++)
             {
-                cabbageIdentifiers.set(CabbageIDs::displaytype, strTokens[0].trim());
+                value.append(strTokens[i].trim());
             }
+            cabbageIdentifiers.set(CabbageIDs::tabs, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("include"))
-            {
-                var array;
-                for(int i=0; i<strTokens.size(); i++)
-                {
-                    array.append(strTokens[i].trim());
-                }
+        else if(ident.equalsIgnoreCase("tabpage"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::tabpage, strTokens[0].trim());
+        }
 
-                cabbageIdentifiers.set(CabbageIDs::include, array);
-            }
+        else if(ident.equalsIgnoreCase("displaytype"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::displaytype, strTokens[0].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("drawmode"))
-            {
-                var value;
-                if(strTokens.size()>0)
-                    for(int i=0; i<strTokens.size(); i++)
-                    {
-                        value.append(strTokens[i].trim());
-                    }
-                cabbageIdentifiers.set(CabbageIDs::drawmode, value);
-            }
-            //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-            //numeric paramters
-            //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-            else if(identArray[indx].equalsIgnoreCase("address"))
+        else if(ident.equalsIgnoreCase("include"))
+        {
+            var array;
+            for(int i=0; i<strTokens.size(); i++)
             {
-                if(strTokens.size()>=2)
-                {
-                    //sizeText = identArray.getReference(indx)+tstr+")";
-                    String address = strTokens[0].trim();
-                    int port = strTokens[1].trim().getIntValue();
-                    cabbageIdentifiers.set(CabbageIDs::socketaddress, address);
-                    cabbageIdentifiers.set(CabbageIDs::socketport, port);
-                }
+                array.append(strTokens[i].trim());
             }
 
-            else if(identArray[indx].equalsIgnoreCase("size"))
-            {
-                if(strTokens.size()>=2)
-                {
-                    //sizeText = identArray.getReference(indx)+tstr+")";
-                    width = strTokens[0].trim().getFloatValue();
-                    height = strTokens[1].trim().getFloatValue();
-                    cabbageIdentifiers.set(CabbageIDs::width, strTokens[0].trim().getFloatValue());
-                    cabbageIdentifiers.set(CabbageIDs::height, strTokens[1].trim().getFloatValue());
-                }
-                else
-                    warningMessages+="size() does not have enough parameters\n";
-            }
+            cabbageIdentifiers.set(CabbageIDs::include, array);
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("bounds"))
-            {
-                //cUtils::debug(strTokens.size());
-                if(strTokens.size()<4)
-                {
-                    warningMessages+="Not enough paramters passed to bounds(): usage pos(top, left width, height\")\n";
-                }
-                else
+        else if(ident.equalsIgnoreCase("drawmode"))
+        {
+            var value;
+            if(strTokens.size()>0)
+                for(int i=0; i<strTokens.size(); i++)
                 {
-                    left = strTokens[0].trim().getFloatValue();
-                    top = strTokens[1].trim().getFloatValue();
-                    width = strTokens[2].trim().getFloatValue();
-                    if(strTokens.size()==3)
-                    {
-                        height = width;
-                        cabbageIdentifiers.set(CabbageIDs::height, width);
-                    }
-                    else
-                    {
-                        height = strTokens[3].trim().getFloatValue();
-                        cabbageIdentifiers.set(CabbageIDs::left, strTokens[0].trim().getFloatValue());
-                        cabbageIdentifiers.set(CabbageIDs::top, strTokens[1].trim().getFloatValue());
-                        cabbageIdentifiers.set(CabbageIDs::width, strTokens[2].trim().getFloatValue());
-                        cabbageIdentifiers.set(CabbageIDs::height, strTokens[3].trim().getFloatValue());
-                    }
-
+                    value.append(strTokens[i].trim());
                 }
-            }
-            //!!! This haven't been set for the generic data system
-            else if(identArray[indx].equalsIgnoreCase("config"))
+            cabbageIdentifiers.set(CabbageIDs::drawmode, value);
+        }
+        //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        //numeric paramters
+        //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        else if(ident.equalsIgnoreCase("address"))
+        {
+            if(strTokens.size()>=2)
             {
-                vuConfig.clear();
-                for(int i= 0; i<(int)strTokens.size(); i++)
-                {
-                    vuConfig.add(strTokens[i].trim().getFloatValue());
-                }
+                //sizeText = identArray.getReference(indx)+tstr+")";
+                String address = strTokens[0].trim();
+                int port = strTokens[1].trim().getIntValue();
+                cabbageIdentifiers.set(CabbageIDs::socketaddress, address);
+                cabbageIdentifiers.set(CabbageIDs::socketport, port);
             }
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("pos"))
+        else if(ident.equalsIgnoreCase("size"))
+        {
+            if(strTokens.size()>=2)
             {
-                if(strTokens.size()<2)
-                {
-                    warningMessages+="Not enough paramters passed to pos(): usage pos(top, left\")\n";
-                }
-                else
-                {
-                    left = strTokens[0].trim().getFloatValue();
-                    top = strTokens[1].trim().getFloatValue();
-                    cabbageIdentifiers.set(CabbageIDs::left, strTokens[0].trim().getFloatValue());
-                    cabbageIdentifiers.set(CabbageIDs::top, strTokens[1].trim().getFloatValue());
-                }
+                //sizeText = identArray.getReference(indx)+tstr+")";
+                width = strTokens[0].trim().getFloatValue();
+                height = strTokens[1].trim().getFloatValue();
+                cabbageIdentifiers.set(CabbageIDs::width, strTokens[0].trim().getFloatValue());
+                cabbageIdentifiers.set(CabbageIDs::height, strTokens[1].trim().getFloatValue());
             }
+            else
+                warningMessages+="size() does not have enough parameters\n";
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("range"))
-            {
-                if(strTokens.size()<3)
-                {
-                    warningMessages+="Not enough paramters passed to range(): usage range(minx, max, value, skew, incr\")\n";
-                }
-                else
-                {
-                    StringArray tempArray;
-                    double min = strTokens[0].trim().getDoubleValue();// getFloatValue();
-                    double max = strTokens[1].trim().getDoubleValue();//.getFloatValue();
-                    cabbageIdentifiers.set(CabbageIDs::min, strTokens[0].trim().getDoubleValue());
-                    cabbageIdentifiers.set(CabbageIDs::max, strTokens[1].trim().getDoubleValue());
-                    tempArray.add(strTokens[0].trim());
-                    tempArray.add(strTokens[1].trim());
-                    if(strTokens.size()>2)
-                    {
-                        if(strTokens[2].contains(":") && strTokens.size()>0)
-                        {
-                            //split string into two
-                            StringArray values;
-                            values.addTokens(strTokens[2], ":", "");
-                            if(values.size()==2)
-                            {
-                                cabbageIdentifiers.set(CabbageIDs::minvalue, values[0].trim().getFloatValue());
-                                cabbageIdentifiers.set(CabbageIDs::maxvalue, values[1].trim().getFloatValue());
-                            }
-                        }
-                        else
-                        {
-                            cabbageIdentifiers.set(CabbageIDs::value, strTokens[2].trim().getDoubleValue());
-                            tempArray.add(strTokens[2].trim());
-                        }
-                    }
-
-
-                    if(strTokens.size()>3)
-                    {
-                        cUtils::debug(strTokens[3]);
-                        cabbageIdentifiers.set(CabbageIDs::sliderskew, strTokens[3].trim().getDoubleValue());
-                        tempArray.add(strTokens[3].trim());
-                    }
-
-                    if(strTokens.size()>4)
-                    {
-                        tempArray.add(strTokens[4].trim());
-                        cUtils::debug(strTokens.joinIntoString("\n"));
-                        cabbageIdentifiers.set(CabbageIDs::sliderincr, strTokens[4].trim().getDoubleValue());
-                    }
-
-                    double sliderRange = max-min;
-                    int decimalPlaces = getNumberOfDecimalPlaces(tempArray);
-                    if(decimalPlaces<1 && max<=1)
-                        decimalPlaces = 2;
-                    else
-                        decimalPlaces = getNumberOfDecimalPlaces(tempArray);
-                    cabbageIdentifiers.set(CabbageIDs::decimalplaces, decimalPlaces);
-                    cabbageIdentifiers.set(CabbageIDs::range, sliderRange);
-
-                }
-            }
-            else if(identArray[indx].equalsIgnoreCase("rangex"))
+        else if(ident.equalsIgnoreCase("bounds"))
+        {
+            //cUtils::debug(strTokens.size());
+            if(strTokens.size()<4)
             {
-                if(strTokens.size()<3)
-                {
-                    warningMessages+="Not enough paramters passed to range(): usage range(minx, max, value\")\n";
-                }
-                else
-                {
-                    float minX = strTokens[0].removeCharacters("()").trim().getFloatValue();
-                    float maxX = strTokens[1].removeCharacters("()").trim().getFloatValue();
-
-                    cabbageIdentifiers.set(CabbageIDs::minx, strTokens[0].trim().getDoubleValue());
-                    cabbageIdentifiers.set(CabbageIDs::maxx, strTokens[1].getDoubleValue());
-                    cabbageIdentifiers.set(CabbageIDs::valuex, strTokens[2].getDoubleValue());
-                    cabbageIdentifiers.set(CabbageIDs::rangex, maxX-minX);
-
-                    cabbageIdentifiers.set(CabbageIDs::decimalplaces, strTokens[3].trim().getDoubleValue());
-                }
+                warningMessages+="Not enough paramters passed to bounds(): usage pos(top, left width, height\")\n";
             }
-            else if(identArray[indx].equalsIgnoreCase("rangey"))
+            else
             {
-                if(strTokens.size()<3)
+                left = strTokens[0].trim().getFloatValue();
+                top = strTokens[1].trim().getFloatValue();
+                width = strTokens[2].trim().getFloatValue();
+                if(strTokens.size()==3)
                 {
-                    warningMessages+="Not enough paramters passed to range(): usage range(minx, max, value\")\n";
+                    height = width;
+                    cabbageIdentifiers.set(CabbageIDs::height, width);
                 }
                 else
                 {
-                    float minY = strTokens[0].trim().getFloatValue();
-                    float maxY = strTokens[1].trim().getFloatValue();
-
-                    cabbageIdentifiers.set(CabbageIDs::miny, strTokens[0].trim().getDoubleValue());
-                    cabbageIdentifiers.set(CabbageIDs::maxy, strTokens[1].trim().getDoubleValue());
-                    cabbageIdentifiers.set(CabbageIDs::valuey, strTokens[2].trim().getDoubleValue());
-                    cabbageIdentifiers.set(CabbageIDs::rangey, maxY-minY);
-                    cabbageIdentifiers.set(CabbageIDs::decimalplaces, strTokens[3].trim().getDoubleValue());
+                    height = strTokens[3].trim().getFloatValue();
+                    cabbageIdentifiers.set(CabbageIDs::left, strTokens[0].trim().getFloatValue());
+                    cabbageIdentifiers.set(CabbageIDs::top, strTokens[1].trim().getFloatValue());
+                    cabbageIdentifiers.set(CabbageIDs::width, strTokens[2].trim().getFloatValue());
+                    cabbageIdentifiers.set(CabbageIDs::height, strTokens[3].trim().getFloatValue());
                 }
+
             }
-            else if(identArray[indx].equalsIgnoreCase("min"))
+        }
+        //!!! This haven't been set for the generic data system
+        else if(ident.equalsIgnoreCase("config"))
+        {
+            vuConfig.clear();
+            for(int i= 0; i<(int)strTokens.size(); i++)
             {
-                cabbageIdentifiers.set(CabbageIDs::minvalue, strTokens[0].trim().getFloatValue());
+                vuConfig.add(strTokens[i].trim().getFloatValue());
             }
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("svgdebug"))
+        else if(ident.equalsIgnoreCase("pos"))
+        {
+            if(strTokens.size()<2)
             {
-                cabbageIdentifiers.set(CabbageIDs::svgdebug, strTokens[0].trim().getFloatValue());
+                warningMessages+="Not enough paramters passed to pos(): usage pos(top, left\")\n";
             }
-
-            else if(identArray[indx].equalsIgnoreCase("middlec"))
+            else
             {
-                cabbageIdentifiers.set(CabbageIDs::middlec, strTokens[0].trim().getFloatValue());
+                left = strTokens[0].trim().getFloatValue();
+                top = strTokens[1].trim().getFloatValue();
+                cabbageIdentifiers.set(CabbageIDs::left, strTokens[0].trim().getFloatValue());
+                cabbageIdentifiers.set(CabbageIDs::top, strTokens[1].trim().getFloatValue());
             }
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("fill"))
+        else if(ident.equalsIgnoreCase("range"))
+        {
+            if(strTokens.size()<3)
             {
-                cabbageIdentifiers.set(CabbageIDs::fill, strTokens[0].trim().getIntValue());
+                warningMessages+="Not enough paramters passed to range(): usage range(minx, max, value, skew, incr\")\n";
             }
-
-            else if(identArray[indx].equalsIgnoreCase("rotate"))
+            else
             {
-                cabbageIdentifiers.set(CabbageIDs::rotate, strTokens[0].trim().getFloatValue());
-                if(strTokens.size()==3)
+                StringArray tempArray;
+                double min = strTokens[0].trim().getDoubleValue();// getFloatValue();
+                double max = strTokens[1].trim().getDoubleValue();//.getFloatValue();
+                cabbageIdentifiers.set(CabbageIDs::min, strTokens[0].trim().getDoubleValue());
+                cabbageIdentifiers.set(CabbageIDs::max, strTokens[1].trim().getDoubleValue());
+                tempArray.add(strTokens[0].trim());
+                tempArray.add(strTokens[1].trim());
+                if(strTokens.size()>2)
                 {
-                    cabbageIdentifiers.set(CabbageIDs::pivotx, strTokens[1].trim().getFloatValue());
-                    cabbageIdentifiers.set(CabbageIDs::pivoty, strTokens[2].trim().getFloatValue());
+                    if(strTokens[2].contains(":") && strTokens.size()>0)
+                    {
+                        //split string into two
+                        StringArray values;
+                        values.addTokens(strTokens[2], ":", "");
+                        if(values.size()==2)
+                        {
+                            cabbageIdentifiers.set(CabbageIDs::minvalue, values[0].trim().getFloatValue());
+                            cabbageIdentifiers.set(CabbageIDs::maxvalue, values[1].trim().getFloatValue());
+                        }
+                    }
+                    else
+                    {
+                        cabbageIdentifiers.set(CabbageIDs::value, strTokens[2].trim().getDoubleValue());
+                        tempArray.add(strTokens[2].trim());
+                    }
                 }
-            }
-
-            else if(identArray[indx].equalsIgnoreCase("pivoty"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::pivoty, strTokens[0].trim().getFloatValue());
-            }
 
-            else if(identArray[indx].equalsIgnoreCase("ffttablenumber"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::ffttablenumber, strTokens[0].trim().getFloatValue()-1);
-            }
-
-            else if(identArray[indx].equalsIgnoreCase("pivotx"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::pivotx, strTokens[0].trim().getFloatValue());
-            }
 
-            else if(identArray[indx].equalsIgnoreCase("midictrl"))
-            {
-                if(strTokens.size()<2)
+                if(strTokens.size()>3)
                 {
-                    warningMessages+="Not enough paramters passed to midiCtrl(): usage midiCtrl(midiChan, midiCtrl\")\n";
+                    cUtils::debug(strTokens[3]);
+                    cabbageIdentifiers.set(CabbageIDs::sliderskew, strTokens[3].trim().getDoubleValue());
+                    tempArray.add(strTokens[3].trim());
                 }
-                else
+
+                if(strTokens.size()>4)
                 {
-                    cabbageIdentifiers.set(CabbageIDs::midichan, strTokens[0].trim().getFloatValue());
-                    cabbageIdentifiers.set(CabbageIDs::midictrl, strTokens[0].trim().getFloatValue());
+                    tempArray.add(strTokens[4].trim());
+                    cUtils::debug(strTokens.joinIntoString("\n"));
+                    cabbageIdentifiers.set(CabbageIDs::sliderincr, strTokens[4].trim().getDoubleValue());
                 }
+
+                double sliderRange = max-min;
+                int decimalPlaces = getNumberOfDecimalPlaces(tempArray);
+                if(decimalPlaces<1 && max<=1)
+                    decimalPlaces = 2;
+                else
+                    decimalPlaces = getNumberOfDecimalPlaces(tempArray);
+                cabbageIdentifiers.set(CabbageIDs::decimalplaces, decimalPlaces);
+                cabbageIdentifiers.set(CabbageIDs::range, sliderRange);
+
             }
-            else if(identArray[indx].equalsIgnoreCase("max"))
+        }
+        else if(ident.equalsIgnoreCase("rangex"))
+        {
+            if(strTokens.size()<3)
             {
-                cabbageIdentifiers.set(CabbageIDs::maxvalue, strTokens[0].trim().getFloatValue());
+                warningMessages+="Not enough paramters passed to range(): usage range(minx, max, value\")\n";
             }
-
-            else if(identArray[indx].equalsIgnoreCase("sliderincr"))
+            else
             {
-                cabbageIdentifiers.set(CabbageIDs::sliderincr, strTokens[0].trim().getFloatValue());
-            }
+                float minX = strTokens[0].removeCharacters("()").trim().getFloatValue();
+                float maxX = strTokens[1].removeCharacters("()").trim().getFloatValue();
 
-            else if(identArray[indx].equalsIgnoreCase("sliderskew"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::sliderskew, strTokens[0].trim().getFloatValue());
-            }
+                cabbageIdentifiers.set(CabbageIDs::minx, strTokens[0].trim().getDoubleValue());
+                cabbageIdentifiers.set(CabbageIDs::maxx, strTokens[1].getDoubleValue());
+                cabbageIdentifiers.set(CabbageIDs::valuex, strTokens[2].getDoubleValue());
+                cabbageIdentifiers.set(CabbageIDs::rangex, maxX-minX);
 
-            else if(identArray[indx].equalsIgnoreCase("visible"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::visible, strTokens[0].trim().getFloatValue());
+                cabbageIdentifiers.set(CabbageIDs::decimalplaces, strTokens[3].trim().getDoubleValue());
             }
-
-            else if(identArray[indx].equalsIgnoreCase("active"))
+        }
+        else if(ident.equalsIgnoreCase("rangey"))
+        {
+            if(strTokens.size()<3)
             {
-                cabbageIdentifiers.set(CabbageIDs::active, strTokens[0].trim().getFloatValue());
+                warningMessages+="Not enough paramters passed to range(): usage range(minx, max, value\")\n";
             }
-
-            else if(identArray[indx].equalsIgnoreCase("stack"))
+            else
             {
-                cabbageIdentifiers.set(CabbageIDs::stack, strTokens[0].trim().getFloatValue());
-            }
+                float minY = strTokens[0].trim().getFloatValue();
+                float maxY = strTokens[1].trim().getFloatValue();
 
-            else if(identArray[indx].equalsIgnoreCase("tab"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::tabbed, strTokens[0].trim().getFloatValue());
+                cabbageIdentifiers.set(CabbageIDs::miny, strTokens[0].trim().getDoubleValue());
+                cabbageIdentifiers.set(CabbageIDs::maxy, strTokens[1].trim().getDoubleValue());
+                cabbageIdentifiers.set(CabbageIDs::valuey, strTokens[2].trim().getDoubleValue());
+                cabbageIdentifiers.set(CabbageIDs::rangey, maxY-minY);
+                cabbageIdentifiers.set(CabbageIDs::decimalplaces, strTokens[3].trim().getDoubleValue());
             }
+        }
+        else if(ident.equalsIgnoreCase("min"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::minvalue, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("latched"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::latched, strTokens[0].trim().getFloatValue());
-            }
+        else if(ident.equalsIgnoreCase("svgdebug"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::svgdebug, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("alpha"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::alpha, strTokens[0].trim().getFloatValue());
-            }
+        else if(ident.equalsIgnoreCase("middlec"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::middlec, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("corners"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::corners, strTokens[0].trim().getFloatValue());
-            }
+        else if(ident.equalsIgnoreCase("fill"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::fill, strTokens[0].trim().getIntValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("radiogroup"))
+        else if(ident.equalsIgnoreCase("rotate"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::rotate, strTokens[0].trim().getFloatValue());
+            if(strTokens.size()==3)
             {
-                cabbageIdentifiers.set(CabbageIDs::radiogroup, strTokens[0].trim().getFloatValue());
+                cabbageIdentifiers.set(CabbageIDs::pivotx, strTokens[1].trim().getFloatValue());
+                cabbageIdentifiers.set(CabbageIDs::pivoty, strTokens[2].trim().getFloatValue());
             }
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("guirefresh"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::guirefresh, strTokens[0].trim().getFloatValue());
-            }
+        else if(ident.equalsIgnoreCase("pivoty"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::pivoty, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("fontstyle"))
-            {
-                if(strTokens[0].trim()=="bold")
-                    cabbageIdentifiers.set(CabbageIDs::fontstyle, 1);
-                else if(strTokens[0].trim()=="italic")
-                    cabbageIdentifiers.set(CabbageIDs::fontstyle, 2);
-                else if(strTokens[0].trim()=="bold italic")
-                    cabbageIdentifiers.set(CabbageIDs::fontstyle, 3);
-                else if(strTokens[0].trim()=="underlined")
-                    cabbageIdentifiers.set(CabbageIDs::fontstyle, 4);
-                else if(strTokens[0].trim()=="bold underlined")
-                    cabbageIdentifiers.set(CabbageIDs::fontstyle, 5);
-                else if(strTokens[0].trim()=="italic underlined")
-                    cabbageIdentifiers.set(CabbageIDs::fontstyle, 6);
-                else if(strTokens[0].trim()=="bold italic underlined")
-                    cabbageIdentifiers.set(CabbageIDs::fontstyle, 7);
-                else
-                    cabbageIdentifiers.set(CabbageIDs::fontstyle, 0);
-            }
+        else if(ident.equalsIgnoreCase("ffttablenumber"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::ffttablenumber, strTokens[0].trim().getFloatValue()-1);
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("textbox"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::textbox, strTokens[0].trim().getFloatValue());
-            }
+        else if(ident.equalsIgnoreCase("pivotx"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::pivotx, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("velocity"))
+        else if(ident.equalsIgnoreCase("midictrl"))
+        {
+            if(strTokens.size()<2)
             {
-                cabbageIdentifiers.set(CabbageIDs::velocity, strTokens[0].trim().getFloatValue());
+                warningMessages+="Not enough paramters passed to midiCtrl(): usage midiCtrl(midiChan, midiCtrl\")\n";
             }
-
-            else if(identArray[indx].equalsIgnoreCase("gradient"))
+            else
             {
-                cabbageIdentifiers.set(CabbageIDs::gradient, strTokens[0].trim().getFloatValue());
+                cabbageIdentifiers.set(CabbageIDs::midichan, strTokens[0].trim().getFloatValue());
+                cabbageIdentifiers.set(CabbageIDs::midictrl, strTokens[0].trim().getFloatValue());
             }
+        }
+        else if(ident.equalsIgnoreCase("max"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::maxvalue, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("scrubberposition"))
-            {
-                var scrubberInfo;
-                scrubberInfo.append(strTokens[0].trim().getIntValue());
-                for(int i=1; i<strTokens.size(); i++)
-                {
-                    scrubberInfo.append(strTokens[i].trim().getDoubleValue());
-                    cabbageIdentifiers.set(CabbageIDs::scrubberposition, scrubberInfo);
-                }
+        else if(ident.equalsIgnoreCase("sliderincr"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::sliderincr, strTokens[0].trim().getFloatValue());
+        }
 
-                cabbageIdentifiers.set(CabbageIDs::scrubberposition, scrubberInfo);
+        else if(ident.equalsIgnoreCase("sliderskew"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::sliderskew, strTokens[0].trim().getFloatValue());
+        }
 
-            }
+        else if(ident.equalsIgnoreCase("visible"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::visible, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("logger"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::logger, strTokens[0].trim().getIntValue());
-            }
+        else if(ident.equalsIgnoreCase("active"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::active, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("child"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::child, strTokens[0].trim().getIntValue());
-            }
+        else if(ident.equalsIgnoreCase("stack"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::stack, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("show"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::show, strTokens[0].trim().getIntValue());
-            }
+        else if(ident.equalsIgnoreCase("tab"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::tabbed, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("zoom"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::zoom, strTokens[0].trim().getFloatValue());
-                if(strTokens.size()>1)
-                    cabbageIdentifiers.set(CabbageIDs::startpos, strTokens[1].trim().getFloatValue());
-                else
-                    cabbageIdentifiers.set(CabbageIDs::startpos, -1);
-            }
+        else if(ident.equalsIgnoreCase("latched"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::latched, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("samplerange"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::startpos, strTokens[0].trim().getFloatValue());
-                if(strTokens.size()>1)
-                    cabbageIdentifiers.set(CabbageIDs::endpos, strTokens[1].trim().getFloatValue());
-                else
-                    cabbageIdentifiers.set(CabbageIDs::endpos, -1);
-            }
+        else if(ident.equalsIgnoreCase("alpha"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::alpha, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("wrap"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::wrap, strTokens[0].trim().getFloatValue());
-            }
+        else if(ident.equalsIgnoreCase("smooth"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::smooth, strTokens[0].trim().getFloatValue());
+            if(strTokens.size()>1)
+                cabbageIdentifiers.set(CabbageIDs::smoothmode, strTokens[1].trim());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("readonly"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::readonly, strTokens[0].trim().getFloatValue());
-            }
+        else if(ident.equalsIgnoreCase("oversample"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::oversample, strTokens[0].trim().getIntValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("tablenum")||
-                    (identArray[indx].equalsIgnoreCase("tablenumber")||
-                     identArray[indx].equalsIgnoreCase("tablenumbers")||
-                     identArray[indx].equalsIgnoreCase("tablenumbs")))
-            {
-                var value;
-                var tableConfig;
-                //value.append(tableNum);
-                //tableNumbers.add(tableNum);
+        else if(ident.equalsIgnoreCase("alignksmps"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::alignksmps, strTokens[0].trim().getIntValue());
+        }
 
-                for(int i=0; i<strTokens.size(); i++)
-                {
-                    if(strTokens[i].contains(":") && strTokens.size()>0)
-                    {
-                        //split string into two
-                        StringArray tablesData;
-                        tablesData.addTokens(strTokens[i], ":", "");
-                        var tables;
-                        for(int w=0; w<tablesData.size(); w++)
-                        {
-                            tables.append(tablesData[w]);
-                            value.append(tablesData[w]);
-                            //Logger::writeToLog(tablesData[w]);
+        else if(ident.equalsIgnoreCase("crossfade"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::crossfade, strTokens[0].trim().getIntValue());
+        }
 
-                        }
-                        //value.append(tables);
-                        tableConfig.append(tables);
-                    }
-                    else
-                    {
-                        tableNumbers.add(strTokens[i].trim().getFloatValue());
-                        value.append(strTokens[i].trim().getFloatValue());
-                        tableConfig.append(strTokens[i].trim().getFloatValue());
-                        //Logger::writeToLog(strTokens[i].trim());
-                    }
-                }
+        else if(ident.equalsIgnoreCase("corners"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::corners, strTokens[0].trim().getFloatValue());
+        }
 
-                cabbageIdentifiers.set(CabbageIDs::tableconfig, tableConfig);
-                cabbageIdentifiers.set(CabbageIDs::tablenumber, value);
-            }
-            else if(identArray[indx].equalsIgnoreCase("popup"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::popup, strTokens[0].trim().getIntValue());
-            }
+        else if(ident.equalsIgnoreCase("radiogroup"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::radiogroup, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("resize"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::popup, strTokens[0].trim().getIntValue());
-            }
+        else if(ident.equalsIgnoreCase("guirefresh"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::guirefresh, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("resize"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::popup, strTokens[0].trim().getIntValue());
-            }
+        else if(ident.equalsIgnoreCase("fontstyle"))
+        {
+            if(strTokens[0].trim()=="bold")
+                cabbageIdentifiers.set(CabbageIDs::fontstyle, 1);
+            else if(strTokens[0].trim()=="italic")
+                cabbageIdentifiers.set(CabbageIDs::fontstyle, 2);
+            else if(strTokens[0].trim()=="bold italic")
+                cabbageIdentifiers.set(CabbageIDs::fontstyle, 3);
+            else if(strTokens[0].trim()=="underlined")
+                cabbageIdentifiers.set(CabbageIDs::fontstyle, 4);
+            else if(strTokens[0].trim()=="bold underlined")
+                cabbageIdentifiers.set(CabbageIDs::fontstyle, 5);
+            else if(strTokens[0].trim()=="italic underlined")
+                cabbageIdentifiers.set(CabbageIDs::fontstyle, 6);
+            else if(strTokens[0].trim()=="bold italic underlined")
+                cabbageIdentifiers.set(CabbageIDs::fontstyle, 7);
+            else
+                cabbageIdentifiers.set(CabbageIDs::fontstyle, 0);
+        }
+
+        else if(ident.equalsIgnoreCase("textbox"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::textbox, strTokens[0].trim().getFloatValue());
+        }
+
+        else if(ident.equalsIgnoreCase("velocity"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::velocity, strTokens[0].trim().getFloatValue());
+        }
+
+        else if(ident.equalsIgnoreCase("gradient"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::gradient, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("rescale"))
+        else if(ident.equalsIgnoreCase("scrubberposition"))
+        {
+            var scrubberInfo;
+            scrubberInfo.append(strTokens[0].trim().getIntValue());
+            for(int i=1; i<strTokens.size(); i++)
             {
-                cabbageIdentifiers.set(CabbageIDs::scalex, strTokens[0].trim().getFloatValue());
-                cabbageIdentifiers.set(CabbageIDs::scaley, strTokens[1].trim().getFloatValue());
+                scrubberInfo.append(strTokens[i].trim().getDoubleValue());
+                cabbageIdentifiers.set(CabbageIDs::scrubberposition, scrubberInfo);
             }
 
-            else if(identArray[indx].equalsIgnoreCase("resizemode"))
+            cabbageIdentifiers.set(CabbageIDs::scrubberposition, scrubberInfo);
+
+        }
+
+        else if(ident.equalsIgnoreCase("logger"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::logger, strTokens[0].trim().getIntValue());
+        }
+
+        else if(ident.equalsIgnoreCase("child"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::child, strTokens[0].trim().getIntValue());
+        }
+
+        else if(ident.equalsIgnoreCase("show"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::show, strTokens[0].trim().getIntValue());
+        }
+
+        else if(ident.equalsIgnoreCase("zoom"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::zoom, strTokens[0].trim().getFloatValue());
+            if(strTokens.size()>1)
+                cabbageIdentifiers.set(CabbageIDs::startpos, strTokens[1].trim().getFloatValue());
+            else
+                cabbageIdentifiers.set(CabbageIDs::startpos, -1);
+        }
+
+        else if(ident.equalsIgnoreCase("samplerange"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::startpos, strTokens[0].trim().getFloatValue());
+            if(strTokens.size()>1)
+                cabbageIdentifiers.set(CabbageIDs::endpos, strTokens[1].trim().getFloatValue());
+            else
+                cabbageIdentifiers.set(CabbageIDs::endpos, -1);
+        }
+
+        else if(ident.equalsIgnoreCase("wrap"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::wrap, strTokens[0].trim().getFloatValue());
+        }
+
+        else if(ident.equalsIgnoreCase("readonly"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::readonly, strTokens[0].trim().getFloatValue());
+        }
+
+        else if(ident.equalsIgnoreCase("tablenum")||
+                (ident.equalsIgnoreCase("tablenumber")||
+                 ident.equalsIgnoreCase("tablenumbers")||
+                 ident.equalsIgnoreCase("tablenumbs")))
+        {
+            var value;
+            var tableConfig;
+            //value.append(tableNum);
+            //tableNumbers.add(tableNum);
+
+            for(int i=0; i<strTokens.size(); i++)
             {
-                var value;
-                if(strTokens.size()>0)
-                    for(int i=0; i<strTokens.size(); i++)
+                if(strTokens[i].contains(":") && strTokens.size()>0)
+                {
+                    //split string into two
+                    StringArray tablesData;
+                    tablesData.addTokens(strTokens[i], ":", "");
+                    var tables;
+                    for(int w=0; w<tablesData.size(); w++)
                     {
-                        //add table modes to val array
-                        value.append(strTokens[i].trim().getFloatValue());
+                        tables.append(tablesData[w]);
+                        value.append(tablesData[w]);
+                        //Logger::writeToLog(tablesData[w]);
+
                     }
-                cabbageIdentifiers.set(CabbageIDs::resizemode, value);
+                    //value.append(tables);
+                    tableConfig.append(tables);
+                }
+                else
+                {
+                    tableNumbers.add(strTokens[i].trim().getFloatValue());
+                    value.append(strTokens[i].trim().getFloatValue());
+                    tableConfig.append(strTokens[i].trim().getFloatValue());
+                    //Logger::writeToLog(strTokens[i].trim());
+                }
             }
 
-            else if(identArray[indx].equalsIgnoreCase("amprange"))
-            {
-                if(strTokens.size()<3)
-                    warningMessages+="Not enough paramters passed to amprange(): usage amprange(min, max, tablenumber, quantise\")\n";
+            cabbageIdentifiers.set(CabbageIDs::tableconfig, tableConfig);
+            cabbageIdentifiers.set(CabbageIDs::tablenumber, value);
+        }
+        else if(ident.equalsIgnoreCase("popup"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::popup, strTokens[0].trim().getIntValue());
+        }
 
-                var value;
-                var temp = cabbageIdentifiers.getWithDefault(CabbageIDs::amprange, "");
+        else if(ident.equalsIgnoreCase("resize"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::popup, strTokens[0].trim().getIntValue());
+        }
+
+        else if(ident.equalsIgnoreCase("resize"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::popup, strTokens[0].trim().getIntValue());
+        }
 
-                for(int i=0; i<temp.size(); i++)
-                    value.append(temp[i]);
+        else if(ident.equalsIgnoreCase("rescale"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::scalex, strTokens[0].trim().getFloatValue());
+            cabbageIdentifiers.set(CabbageIDs::scaley, strTokens[1].trim().getFloatValue());
+        }
 
+        else if(ident.equalsIgnoreCase("resizemode"))
+        {
+            var value;
+            if(strTokens.size()>0)
                 for(int i=0; i<strTokens.size(); i++)
                 {
                     //add table modes to val array
                     value.append(strTokens[i].trim().getFloatValue());
                 }
-                //set default quantise space..
-                if(strTokens.size()==3)
-                    value.append(0.01);
+            cabbageIdentifiers.set(CabbageIDs::resizemode, value);
+        }
 
-                cabbageIdentifiers.set(CabbageIDs::amprange, value);
-                //identifiers that appear more than once need to use indx-- so we can check for another instance
-                indx--;
-            }
+        else if(ident.equalsIgnoreCase("amprange"))
+        {
+            if(strTokens.size()<3)
+                warningMessages+="Not enough paramters passed to amprange(): usage amprange(min, max, tablenumber, quantise\")\n";
 
-            else if(identArray[indx].equalsIgnoreCase("outlinethickness"))
-            {
-                //cabbageIdentifiers.set("line", strTokens[0].trim().getFloatValue());
-                cabbageIdentifiers.set(CabbageIDs::outlinethickness, strTokens[0].trim().getFloatValue());
-            }
+            var value;
+            var temp = cabbageIdentifiers.getWithDefault(CabbageIDs::amprange, "");
 
-            else if(identArray[indx].equalsIgnoreCase("linethickness"))
-            {
-                //cabbageIdentifiers.set("line", strTokens[0].trim().getFloatValue());
-                cabbageIdentifiers.set(CabbageIDs::linethickness, strTokens[0].trim().getFloatValue());
-            }
+            for(int i=0; i<temp.size(); i++)
+                value.append(temp[i]);
 
-            else if(identArray[indx].equalsIgnoreCase("trackerthickness"))
+            for(int i=0; i<strTokens.size(); i++)
             {
-                //cabbageIdentifiers.set("line", strTokens[0].trim().getFloatValue());
-                cabbageIdentifiers.set(CabbageIDs::trackerthickness, strTokens[0].trim().getFloatValue());
+                //add table modes to val array
+                value.append(strTokens[i].trim().getFloatValue());
             }
+            //set default quantise space..
+            if(strTokens.size()==3)
+                value.append(0.01);
 
-            else if(identArray[indx].equalsIgnoreCase("value"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::value, strTokens[0].trim().getFloatValue());
-            }
+            cabbageIdentifiers.set(CabbageIDs::amprange, value);
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("scrollbars"))
-            {
-                cabbageIdentifiers.set(CabbageIDs::scrollbars, strTokens[0].trim().getIntValue());
-            }
+        else if(ident.equalsIgnoreCase("outlinethickness"))
+        {
+            //cabbageIdentifiers.set("line", strTokens[0].trim().getFloatValue());
+            cabbageIdentifiers.set(CabbageIDs::outlinethickness, strTokens[0].trim().getFloatValue());
+        }
 
-            //============================================
-            //sample identifiers for stepper class
-            //============================================
-            else if(identArray[indx].equalsIgnoreCase("numberofsteps"))
-            {
-                cabbageIdentifiers.set("numberofsteps", strTokens[0].trim().getFloatValue());
-            }
+        else if(ident.equalsIgnoreCase("linethickness"))
+        {
+            //cabbageIdentifiers.set("line", strTokens[0].trim().getFloatValue());
+            cabbageIdentifiers.set(CabbageIDs::linethickness, strTokens[0].trim().getFloatValue());
+        }
 
-            else if(identArray[indx].equalsIgnoreCase("stepbpm"))
-            {
-                cabbageIdentifiers.set("stepbpm", strTokens[0].trim().getIntValue());
-            }
+        else if(ident.equalsIgnoreCase("trackerthickness"))
+        {
+            //cabbageIdentifiers.set("line", strTokens[0].trim().getFloatValue());
+            cabbageIdentifiers.set(CabbageIDs::trackerthickness, strTokens[0].trim().getFloatValue());
+        }
 
+        else if(ident.equalsIgnoreCase("value"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::value, strTokens[0].trim().getFloatValue());
+        }
 
-            strTokens.clear();
+        else if(ident.equalsIgnoreCase("scrollbars"))
+        {
+            cabbageIdentifiers.set(CabbageIDs::scrollbars, strTokens[0].trim().getIntValue());
         }
-        else
+
+        //============================================
+        //sample identifiers for stepper class
+        //============================================
+        else if(ident.equalsIgnoreCase("numberofsteps"))
         {
+            cabbageIdentifiers.set("numberofsteps", strTokens[0].trim().getFloatValue());
+        }
 
+        else if(ident.equalsIgnoreCase("stepbpm"))
+        {
+            cabbageIdentifiers.set("stepbpm", strTokens[0].trim().getIntValue());
         }
 
-        //}
+
+        strTokens.clear();
     }
 }
 //=========================================================================
 //retrieve numerical attributes
 float CabbageGUIType::getNumProp(Identifier prop)
+{
+    if(const float* field = getDescriptorField(prop))
+        return *field;
+    return getNumPropFromIdentifiers(prop);
+}
+
+float CabbageGUIType::getNumPropFromIdentifiers(const Identifier& prop)
 {
     var props = cabbageIdentifiers.getWithDefault(prop, -9999);
     if(props.size()>0)
@@ -2162,6 +2458,10 @@ float CabbageGUIType::getSkewFromText(String text)
 void CabbageGUIType::setNumProp(Identifier prop, float val)
 {
     cabbageIdentifiers.set(prop, val);
+    if(float* field = getDescriptorField(prop))
+        *field = val;
+    else
+        updateDescriptor(prop);
 }
 //===================================================================
 float CabbageGUIType::getTableChannelValues(int index)
@@ -2204,6 +2504,9 @@ Rectangle<int> CabbageGUIType::getComponentBounds()
 //===================================================================
 String CabbageGUIType::getStringProp(Identifier prop)
 {
+    if(prop==CabbageIDs::channel)
+        return descriptor.channel;
+
     var strings = cabbageIdentifiers.getWithDefault(prop, "");
 
 
@@ -2248,6 +2551,7 @@ void CabbageGUIType::setStringArrayProp(Identifier prop, var value)
     cabbageIdentifiers.remove(prop);
     cabbageIdentifiers.set(prop, value);
     //cabbageIdentifiers.set(prop, value);
+    updateDescriptor(prop);
 }
 //===================================================================
 void CabbageGUIType::setStringArrayPropValue(Identifier prop, int index, String value)
@@ -2258,6 +2562,7 @@ void CabbageGUIType::setStringArrayPropValue(Identifier prop, int index, String
         {
             strings.getArray()->set(index, value);
             cabbageIdentifiers.set(prop, strings);
+            updateDescriptor(prop);
         }
 
 }
@@ -2327,6 +2632,7 @@ void CabbageGUIType::scaleWidget(Point<float> scale)
     cabbageIdentifiers.set(CabbageIDs::top, rect.getY()*scale.y);
     cabbageIdentifiers.set(CabbageIDs::width, rect.getWidth()*scale.x);
     cabbageIdentifiers.set(CabbageIDs::height, rect.getHeight()*scale.y);	;
+    updateDescriptor();
 }
 //===================================================================
 void CabbageGUIType::setStringProp(Identifier prop, String val)
@@ -2335,6 +2641,7 @@ void CabbageGUIType::setStringProp(Identifier prop, String val)
 //	cUtils::debug(val);
 
     cabbageIdentifiers.set(prop, val);
+    updateDescriptor(prop);
 }
 //===================================================================
 String CabbageGUIType::getColourProp(Identifier prop)
@@ -204,6 +204,10 @@ public:
 //sample identifiers for stepper widget
         add("numberofsteps");
         add("stepbpm");
+        add("crossfade");
+        add("smooth");
+        add("oversample");
+        add("alignksmps");
     }
 
     ~IdentArray()
@@ -323,6 +327,11 @@ static const Identifier workingdir = "workingdir";
 static const Identifier author = "author";
 static const Identifier xychannel = "xychannel";
 static const Identifier guirefresh = "guirefresh";
+static const Identifier crossfade = "crossfade";
+static const Identifier smooth = "smooth";
+static const Identifier smoothmode = "smoothmode";
+static const Identifier oversample = "oversample";
+static const Identifier alignksmps = "alignksmps";
 static const Identifier identchannel = "identchannel";
 static const Identifier identchannelmessage = "identchannelmessage";
 static const Identifier visible = "visible";
@@ -388,6 +397,8 @@ static const String hostppqpos = "HOST_PPQ_POS";
 static const String timeinsamples = "TIME_IN_SAMPLES";
 static const String timeSigDenom = "TIME_SIG_DENOM";
 static const String timeSigNum = "TIME_SIG_NUM";
+static const String cpuload = "CABBAGE_CPU_LOAD";
+static const String presetmorph = "CABBAGE_PRESET_MORPH";
 static const String mousex = "MOUSE_X";
 static const String mousey = "MOUSE_Y";
 static const String mousedownleft = "MOUSE_DOWN_LEFT";
@@ -401,12 +412,67 @@ static const String fftdisplay = "fftdisplay";
 
 class CabbageGUIType : public cUtils
 {
+public:
+    //widget types, resolved from the type string once when the widget is parsed
+    enum WidgetKind
+    {
+        otherWidget = 0,
+        sliderWidget,           //hslider, vslider, rslider and their variants
+        rangeWidget,            //hrange and vrange
+        comboboxWidget,
+        checkboxWidget,
+        buttonWidget,
+        encoderWidget,
+        numberboxWidget,
+        xypadWidget,
+        formWidget,
+        tableWidget,
+        gentableWidget,
+        soundfilerWidget,
+        texteditorWidget,
+        textboxWidget,
+        filebuttonWidget,
+        csoundoutputWidget,
+        fftdisplayWidget,
+        keyboardWidget,
+        labelWidget,
+        imageWidget,
+        groupboxWidget,
+        stepperWidget,
+        numWidgetKinds
+    };
+
+    static WidgetKind getKindFromType(const String& type);
+
+private:
     double width, height, top, left;
     Array<int> vuConfig;
     Array<int> tableNumbers;
     Array<float> tableChannelValues;
     String warningMessages;
 
+    //typed copies of the properties that the processor and editor read on every
+    //refresh. cabbageIdentifiers still holds everything, and is what gets written
+    //back to the csd, but these are kept in step with it by parse() and the
+    //set*Prop() methods so that reading them is a field access rather than a
+    //search through a NamedValueSet
+    struct Descriptor
+    {
+        WidgetKind kind;
+        float left, top, width, height;
+        float min, max, range, value, skew, comboRange;
+        float declaredValue;            //value as written in the csd, runtime changes leave it alone
+        String channel;
+        bool stringChannel;
+    };
+    Descriptor descriptor;
+
+    float* getDescriptorField(const Identifier& prop);
+    float getNumPropFromIdentifiers(const Identifier& prop);
+    void updateDescriptor(const Identifier& prop);
+    void updateDescriptor();
+    void parseIdentifiers(String str, String identifier);
+
 public:
     String getWarningMessages()
     {
@@ -414,9 +480,54 @@ public:
     };
     NamedValueSet cabbageIdentifiers;
     CabbageGUIType(String str, int ID);
-    CabbageGUIType() {};
+    CabbageGUIType();
     ~CabbageGUIType();
     void parse(String str, String identifier);
+    bool isEquivalentTo(const CabbageGUIType& other, bool ignoreName=false) const;
+    void swapWith(CabbageGUIType& other) noexcept;
+    void copyAudioThreadValuesFrom(const CabbageGUIType& other, bool includingValue) noexcept;
+
+    //============ typed accessors for hot paths ==========================
+    inline WidgetKind getKind() const
+    {
+        return descriptor.kind;
+    }
+
+    inline float getValue() const
+    {
+        return descriptor.value;
+    }
+
+    inline float getDeclaredValue() const
+    {
+        return descriptor.declaredValue;
+    }
+
+    inline float getMin() const
+    {
+        return descriptor.min;
+    }
+
+    inline float getRange() const
+    {
+        return descriptor.range;
+    }
+
+    inline float getComboRange() const
+    {
+        return descriptor.comboRange;
+    }
+
+    inline const String& getChannel() const
+    {
+        return descriptor.channel;
+    }
+
+    inline bool isStringChannel() const
+    {
+        return descriptor.stringChannel;
+    }
+
     float getNumProp(Identifier prop);
     void setNumProp(Identifier prop, float val);
     void setTableChannelValues(int index, float val);
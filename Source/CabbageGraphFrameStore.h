@@ -0,0 +1,172 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGEGRAPHFRAMESTORE_H
+#define CABBAGEGRAPHFRAMESTORE_H
+
+#include "CabbageTableMirror.h"
+
+#ifndef Cabbage_No_Csound
+#include "csound.hpp"
+#include "cwindow.h"
+
+//==============================================================================
+// Holds the frames Csound sends to its graph callbacks, one triple buffer per
+// window. makeGraphCallback() sets a window up with room for its npts, after
+// which drawGraphCallback() copies each frame into the back buffer and swaps
+// it in without allocating or locking. The message thread picks up the newest
+// frame whenever it gets round to it; any frame that was replaced before it
+// could do so is counted as dropped. Windows are numbered in the order Csound
+// created them, which is what fftdisplay's tablenumber refers to, and are
+// matched by caption so that each new note of the same instrument draws into
+// the window its predecessors used.
+//==============================================================================
+class CabbageGraphFrameStore
+{
+public:
+    enum { maxWindows = 32 };
+
+    CabbageGraphFrameStore() : numWindows(0), unknownWindowFrames(0) {}
+    ~CabbageGraphFrameStore() {}
+
+    //Csound thread, from makeGraphCallback(). Sets windat->windid, which Csound
+    //expects the callback to fill in. Reusing a window keeps its buffers, so
+    //frames longer than the first one it was made for are truncated
+    bool prepare(WINDAT* windat)
+    {
+        const SpinLock::ScopedLockType sl(prepareLock);
+        const String caption(windat->caption);
+        const int num = numWindows.get();
+        for(int i=0; i<num; i++)
+        {
+            if(windows[i].caption==caption)
+            {
+                windat->windid = (uintptr_t)(i+1);
+                return true;
+            }
+        }
+
+        const int npts = (int)windat->npts;
+        if(num>=maxWindows || npts<=0)
+            return false;
+
+        Window& window = windows[num];
+        window.caption = caption;
+        window.capacity = npts;
+        window.buffers.calloc(3*npts);
+        zeromem(window.sizes, sizeof(window.sizes));
+        zeromem(window.versions, sizeof(window.versions));
+        window.shared.set(1);
+        window.back = 0;
+        window.front = 2;
+        window.framesWritten = 0;
+        window.framesDropped.set(0);
+
+        //readers only look at windows below numWindows
+        numWindows.set(num+1);
+        windat->windid = (uintptr_t)(num+1);
+        return true;
+    }
+
+    //Csound thread, from drawGraphCallback()
+    void write(const WINDAT* windat)
+    {
+        const int index = (int)windat->windid-1;
+        if(!isPositiveAndBelow(index, numWindows.get()) || windat->fdata==nullptr)
+        {
+            ++unknownWindowFrames;
+            return;
+        }
+
+        Window* window = &windows[index];
+        const MYFLT* data = windat->fdata;
+        const int size = jmin((int)windat->npts, window->capacity);
+        float* dest = window->buffers + window->back*window->capacity;
+        for(int i=0; i<size; i++)
+            dest[i] = (float)data[i];
+        window->sizes[window->back] = size;
+        window->versions[window->back] = ++window->framesWritten;
+
+        //publish the back buffer and take the spare one in exchange
+        const int previous = window->shared.exchange(window->back | newDataFlag);
+        window->back = previous & 3;
+        if((previous & newDataFlag)!=0)
+            ++window->framesDropped;
+    }
+
+    //message thread. Returns the newest frame of the index'th window, or nullptr if
+    //there is no such window. The data stays valid until the next call for that window
+    const CabbageTableSnapshot* fetch(int index)
+    {
+        if(!isPositiveAndBelow(index, numWindows.get()))
+            return nullptr;
+
+        Window& window = windows[index];
+        if((window.shared.get() & newDataFlag)!=0)
+            window.front = window.shared.exchange(window.front) & 3;
+
+        window.frame.data = window.buffers + window.front*window.capacity;
+        window.frame.size = window.sizes[window.front];
+        window.frame.version = window.versions[window.front];
+        return &window.frame;
+    }
+
+    //frames that were overwritten before the message thread fetched them
+    int getNumDroppedFrames() const
+    {
+        int dropped = unknownWindowFrames.get();
+        for(int i=0; i<numWindows.get(); i++)
+            dropped += windows[i].framesDropped.get();
+        return dropped;
+    }
+
+    int getNumWindows() const
+    {
+        return numWindows.get();
+    }
+
+private:
+    struct Window
+    {
+        String caption;
+        int capacity;
+        HeapBlock<float> buffers;
+        int sizes[3];
+        uint32 versions[3];
+        Atomic<int> shared;         //index of the spare buffer, plus newDataFlag
+        int back, front;            //owned by the writer and reader respectively
+        uint32 framesWritten;
+        Atomic<int> framesDropped;
+        CabbageTableSnapshot frame;
+    };
+
+    enum { newDataFlag = 4 };
+
+    Window windows[maxWindows];
+    Atomic<int> numWindows;
+    Atomic<int> unknownWindowFrames;
+    SpinLock prepareLock;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageGraphFrameStore);
+};
+
+#endif
+#endif
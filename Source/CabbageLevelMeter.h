@@ -0,0 +1,118 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGELEVELMETER_H
+#define CABBAGELEVELMETER_H
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// Per-channel peak, RMS and peak-hold levels. process() is called from the
+// audio thread and only writes to atomics, so it neither allocates nor posts
+// messages. Editors poll the getters from a timer at whatever rate they draw.
+//==============================================================================
+class CabbageLevelMeter
+{
+public:
+    enum
+    {
+        maxChannels = 64
+    };
+
+    CabbageLevelMeter():
+        holdTimeInSamples(66150)
+    {
+        reset();
+    }
+
+    ~CabbageLevelMeter() {}
+
+    //call from prepareToPlay(), peaks are held for holdTime seconds
+    void prepare(double sampleRate, double holdTime=1.5)
+    {
+        holdTimeInSamples = jmax(1, roundToInt(sampleRate*holdTime));
+        reset();
+    }
+
+    void reset()
+    {
+        numChannels.set(0);
+        for(int i=0; i<maxChannels; i++)
+        {
+            peak[i].set(0.f);
+            rms[i].set(0.f);
+            peakHold[i].set(0.f);
+            holdCounter[i] = 0;
+        }
+    }
+
+    //audio thread only
+    void process(const AudioSampleBuffer& buffer, int numSamples)
+    {
+        const int chans = jmin((int)maxChannels, buffer.getNumChannels());
+        for(int i=0; i<chans; i++)
+        {
+            const float magnitude = buffer.getMagnitude(i, 0, numSamples);
+            peak[i].set(magnitude);
+            rms[i].set(buffer.getRMSLevel(i, 0, numSamples));
+
+            holdCounter[i] -= numSamples;
+            if(magnitude>=peakHold[i].get() || holdCounter[i]<=0)
+            {
+                peakHold[i].set(magnitude);
+                holdCounter[i] = holdTimeInSamples;
+            }
+        }
+        numChannels.set(chans);
+    }
+
+    int getNumChannels() const
+    {
+        return numChannels.get();
+    }
+
+    float getPeak(int channel) const
+    {
+        return isPositiveAndBelow(channel, (int)maxChannels) ? peak[channel].get() : 0.f;
+    }
+
+    float getRMS(int channel) const
+    {
+        return isPositiveAndBelow(channel, (int)maxChannels) ? rms[channel].get() : 0.f;
+    }
+
+    float getPeakHold(int channel) const
+    {
+        return isPositiveAndBelow(channel, (int)maxChannels) ? peakHold[channel].get() : 0.f;
+    }
+
+private:
+    Atomic<int> numChannels;
+    Atomic<float> peak[maxChannels];
+    Atomic<float> rms[maxChannels];
+    Atomic<float> peakHold[maxChannels];
+    int holdCounter[maxChannels];
+    int holdTimeInSamples;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageLevelMeter)
+};
+
+#endif
@@ -19,6 +19,9 @@
 
 #include "CabbageLookAndFeel.h"
 
+//rendered svg skins, shared by every look and feel in the process
+juce_ImplementSingleton (CabbageSVGCache)
+
 
 namespace LookAndFeelHelpers
 {
@@ -506,10 +509,9 @@ void CabbageLookAndFeel::drawRotarySlider (Graphics& g, int x, int y, int width,
                 g.fillPath (filledArc);
             }
 
+            //the knob is rendered once for its size, and rotated as it's drawn
             g.setOpacity(1.0);
-            g.drawImage(cUtils::drawFromSVG(svgSlider, svgSliderWidth, svgSliderHeight, AffineTransform::rotation(angle,
-                                            svgRSliderDiameter/2, svgRSliderDiameter/2)), rx, ry, diameter, diameter,
-                        0, 0, svgSliderWidth, svgSliderHeight, false);
+            cUtils::drawRotatedSVG(g, svgSlider, svgSliderWidth, svgSliderHeight, Rectangle<float>(rx, ry, diameter, diameter), angle);
             useSliderSVG = true;
 
         }
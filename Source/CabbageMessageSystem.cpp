@@ -1,35 +1,332 @@
 #include "CabbageMessageSystem.h"
 
-void CabbageMessageQueue::addOutgoingChannelMessageToQueue(String _chan, double _val, String _type)
+CabbageMessageQueue::CabbageMessageQueue()
+    : slots(maxChannels), numSlots(0), payloads(maxPayloads), messages(maxMessages), fifo(maxMessages)
 {
-    outgoingChannelMessages.add(CabbageChannelMessage(_chan, _val, _type));
+    //HeapBlock doesn't construct its elements
+    for(int i=0; i<maxChannels; i++)
+        new (slots + i) ChannelSlot();
+    for(int i=0; i<maxPayloads; i++)
+        new (payloads + i) Payload();
 }
 
-void CabbageMessageQueue::addOutgoingChannelMessageToQueue(String _chan, String _val, String _type)
+CabbageMessageQueue::~CabbageMessageQueue()
 {
-    outgoingChannelMessages.add(CabbageChannelMessage(_chan, _val, _type));
+    for(int i=0; i<maxChannels; i++)
+        slots[i].~ChannelSlot();
+    for(int i=0; i<maxPayloads; i++)
+        payloads[i].~Payload();
 }
 
-void CabbageMessageQueue::addOutgoingTableUpdateMessageToQueue(String fStatement, int tableNumber)
+//call with slotLock held. A slot is only renamed once it has been freed with
+//nothing queued, so the consumer never sees a name change under it. Unused
+//slots are handed out before freed ones, so that a freed slot is more likely
+//to still be there for its channel
+int CabbageMessageQueue::getSlotForChannel(const String& channel)
 {
-    CabbageChannelMessage tableMessage("", 0.f, "updateTable");
-    tableMessage.fStatement = fStatement;
-    tableMessage.tableNumber = tableNumber;
-    outgoingChannelMessages.add(tableMessage);
+    if(slotIndexes.contains(channel))
+    {
+        const int slot = slotIndexes[channel];
+        if(!slots[slot].inUse)
+        {
+            freeSlots.removeFirstMatchingValue(slot);
+            slots[slot].inUse = true;
+        }
+        return slot;
+    }
+
+    int slot;
+    if(numSlots<maxChannels)
+        slot = numSlots++;
+    else if(freeSlots.size()>0)
+    {
+        slot = freeSlots.removeAndReturn(0);
+        slotIndexes.remove(slots[slot].name);
+    }
+    else
+        return -1;
+
+    slots[slot].name = channel;
+    slots[slot].inUse = true;
+    slotIndexes.set(channel, slot);
+    return slot;
+}
+
+int CabbageMessageQueue::getChannelSlot(const String& channel)
+{
+    const ScopedLock sl(slotLock);
+    return getSlotForChannel(channel);
+}
+
+void CabbageMessageQueue::reclaimChannelSlots()
+{
+    const ScopedLock sl(slotLock);
+    //removing from freeSlots can shrink it, so grow it back before the spin lock
+    freeSlots.ensureStorageAllocated(maxChannels);
+    const SpinLock::ScopedLockType pl(producerLock);
+
+    //anything still in the fifo keeps its slot. The consumer is locked out,
+    //so the fifo can be looked at without reading from it
+    for(int i=0; i<numSlots; i++)
+        slots[i].queued = slots[i].pending.get()!=0;
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+    for(int i=0; i<size1+size2; i++)
+    {
+        const int slot = messages[i<size1 ? start1+i : start2+i-size1].slot;
+        if(slot>=0)
+            slots[slot].queued = true;
+    }
+
+    for(int i=0; i<numSlots; i++)
+        if(slots[i].inUse && !slots[i].queued)
+        {
+            slots[i].inUse = false;
+            freeSlots.add(i);
+        }
+}
+
+bool CabbageMessageQueue::drop()
+{
+    ++numDropped;
+    return false;
+}
+
+int CabbageMessageQueue::getNumDroppedMessages() const
+{
+    return numDropped.get();
+}
+
+//claims a free entry without a lock. Entries released by the consumer are
+//only overwritten here, so any reallocation of the old text happens on the
+//producer's thread
+int CabbageMessageQueue::acquirePayload(const String& text)
+{
+    for(int i=0; i<maxPayloads; i++)
+        if(payloads[i].inUse.compareAndSetBool(1, 0))
+        {
+            payloads[i].text = text;
+            return i;
+        }
+    return -1;
+}
+
+bool CabbageMessageQueue::push(const CabbageChannelMessage& message)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if(size1+size2<1)
+        return false;
+
+    messages[size1>0 ? start1 : start2] = message;
+    fifo.finishedWrite(1);
+    return true;
 }
 
-CabbageChannelMessage& CabbageMessageQueue::getOutgoingChannelMessageFromQueue(int index)
+bool CabbageMessageQueue::addOutgoingChannelMessageToQueue(const String& _chan, double _val, const String& _type)
 {
-    return outgoingChannelMessages.getReference(index);
+    if(_type=="string")
+        return addOutgoingChannelMessageToQueue(_chan, String(_val), _type);
+
+    //held until the message is queued, so the slot can't be reclaimed in between
+    const ScopedLock sl(slotLock);
+    const int slot = getSlotForChannel(_chan);
+    if(slot<0)
+        return drop();
+    return addOutgoingSlotMessageToQueue(slot, _val);
 }
 
-int CabbageMessageQueue::getNumberOfOutgoingChannelMessagesInQueue()
+bool CabbageMessageQueue::addOutgoingSlotMessageToQueue(int slot, double value)
 {
-    return outgoingChannelMessages.size();
+    if(!isPositiveAndBelow(slot, (int)maxChannels))
+        return drop();
+
+    slots[slot].value.set(value);
+    //already queued, the consumer will pick up the latest value
+    if(!slots[slot].pending.compareAndSetBool(1, 0))
+        return true;
+
+    CabbageChannelMessage message = { CabbageChannelMessage::controlMessage, slot, -1, 0, 0 };
+    const SpinLock::ScopedLockType pl(producerLock);
+    if(!push(message))
+    {
+        slots[slot].pending.set(0);
+        return drop();
+    }
+    return true;
+}
+
+bool CabbageMessageQueue::addOutgoingChannelMessageToQueue(const String& _chan, const String& _val, const String& _type)
+{
+    const ScopedLock sl(slotLock);
+    const int slot = getSlotForChannel(_chan);
+    if(slot<0)
+        return drop();
+
+    const int payload = acquirePayload(_val);
+    if(payload<0)
+        return drop();
+
+    CabbageChannelMessage message = { CabbageChannelMessage::stringMessage, slot, payload, 0, 0 };
+    const SpinLock::ScopedLockType pl(producerLock);
+    if(!push(message))
+    {
+        payloads[payload].inUse.set(0);
+        return drop();
+    }
+    return true;
+}
+
+bool CabbageMessageQueue::addOutgoingTableUpdateMessageToQueue(const String& fStatement, int tableNumber)
+{
+    const int payload = acquirePayload(fStatement);
+    if(payload<0)
+        return drop();
+
+    CabbageChannelMessage message = { CabbageChannelMessage::tableMessage, -1, payload, tableNumber, 0 };
+    const SpinLock::ScopedLockType pl(producerLock);
+    if(!push(message))
+    {
+        payloads[payload].inUse.set(0);
+        return drop();
+    }
+    return true;
+}
+
+bool CabbageMessageQueue::getNextOutgoingChannelMessage(CabbageChannelMessage& message)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    if(size1+size2<1)
+        return false;
+
+    message = messages[size1>0 ? start1 : start2];
+    fifo.finishedRead(1);
+
+    if(message.type==CabbageChannelMessage::controlMessage)
+    {
+        //clear the flag before reading so a newer value queues itself again
+        slots[message.slot].pending.set(0);
+        message.value = slots[message.slot].value.get();
+    }
+    return true;
+}
+
+void CabbageMessageQueue::releaseOutgoingChannelMessage(const CabbageChannelMessage& message)
+{
+    if(message.payload>=0)
+        payloads[message.payload].inUse.set(0);
+}
+
+const String& CabbageMessageQueue::getChannelName(const CabbageChannelMessage& message) const
+{
+    return message.slot>=0 ? slots[message.slot].name : emptyString;
+}
+
+const String& CabbageMessageQueue::getPayload(const CabbageChannelMessage& message) const
+{
+    return message.payload>=0 ? payloads[message.payload].text : emptyString;
+}
+
+int CabbageMessageQueue::getNumberOfOutgoingChannelMessagesInQueue() const
+{
+    return fifo.getNumReady();
 }
 
 void CabbageMessageQueue::flushOutgoingChannelMessages()
 {
-    //const MessageManagerLock mmLock;
-    outgoingChannelMessages.clear();
-}
\ No newline at end of file
+    CabbageChannelMessage message;
+    while(getNextOutgoingChannelMessage(message))
+        releaseOutgoingChannelMessage(message);
+}
+
+//==============================================================================
+void CabbageIdentChannelMailbox::clear(int numEntries)
+{
+    entries.clear();
+    for(int i=0; i<numEntries; i++)
+        entries.add(nullptr);
+}
+
+void CabbageIdentChannelMailbox::allocateEntry(int index)
+{
+    if(isPositiveAndBelow(index, entries.size()) && entries[index]==nullptr)
+        entries.set(index, new Entry());
+}
+
+bool CabbageIdentChannelMailbox::post(int index, const char* message)
+{
+    Entry* entry = entries[index];
+    if(entry==nullptr || message==nullptr)
+        return false;
+
+    char* buffer = entry->buffers + entry->back*maxMessageLength;
+    strncpy(buffer, message, maxMessageLength-1);
+    buffer[maxMessageLength-1] = 0;
+    //strncpy pads with zeros, so a full buffer means the message didn't fit
+    entry->truncated[entry->back] = buffer[maxMessageLength-2]!=0 && message[maxMessageLength-1]!=0;
+
+    //publish the back buffer and take the spare one in exchange
+    entry->back = entry->shared.exchange(entry->back | newDataFlag) & 3;
+    return true;
+}
+
+bool CabbageIdentChannelMailbox::fetch(int index, String& message, bool& truncated)
+{
+    Entry* entry = entries[index];
+    if(entry==nullptr || (entry->shared.get() & newDataFlag)==0)
+        return false;
+
+    entry->front = entry->shared.exchange(entry->front) & 3;
+    message = String(CharPointer_UTF8(entry->buffers + entry->front*maxMessageLength));
+    truncated = entry->truncated[entry->front];
+    return true;
+}
+
+//==============================================================================
+CabbageDirtyWidgetSet::CabbageDirtyWidgetSet()
+    : words((size_t)maxWidgets/32, true), numWidgets(0)
+{
+}
+
+void CabbageDirtyWidgetSet::clear(int numberOfWidgets)
+{
+    for(int w=0; w<maxWidgets/32; w++)
+        words[w].set(0);
+    numWidgets = jmax(0, numberOfWidgets);
+}
+
+void CabbageDirtyWidgetSet::mark(int index)
+{
+    if(!isPositiveAndBelow(index, jmin((int)maxWidgets, numWidgets)))
+        return;
+
+    Atomic<uint32>& word = words[index>>5];
+    const uint32 bit = (uint32)1 << (index & 31);
+    for(;;)
+    {
+        const uint32 current = word.get();
+        if((current & bit)!=0 || word.compareAndSetBool(current | bit, current))
+            return;
+    }
+}
+
+void CabbageDirtyWidgetSet::takeMarked(Array<int>& indices)
+{
+    indices.clearQuick();
+    const int numWords = (jmin((int)maxWidgets, numWidgets)+31)/32;
+    for(int w=0; w<numWords; w++)
+    {
+        if(words[w].get()==0)
+            continue;
+
+        uint32 bits = words[w].exchange(0);
+        for(int b=0; bits!=0; b++, bits>>=1)
+            if((bits & 1)!=0)
+                indices.add(w*32+b);
+    }
+
+    //there are no bits for these, so they are refreshed every time
+    for(int i=maxWidgets; i<numWidgets; i++)
+        indices.add(i);
+}
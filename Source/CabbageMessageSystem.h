@@ -30,56 +30,206 @@
 using namespace std;
 
 
-//simple channel message classe
-class CabbageChannelMessage : public cUtils
+//simple channel message, plain data so it can live in the ring buffer. Channel
+//names and string payloads are held by the queue and referred to by index
+struct CabbageChannelMessage
 {
-public:
-    String channelName;
+    enum MessageType
+    {
+        controlMessage = 0,
+        stringMessage,
+        tableMessage
+    };
+
+    int type;
+    int slot;               //channel slot, -1 for table updates
+    int payload;            //string pool entry for string and table messages, else -1
+    int tableNumber;
 #ifndef Cabbage_No_Csound
     MYFLT value;
 #else
     float value;
 #endif
-    String type;
-    String fStatement;
-    int tableNumber;
-    String stringVal;
+};
+
+//==============================================================================
+// GUI/host -> Csound message queue. Producers (GUI and host threads) are
+// serialised with a spin lock that is only held to push a message; the audio
+// thread drains the queue without locking or freeing memory. Every channel
+// gets a slot the first time it is used. Looking a channel up by name can
+// allocate, so it happens under a separate critical section, and a producer
+// that may be running on the host's audio thread can send to a slot it looked
+// up in advance instead. A control value is written straight into its slot
+// and only queued if the slot isn't already pending, so a burst of automation
+// on one channel costs the audio thread a single read of the latest value.
+// Strings and f-statements are copied into a small pool that is only ever
+// written, and therefore only reallocated, by producers.
+//==============================================================================
+class CabbageMessageQueue : public cUtils
+{
+public:
+    enum
+    {
+        maxChannels = 1024,
+        maxMessages = 1024,
+        maxPayloads = 128
+    };
+
+    CabbageMessageQueue();
+    ~CabbageMessageQueue();
+
+    //producer side, any non audio thread. These return false, and count the
+    //message as dropped, if the queue, its channels or its strings are used up
+    bool addOutgoingChannelMessageToQueue(const String& _chan, double _val, const String& _type="");
+    bool addOutgoingChannelMessageToQueue(const String& _chan, const String& _val, const String& _type="");
+    bool addOutgoingTableUpdateMessageToQueue(const String& fStatement, int tableNumber);
+    //as above, for a slot from getChannelSlot(). It neither looks the channel up
+    //nor allocates, so a host may call it from its audio thread
+    bool addOutgoingSlotMessageToQueue(int slot, double value);
+    //the slot messages for this channel will carry, or -1 if the queue has
+    //run out of channels. The id stays with the channel until the next
+    //reclaimChannelSlots(), so it can be bound to and looked up by index on
+    //the audio thread
+    int getChannelSlot(const String& channel);
+    //frees the slots of channels that have nothing queued, so that recompiles
+    //which rename channels don't use the table up. Only call this while the
+    //audio thread is locked out, and bind the channels again afterwards. A
+    //channel looked up again gets its old slot back if nobody has taken it
+    void reclaimChannelSlots();
+    int getNumDroppedMessages() const;
+
+    //consumer side, audio thread only. Call releaseOutgoingChannelMessage() once
+    //a message's channel name and payload are no longer needed
+    bool getNextOutgoingChannelMessage(CabbageChannelMessage& message);
+    void releaseOutgoingChannelMessage(const CabbageChannelMessage& message);
+    const String& getChannelName(const CabbageChannelMessage& message) const;
+    const String& getPayload(const CabbageChannelMessage& message) const;
+    int getNumberOfOutgoingChannelMessagesInQueue() const;
+
+    //discards anything pending, only call while the audio thread is locked out
+    void flushOutgoingChannelMessages();
 
-    CabbageChannelMessage(String chan, double val, String _type)
+private:
+    struct ChannelSlot
     {
-        channelName = chan;
-        value = val;
-        type = _type;
-    }
+        ChannelSlot() : inUse(false), queued(false) {}
+        String name;
+        Atomic<double> value;
+        Atomic<int> pending;
+        bool inUse;                 //guarded by slotLock
+        bool queued;                //only used by reclaimChannelSlots()
+    };
+
+    struct Payload
+    {
+        String text;
+        Atomic<int> inUse;
+    };
+
+    int getSlotForChannel(const String& channel);
+    int acquirePayload(const String& text);
+    bool push(const CabbageChannelMessage& message);
+    bool drop();
+
+    HeapBlock<ChannelSlot> slots;
+    int numSlots;
+    HashMap<String, int> slotIndexes;   //also keeps the channels of freed slots
+    Array<int> freeSlots;               //oldest first
+    CriticalSection slotLock;
+    HeapBlock<Payload> payloads;
+    HeapBlock<CabbageChannelMessage> messages;
+    AbstractFifo fifo;
+    SpinLock producerLock;
+    Atomic<int> numDropped;
+    String emptyString;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageMessageQueue);
+};
+
+//==============================================================================
+// Csound -> GUI mailbox for identchannel strings, one entry per widget. The
+// audio thread copies the latest string into a preallocated triple buffer and
+// the message thread picks it up later, so posting never blocks or allocates.
+// Only the most recent string per widget is kept, as was the case when the
+// channel itself was polled.
+//==============================================================================
+class CabbageIdentChannelMailbox
+{
+public:
+    enum { maxMessageLength = 4096 };
+
+    CabbageIdentChannelMailbox() {}
+    ~CabbageIdentChannelMailbox() {}
 
-    CabbageChannelMessage(String chan, String val, String _type)
+    //only call these while the audio thread is locked out
+    void clear(int numEntries);
+    void allocateEntry(int index);
+
+    int getNumEntries() const
     {
-        channelName = chan;
-        stringVal = val;
-        type = _type;
+        return entries.size();
     }
 
-    ~CabbageChannelMessage()
-    {}
+    //audio thread. Messages longer than maxMessageLength-1 bytes are cut short
+    bool post(int index, const char* message);
+
+    //message thread, returns false if nothing new was posted since the last call.
+    //truncated is set if post() had to cut the message short
+    bool fetch(int index, String& message, bool& truncated);
+
+private:
+    struct Entry
+    {
+        Entry() : buffers(3*maxMessageLength, true), shared(1), back(0), front(2)
+        {
+            truncated[0] = truncated[1] = truncated[2] = false;
+        }
+        HeapBlock<char> buffers;
+        bool truncated[3];          //one per buffer, written along with it
+        Atomic<int> shared;         //index of the spare buffer, plus newDataFlag
+        int back, front;            //owned by the writer and reader respectively
+    };
+
+    enum { newDataFlag = 4 };
+
+    OwnedArray<Entry> entries;
 
+    JUCE_DECLARE_NON_COPYABLE(CabbageIdentChannelMailbox);
 };
 
-//message queue class
-class CabbageMessageQueue : public cUtils
+//==============================================================================
+// One dirty bit per widget, indexed as the identchannel mailbox is: interactive
+// widgets first, then layout widgets. Whoever changes a widget's value, or
+// hands it a new identchannel string, marks it, and the editor takes the
+// marked widgets on its next refresh and leaves the rest alone. Marking is a
+// single compare-and-swap, so it is safe from the audio and host threads.
+// The bits are allocated once, for maxWidgets, so clearing never frees memory
+// that another thread may be marking; widgets past that are always reported.
+//==============================================================================
+class CabbageDirtyWidgetSet
 {
-    Array<CabbageChannelMessage, CriticalSection> outgoingChannelMessages;
-
 public:
-    CabbageMessageQueue() {}
-    ~CabbageMessageQueue() {}
-
-    void addOutgoingChannelMessageToQueue(String _chan, double _val, String _type="");
-    void addOutgoingChannelMessageToQueue(String _chan, String _val, String _type="");
-    void addOutgoingTableUpdateMessageToQueue(String fStatement, int tableNumber);
-    CabbageChannelMessage &getOutgoingChannelMessageFromQueue(int index);
-    int getNumberOfOutgoingChannelMessagesInQueue();
-    void flushOutgoingChannelMessages();
+    enum { maxWidgets = 4096 };
+
+    CabbageDirtyWidgetSet();
+    ~CabbageDirtyWidgetSet() {}
+
+    //unmarks everything. Marks made while this runs may be lost, so hold the
+    //callback lock, as the processor does
+    void clear(int numberOfWidgets);
+
+    //any thread
+    void mark(int index);
+
+    //message thread, fills indices with every widget marked since the last
+    //call, in ascending order, and unmarks them
+    void takeMarked(Array<int>& indices);
+
+private:
+    HeapBlock<Atomic<uint32> > words;
+    int numWidgets;
 
+    JUCE_DECLARE_NON_COPYABLE(CabbageDirtyWidgetSet);
 };
 
 
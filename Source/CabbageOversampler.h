@@ -0,0 +1,286 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGEOVERSAMPLER_H
+#define CABBAGEOVERSAMPLER_H
+
+#include "CabbageUtils.h"
+
+//==============================================================================
+// Up and downsamples audio by 2, 4 or 8 around Csound's spin/spout exchange,
+// for instruments that use oversample() in their form. Each factor of two is
+// a linear phase half-band FIR, run in its polyphase form: half of a
+// half-band's taps are zero and one of the two branches is a plain delay, so
+// only the other branch needs multiplying. The first stage, which sits next
+// to the host's Nyquist, uses a long filter. Later stages only have to reject
+// images of audio that's already band limited and get by with short ones.
+//
+// Filters work on whole spans. Each tap is one FloatVectorOperations call
+// across the span, which JUCE runs with SSE or NEON. The stages add up to a
+// fractional delay for 4 and 8 times oversampling, so the upsampled signal
+// is held back a few more samples to make it a whole number of host samples
+// that can be reported to the host.
+//==============================================================================
+class CabbageHalfBandStage
+{
+public:
+    //numBranchTaps must be even. The prototype has 2*numBranchTaps-1 taps
+    CabbageHalfBandStage(int numBranchTaps, float kaiserBeta)
+        : numTaps(numBranchTaps), numChannels(0), maxInputFrames(0)
+    {
+        const int centre = numTaps-1;
+        const double windowScale = 1.0/kaiserBessel(kaiserBeta);
+        taps.malloc(numTaps);
+        for(int k=0; k<numTaps; k++)
+        {
+            //prototype tap 2k, which is an odd distance from the centre
+            const double offset = 2*k-centre;
+            const double ratio = offset/(centre+1);
+            const double window = kaiserBessel(kaiserBeta*std::sqrt(jmax(0.0, 1.0-ratio*ratio)))*windowScale;
+            taps[k] = (float)(std::sin(double_Pi*offset*0.5)/(double_Pi*offset)*window);
+        }
+
+        //normalise so each branch sums to exactly a half, giving unity gain at DC
+        double sum = 0;
+        for(int k=0; k<numTaps; k++)
+            sum += taps[k];
+        for(int k=0; k<numTaps; k++)
+            taps[k] = (float)(taps[k]*0.5/sum);
+    }
+
+    void prepare(int channels, int inputFrames)
+    {
+        numChannels = channels;
+        maxInputFrames = inputFrames;
+        historyLength = numTaps-1;
+        upHistory.allocate(numChannels*(historyLength+maxInputFrames), true);
+        upEven.allocate(maxInputFrames, true);
+        downEven.allocate(numChannels*(historyLength+maxInputFrames), true);
+        downOdd.allocate(numChannels*(historyLength+maxInputFrames), true);
+        downSum.allocate(maxInputFrames, true);
+    }
+
+    void reset()
+    {
+        FloatVectorOperations::clear(upHistory, numChannels*(historyLength+maxInputFrames));
+        FloatVectorOperations::clear(downEven, numChannels*(historyLength+maxInputFrames));
+        FloatVectorOperations::clear(downOdd, numChannels*(historyLength+maxInputFrames));
+    }
+
+    //latency of an up and a down pass, in samples at the stage's higher rate
+    int getRoundTripLatency() const
+    {
+        return 2*(numTaps-1);
+    }
+
+    //numFrames frames from input become 2*numFrames frames in output
+    void upsample(const float* input, float* output, int channel, int numFrames)
+    {
+        jassert(numFrames<=maxInputFrames);
+        float* history = upHistory+channel*(historyLength+maxInputFrames);
+        FloatVectorOperations::copy(history+historyLength, input, numFrames);
+
+        //the multiplying branch, scaled by two to make up for the inserted zeros
+        FloatVectorOperations::clear(upEven, numFrames);
+        for(int k=0; k<numTaps; k++)
+            FloatVectorOperations::addWithMultiply(upEven, history+historyLength-k, 2.f*taps[k], numFrames);
+
+        //the delay branch, which is the centre tap
+        const float* delayed = history+historyLength-(numTaps/2-1);
+        for(int i=0; i<numFrames; i++)
+        {
+            output[i*2] = upEven[i];
+            output[i*2+1] = delayed[i];
+        }
+
+        memmove(history, history+numFrames, historyLength*sizeof(float));
+    }
+
+    //2*numFrames frames from input become numFrames frames in output
+    void downsample(const float* input, float* output, int channel, int numFrames)
+    {
+        jassert(numFrames<=maxInputFrames);
+        float* even = downEven+channel*(historyLength+maxInputFrames);
+        float* odd = downOdd+channel*(historyLength+maxInputFrames);
+        for(int i=0; i<numFrames; i++)
+        {
+            even[historyLength+i] = input[i*2];
+            odd[historyLength+i] = input[i*2+1];
+        }
+
+        FloatVectorOperations::clear(downSum, numFrames);
+        for(int k=0; k<numTaps; k++)
+            FloatVectorOperations::addWithMultiply(downSum, even+historyLength-k, taps[k], numFrames);
+        FloatVectorOperations::addWithMultiply(downSum, odd+historyLength-numTaps/2, 0.5f, numFrames);
+        FloatVectorOperations::copy(output, downSum, numFrames);
+
+        memmove(even, even+numFrames, historyLength*sizeof(float));
+        memmove(odd, odd+numFrames, historyLength*sizeof(float));
+    }
+
+private:
+    //zeroth order modified Bessel function of the first kind
+    static double kaiserBessel(double x)
+    {
+        double sum = 1, term = 1;
+        for(int k=1; k<32; k++)
+        {
+            term *= (x*0.5/k)*(x*0.5/k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    const int numTaps;
+    int numChannels, maxInputFrames, historyLength;
+    HeapBlock<float> taps, upHistory, upEven, downEven, downOdd, downSum;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageHalfBandStage);
+};
+
+//==============================================================================
+class CabbageOversampler
+{
+public:
+    //factor is 2, 4 or 8
+    CabbageOversampler(int factor) : numChannels(0), maxHostFrames(0)
+    {
+        for(int rate=2; rate<=jlimit(2, 8, factor); rate*=2)
+            stages.add(rate==2 ? new CabbageHalfBandStage(32, 8.f) : new CabbageHalfBandStage(12, 7.f));
+
+        //filter latency in samples at the top rate, rounded up to whole host samples
+        int latency = 0;
+        for(int i=0; i<stages.size(); i++)
+            latency += stages[i]->getRoundTripLatency()<<(stages.size()-1-i);
+        compensation = (getFactor()-latency%getFactor())%getFactor();
+        latencyInSamples = (latency+compensation)/getFactor();
+    }
+
+    ~CabbageOversampler() {}
+
+    static bool isValidFactor(int factor)
+    {
+        return factor==2 || factor==4 || factor==8;
+    }
+
+    int getFactor() const
+    {
+        return 1<<stages.size();
+    }
+
+    int getNumChannels() const
+    {
+        return numChannels;
+    }
+
+    //allocates for spans of up to maxFrames host frames. Not for the audio thread
+    void prepare(int channels, int maxFrames)
+    {
+        numChannels = channels;
+        maxHostFrames = maxFrames;
+        buffers.clear();
+        for(int i=0; i<=stages.size(); i++)
+        {
+            buffers.add(new AudioSampleBuffer(numChannels, maxHostFrames<<i));
+            buffers.getLast()->clear();
+        }
+        for(int i=0; i<stages.size(); i++)
+            stages[i]->prepare(numChannels, maxHostFrames<<i);
+
+        compensationDelay.setSize(numChannels, compensation+(maxHostFrames<<stages.size()));
+        compensationDelay.clear();
+    }
+
+    void reset()
+    {
+        for(int i=0; i<stages.size(); i++)
+            stages[i]->reset();
+        compensationDelay.clear();
+    }
+
+    //the delay an up and down pass adds, in host samples
+    int getLatencyInSamples() const
+    {
+        return latencyInSamples;
+    }
+
+    //======================== audio thread ===================================
+    //numFrames host frames, upsampled into getUpsampledChannels()
+    void upsample(const float* const* input, int inputOffset, int numFrames)
+    {
+        jassert(numFrames<=maxHostFrames);
+        for(int channel=0; channel<numChannels; channel++)
+        {
+            const float* source = input[channel]+inputOffset;
+            for(int i=0; i<stages.size(); i++)
+            {
+                float* dest = buffers[i+1]->getWritePointer(channel);
+                stages[i]->upsample(source, dest, channel, numFrames<<i);
+                source = dest;
+            }
+
+            if(compensation>0)
+            {
+                const int numUpsampled = numFrames<<stages.size();
+                float* delay = compensationDelay.getWritePointer(channel);
+                FloatVectorOperations::copy(delay+compensation, source, numUpsampled);
+                FloatVectorOperations::copy(buffers.getLast()->getWritePointer(channel), delay, numUpsampled);
+                memmove(delay, delay+numUpsampled, compensation*sizeof(float));
+            }
+        }
+    }
+
+    const float* const* getUpsampledChannels() const
+    {
+        return buffers.getLast()->getArrayOfReadPointers();
+    }
+
+    //fill these with numFrames*getFactor() frames before calling downsample()
+    float* const* getDownsamplerInput()
+    {
+        return buffers.getLast()->getArrayOfWritePointers();
+    }
+
+    //brings what was written to getDownsamplerInput() back down to numFrames host frames
+    void downsample(float* const* output, int outputOffset, int numFrames)
+    {
+        jassert(numFrames<=maxHostFrames);
+        for(int channel=0; channel<numChannels; channel++)
+        {
+            for(int i=stages.size()-1; i>=0; i--)
+            {
+                const float* source = buffers[i+1]->getReadPointer(channel);
+                float* dest = i>0 ? buffers[i]->getWritePointer(channel) : output[channel]+outputOffset;
+                stages[i]->downsample(source, dest, channel, numFrames<<i);
+            }
+        }
+    }
+
+private:
+    OwnedArray<CabbageHalfBandStage> stages;
+    OwnedArray<AudioSampleBuffer> buffers;      //one per rate, host rate first
+    AudioSampleBuffer compensationDelay;
+    int numChannels, maxHostFrames, compensation, latencyInSamples;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageOversampler);
+};
+
+#endif
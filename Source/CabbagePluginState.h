@@ -0,0 +1,166 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGEPLUGINSTATE_H
+#define CABBAGEPLUGINSTATE_H
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// The chunk a plugin instance hands its host. Laid out as:
+//
+//   int32   magic ('CbSt'), int32 version
+//   int64   hash of the .csd text that was running when the state was saved
+//   string  full path of that .csd
+//   int32   number of values, then per value: string channel, float value
+//   int32   number of strings, then per string: uint8 kind, string name, string value
+//
+// States saved by earlier versions are XML, and isBinaryState() tells the two
+// apart so that the processor can still read those.
+//==============================================================================
+class CabbagePluginState
+{
+public:
+    enum { currentVersion = 1 };
+
+    enum StringKind
+    {
+        fileButton = 0,     //name is the channel holding the last file opened
+        textEditor          //name is the widget's name
+    };
+
+    struct StringEntry
+    {
+        StringEntry() : kind(fileButton) {}
+        StringEntry(StringKind k, const String& n, const String& v) : kind(k), name(n), value(v) {}
+        StringKind kind;
+        String name, value;
+    };
+
+    CabbagePluginState() : csdHash(0) {}
+    ~CabbagePluginState() {}
+
+    static bool isBinaryState(const void* data, int sizeInBytes)
+    {
+        return sizeInBytes>=8 && ByteOrder::littleEndianInt(data)==magic;
+    }
+
+    void addValue(const String& channel, float value)
+    {
+        values.set(channel, value);
+    }
+
+    //returns false if the channel wasn't saved
+    bool getValue(const String& channel, float& value) const
+    {
+        if(!values.contains(channel))
+            return false;
+        value = values[channel];
+        return true;
+    }
+
+    void addString(StringKind kind, const String& name, const String& value)
+    {
+        strings.add(StringEntry(kind, name, value));
+    }
+
+    int getNumStrings() const
+    {
+        return strings.size();
+    }
+
+    const StringEntry& getString(int index) const
+    {
+        return strings.getReference(index);
+    }
+
+    void writeTo(MemoryBlock& destData) const
+    {
+        destData.reset();
+        MemoryOutputStream out(destData, false);
+        out.writeInt(magic);
+        out.writeInt(currentVersion);
+        out.writeInt64(csdHash);
+        out.writeString(csdPath);
+
+        out.writeInt(values.size());
+        for(HashMap<String, float>::Iterator i(values); i.next();)
+        {
+            out.writeString(i.getKey());
+            out.writeFloat(i.getValue());
+        }
+
+        out.writeInt(strings.size());
+        for(int i=0; i<strings.size(); i++)
+        {
+            out.writeByte((char)strings.getReference(i).kind);
+            out.writeString(strings.getReference(i).name);
+            out.writeString(strings.getReference(i).value);
+        }
+    }
+
+    //returns false if data isn't a state this version can read
+    bool readFrom(const void* data, int sizeInBytes)
+    {
+        if(!isBinaryState(data, sizeInBytes))
+            return false;
+
+        MemoryInputStream in(data, (size_t)sizeInBytes, false);
+        in.readInt();
+        if(in.readInt()>currentVersion)
+            return false;
+
+        csdHash = in.readInt64();
+        csdPath = in.readString();
+        if(in.isExhausted())
+            return false;
+
+        //a value takes at least 5 bytes, an empty name and a float
+        const int numValues = in.readInt();
+        if(numValues<0 || numValues>in.getNumBytesRemaining()/5)
+            return false;
+        for(int i=0; i<numValues; i++)
+        {
+            const String channel(in.readString());
+            values.set(channel, in.readFloat());
+        }
+
+        const int numStrings = in.readInt();
+        for(int i=0; i<numStrings && !in.isExhausted(); i++)
+        {
+            const StringKind kind = (StringKind)in.readByte();
+            const String name(in.readString());
+            strings.add(StringEntry(kind, name, in.readString()));
+        }
+        return true;
+    }
+
+    int64 csdHash;
+    String csdPath;
+
+private:
+    static const int magic = 0x74536243;    //'CbSt'
+
+    HashMap<String, float> values;
+    Array<StringEntry> strings;
+};
+
+#endif
@@ -0,0 +1,312 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGEPRESETBANK_H
+#define CABBAGEPRESETBANK_H
+
+#include "CabbageChannelBindings.h"
+#include "CabbageChannelSmoother.h"
+
+#ifndef Cabbage_No_Csound
+
+//==============================================================================
+// A bank of presets, kept in memory and saved together in one file. Each
+// preset holds a value per channel, keyed by channel name in the file. Once
+// mapToControls() has been told which channel each widget uses, the values
+// are also laid out per widget in one flat table, which is what the audio
+// thread uses.
+//
+// recall() asks for a preset to be applied on the next k-cycle, so switching
+// costs an index lookup and never touches the disk. process() also morphs
+// between presets: morphPosition runs from 0 to 1 across the morph presets
+// (every preset, in order, unless setMorphPresets() says otherwise) and each
+// widget's channel is set to the linear interpolation of its two neighbours.
+// The channels are only written when the position moves, so widgets stay
+// free to change while it rests. Widgets that use smooth(ms) are given the
+// preset's value as their smoother's target rather than having it written.
+//==============================================================================
+class CabbagePresetBank
+{
+public:
+    CabbagePresetBank() : numControls(0), pendingRecall(-1), lastMorphPosition(0) {}
+    ~CabbagePresetBank() {}
+
+    //====================== message thread ===================================
+    int getNumPresets() const
+    {
+        return presetNames.size();
+    }
+
+    String getPresetName(int index) const
+    {
+        return presetNames[index];
+    }
+
+    int indexOf(const String& name) const
+    {
+        return presetNames.indexOf(name);
+    }
+
+    //any thread, applied by the next call to process()
+    void recall(int index)
+    {
+        if(isPositiveAndBelow(index, presetNames.size()))
+            pendingRecall.set(index);
+    }
+
+    //the rest of these change what process() reads, so only call them while
+    //the audio thread is locked out
+
+    //adds a preset called name, or replaces the one that's already called that
+    void storePreset(const String& name, const StringArray& valueChannels, const Array<float>& values)
+    {
+        int index = presetNames.indexOf(name);
+        if(index<0)
+        {
+            index = presetNames.size();
+            presetNames.add(name);
+            presets.add(new Array<float>());
+            presets.getLast()->insertMultiple(0, missingValue(), channels.size());
+        }
+
+        Array<float>& preset = *presets[index];
+        for(int i=0; i<valueChannels.size(); i++)
+        {
+            if(valueChannels[i].isEmpty())
+                continue;
+            preset.set(getChannelIndex(valueChannels[i]), values[i]);
+        }
+
+        updateControlValues();
+    }
+
+    void clear()
+    {
+        presetNames.clear();
+        presets.clear();
+        channels.clear();
+        morphPresets.clear();
+        updateControlValues();
+    }
+
+    //the presets to morph between, in order. An empty list means all of them
+    void setMorphPresets(const Array<int>& presetIndexes)
+    {
+        morphPresets.clearQuick();
+        for(int i=0; i<presetIndexes.size(); i++)
+            if(isPositiveAndBelow(presetIndexes[i], presetNames.size()))
+                morphPresets.add(presetIndexes[i]);
+    }
+
+    //controlChannels holds each widget's channel, or an empty string for widgets
+    //that presets shouldn't touch. currentMorphPosition stops the first k-cycle
+    //from mistaking the channel's value for a move
+    void mapToControls(const StringArray& controlChannels, MYFLT currentMorphPosition)
+    {
+        mappedChannels = controlChannels;
+        lastMorphPosition = currentMorphPosition;
+        pendingRecall.set(-1);
+        updateControlValues();
+    }
+
+    //lays a bank read with loadFromFile() out for the same widgets as other,
+    //so that swapWith() can put it in place without allocating
+    void mapToControlsOf(const CabbagePresetBank& other)
+    {
+        mappedChannels = other.mappedChannels;
+        updateControlValues();
+    }
+
+    //exchanges the presets and their layout. A recall that hasn't been applied
+    //yet was meant for the old bank, so it's dropped
+    void swapWith(CabbagePresetBank& other) noexcept
+    {
+        channels.swapWith(other.channels);
+        presetNames.swapWith(other.presetNames);
+        presets.swapWith(other.presets);
+        morphPresets.swapWith(other.morphPresets);
+        mappedChannels.swapWith(other.mappedChannels);
+        controlValues.swapWith(other.controlValues);
+        std::swap(numControls, other.numControls);
+        pendingRecall.set(-1);
+    }
+
+    bool saveToFile(const File& file) const
+    {
+        MemoryBlock data;
+        MemoryOutputStream out(data, false);
+        out.writeInt(magic);
+        out.writeInt(currentVersion);
+        out.writeInt(channels.size());
+        for(int i=0; i<channels.size(); i++)
+            out.writeString(channels[i]);
+
+        out.writeInt(presets.size());
+        for(int i=0; i<presets.size(); i++)
+        {
+            out.writeString(presetNames[i]);
+            for(int y=0; y<channels.size(); y++)
+                out.writeFloat(presets[i]->getUnchecked(y));
+        }
+        out.flush();
+        return file.replaceWithData(data.getData(), data.getSize());
+    }
+
+    //replaces the bank with the file's contents, if it is a preset bank
+    bool loadFromFile(const File& file)
+    {
+        MemoryBlock data;
+        if(!file.loadFileAsData(data) || data.getSize()<8)
+            return false;
+
+        MemoryInputStream in(data, false);
+        if(in.readInt()!=magic || in.readInt()>currentVersion)
+            return false;
+
+        StringArray newChannels;
+        const int numChannels = in.readInt();
+        for(int i=0; i<numChannels && !in.isExhausted(); i++)
+            newChannels.add(in.readString());
+
+        StringArray newNames;
+        OwnedArray<Array<float> > newPresets;
+        const int numPresets = in.readInt();
+        for(int i=0; i<numPresets && !in.isExhausted(); i++)
+        {
+            newNames.add(in.readString());
+            Array<float>* preset = newPresets.add(new Array<float>());
+            for(int y=0; y<newChannels.size(); y++)
+                preset->add(in.readFloat());
+        }
+
+        channels.swapWith(newChannels);
+        presetNames.swapWith(newNames);
+        presets.swapWith(newPresets);
+        morphPresets.clear();
+        updateControlValues();
+        return true;
+    }
+
+    //======================== audio thread ===================================
+    //when a new instance takes over, so that its first k-cycle doesn't mistake
+    //the morph channel's value for a move
+    void setMorphPosition(MYFLT currentMorphPosition)
+    {
+        lastMorphPosition = currentMorphPosition;
+    }
+
+    //call before smoother.process(), which is what moves smoothed channels
+    void process(CabbageChannelBindings& bindings, CabbageChannelSmoother& smoother, MYFLT morphPosition)
+    {
+        const int controls = jmin(numControls, bindings.getNumControls());
+
+        const int recallIndex = pendingRecall.exchange(-1);
+        if(isPositiveAndBelow(recallIndex, presetNames.size()))
+            applyValues(bindings, smoother, controls, recallIndex, recallIndex, 0.f);
+
+        const int numMorphPresets = morphPresets.size()>0 ? morphPresets.size() : presetNames.size();
+        if(numMorphPresets<2 || morphPosition==lastMorphPosition)
+            return;
+
+        lastMorphPosition = morphPosition;
+        const float scaled = jlimit(0.f, 1.f, (float)morphPosition)*(numMorphPresets-1);
+        const int from = jmin((int)scaled, numMorphPresets-2);
+        if(morphPresets.size()>0)
+            applyValues(bindings, smoother, controls, morphPresets.getUnchecked(from), morphPresets.getUnchecked(from+1), scaled-from);
+        else
+            applyValues(bindings, smoother, controls, from, from+1, scaled-from);
+    }
+
+private:
+    enum { currentVersion = 1 };
+    static const int magic = 0x62506243;    //'CbPb'
+
+    //marks channels a preset has no value for
+    static float missingValue()
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    static bool isMissing(float value)
+    {
+        return value!=value;
+    }
+
+    int getChannelIndex(const String& channel)
+    {
+        const int index = channels.indexOf(channel);
+        if(index>=0)
+            return index;
+
+        channels.add(channel);
+        for(int i=0; i<presets.size(); i++)
+            presets[i]->add(missingValue());
+        return channels.size()-1;
+    }
+
+    //lays each preset out per widget for process()
+    void updateControlValues()
+    {
+        numControls = mappedChannels.size();
+        controlValues.malloc(jmax(1, presets.size()*numControls));
+        for(int i=0; i<presets.size(); i++)
+        {
+            for(int y=0; y<numControls; y++)
+            {
+                const int channel = mappedChannels[y].isEmpty() ? -1 : channels.indexOf(mappedChannels[y]);
+                controlValues[i*numControls+y] = channel<0 ? missingValue() : presets[i]->getUnchecked(channel);
+            }
+        }
+    }
+
+    void applyValues(CabbageChannelBindings& bindings, CabbageChannelSmoother& smoother, int controls, int from, int to, float proportion)
+    {
+        const float* fromValues = controlValues+from*numControls;
+        const float* toValues = controlValues+to*numControls;
+        for(int i=0; i<controls; i++)
+        {
+            MYFLT* channel = bindings.getControlChannel(i);
+            const float start = fromValues[i];
+            if(channel==nullptr || isMissing(start))
+                continue;
+
+            const float end = isMissing(toValues[i]) ? start : toValues[i];
+            const float value = start+(end-start)*proportion;
+            if(!smoother.setTarget(i, value))
+                *channel = value;
+        }
+    }
+
+    StringArray channels;                   //every channel a preset has a value for
+    StringArray presetNames;
+    OwnedArray<Array<float> > presets;      //values in channels order
+    StringArray mappedChannels;             //each widget's channel, see mapToControls()
+    HeapBlock<float> controlValues;         //numControls values per preset
+    int numControls;
+    Array<int> morphPresets;
+    Atomic<int> pendingRecall;
+    MYFLT lastMorphPosition;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbagePresetBank);
+};
+
+#endif
+#endif
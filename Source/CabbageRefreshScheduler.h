@@ -0,0 +1,117 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGEREFRESHSCHEDULER_H
+#define CABBAGEREFRESHSCHEDULER_H
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// Decides how many k-cycles the audio thread waits between GUI/identchannel
+// updates. Each processBlock() is timed against its deadline (the duration of
+// the audio it produces). When the block gets close to the deadline the
+// interval is stretched quickly, and when there is plenty of headroom it is
+// slowly pulled back in. However much headroom there is, updates never run
+// faster than maxRefreshHz, whatever the sample rate or ksmps.
+//==============================================================================
+class CabbageRefreshScheduler
+{
+public:
+    enum
+    {
+        maxRefreshHz = 60,      //hard cap on GUI updates per second
+        maxStretch = 16         //how far past the nominal interval we can back off
+    };
+
+    CabbageRefreshScheduler():
+        sampleRate(0),
+        ksmps(0),
+        nominalInterval(0),
+        minInterval(1),
+        maxInterval(1),
+        interval(1),
+        smoothedLoad(0),
+        startTicks(0),
+        cpuLoad(0.f)
+    {}
+
+    ~CabbageRefreshScheduler() {}
+
+    //call at the start of processBlock(). The limits are only recomputed when
+    //the sample rate, ksmps or the csd's nominal refresh interval change
+    void startBlock(double sr, int ksmpsSize, int nominalKCycles)
+    {
+        if(sr!=sampleRate || ksmpsSize!=ksmps || nominalKCycles!=nominalInterval)
+            prepare(sr, ksmpsSize, nominalKCycles);
+        startTicks = Time::getHighResolutionTicks();
+    }
+
+    //call at the end of processBlock() with the number of samples it produced
+    void endBlock(int numSamples)
+    {
+        if(numSamples<=0 || sampleRate<=0)
+            return;
+
+        const double elapsed = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-startTicks);
+        const double load = elapsed*sampleRate/numSamples;
+        smoothedLoad += (load-smoothedLoad)*0.1;
+        cpuLoad.set((float)smoothedLoad);
+
+        //back off fast when we're short of time, recover slowly
+        if(smoothedLoad>0.7)
+            interval = jmin(maxInterval, interval+interval/4+1);
+        else if(smoothedLoad<0.4)
+            interval = jmax(minInterval, interval-1);
+    }
+
+    //number of k-cycles to let pass between GUI updates
+    inline int getRefreshInterval() const
+    {
+        return interval;
+    }
+
+    //smoothed ratio of processing time to the block deadline; safe from any thread
+    float getLoad() const
+    {
+        return cpuLoad.get();
+    }
+
+private:
+    void prepare(double sr, int ksmpsSize, int nominalKCycles)
+    {
+        sampleRate = sr;
+        ksmps = jmax(1, ksmpsSize);
+        nominalInterval = nominalKCycles;
+        const double kr = sampleRate/ksmps;
+        minInterval = jmax(1, roundToInt(std::ceil(kr/maxRefreshHz)));
+        maxInterval = jmax(minInterval, nominalInterval)*maxStretch;
+        interval = jlimit(minInterval, maxInterval, nominalInterval);
+    }
+
+    double sampleRate;
+    int ksmps, nominalInterval;
+    int minInterval, maxInterval, interval;
+    double smoothedLoad;
+    int64 startTicks;
+    Atomic<float> cpuLoad;
+};
+
+#endif
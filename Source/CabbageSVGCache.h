@@ -0,0 +1,304 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+#ifndef CABBAGESVGCACHE_H
+#define CABBAGESVGCACHE_H
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+// Process-wide cache for the svg files widgets are skinned with. Sliders,
+// buttons and groupboxes keep the svg text in their properties, and their
+// look and feel used to parse it, build a Drawable and rasterise that into a
+// new image on every repaint. Here each svg is parsed once, keyed by a hash of
+// its text, and every image rendered from it is kept, keyed by the svg, the
+// image size and the transform it was drawn with, so a scale factor or
+// rotation is part of the key. Rendered images are dropped least recently
+// used first once they take up more than the memory budget. svg files are
+// read once per modification time, keyed by their path.
+//
+// Images are shared with the cache, so they can be drawn but not drawn into.
+// The single instance is created on first use and deleted at shutdown, see
+// CabbageLookAndFeel.cpp
+//==============================================================================
+class CabbageSVGCache : public DeletedAtShutdown
+{
+public:
+    enum
+    {
+        defaultMemoryBudget = 64*1024*1024,     //bytes of rendered images
+        maxParsedFiles = 128                    //parsed svgs and file contents
+    };
+
+    CabbageSVGCache()
+        : memoryBudget(defaultMemoryBudget),
+          memoryUsed(0),
+          oldest(nullptr),
+          newest(nullptr)
+    {}
+
+    ~CabbageSVGCache()
+    {
+        clear();
+        clearSingletonInstance();
+    }
+
+    juce_DeclareSingleton (CabbageSVGCache, false)
+
+    //the contents of an svg file. It is only read again once its modification
+    //time or size has changed
+    String getFileText(const File& file)
+    {
+        const ScopedLock sl(lock);
+        const String path = file.getFullPathName();
+        const Time modified = file.getLastModificationTime();
+        const int64 size = file.getSize();
+        for(int i=0; i<files.size(); i++)
+        {
+            if(files[i]->path==path)
+            {
+                if(files[i]->modified!=modified || files[i]->size!=size)
+                {
+                    files[i]->text = file.loadFileAsString();
+                    files[i]->modified = modified;
+                    files[i]->size = size;
+                }
+                return files[i]->text;
+            }
+        }
+
+        if(files.size()>=maxParsedFiles)
+            files.remove(0);
+        FileText* entry = files.add(new FileText());
+        entry->path = path;
+        entry->modified = modified;
+        entry->size = size;
+        entry->text = file.loadFileAsString();
+        return entry->text;
+    }
+
+    //the width and height attributes of the svg element, or 0 if missing
+    int getWidth(const String& svgText)
+    {
+        const ScopedLock sl(lock);
+        return getParsedSVG(svgText, svgText.hashCode64())->width;
+    }
+
+    int getHeight(const String& svgText)
+    {
+        const ScopedLock sl(lock);
+        return getParsedSVG(svgText, svgText.hashCode64())->height;
+    }
+
+    //svgText drawn into a transparent width by height image with the given
+    //transform. Returns a null image if the svg can't be parsed
+    Image getImage(const String& svgText, int width, int height, const AffineTransform& transform)
+    {
+        if(width<=0 || height<=0)
+            return Image::null;
+
+        const ScopedLock sl(lock);
+        const int64 svgHash = svgText.hashCode64();
+        const int64 key = getRenderingKey(svgHash, width, height, transform);
+        Rendering* rendering = renderings[key];
+        if(rendering!=nullptr && rendering->matches(svgHash, width, height, transform))
+        {
+            moveToNewest(rendering);
+            return rendering->image;
+        }
+
+        const ParsedSVG* svg = getParsedSVG(svgText, svgHash);
+        if(svg->drawable==nullptr)
+            return Image::null;
+
+        Image image(Image::ARGB, width, height, true);
+        {
+            Graphics graph(image);
+            svg->drawable->draw(graph, 1.f, transform);
+        }
+
+        if(rendering!=nullptr)
+            removeRendering(rendering);
+        rendering = new Rendering(key, svgHash, width, height, transform, image);
+        renderings.set(key, rendering);
+        addAsNewest(rendering);
+        memoryUsed += rendering->bytes;
+        while(memoryUsed>memoryBudget && oldest!=rendering)
+            removeRendering(oldest);
+
+        return image;
+    }
+
+    void setMemoryBudget(size_t bytes)
+    {
+        const ScopedLock sl(lock);
+        memoryBudget = bytes;
+        while(memoryUsed>memoryBudget && oldest!=nullptr)
+            removeRendering(oldest);
+    }
+
+    size_t getMemoryUsed() const
+    {
+        return memoryUsed;
+    }
+
+    int getNumRenderings() const
+    {
+        return renderings.size();
+    }
+
+    void clear()
+    {
+        const ScopedLock sl(lock);
+        while(oldest!=nullptr)
+            removeRendering(oldest);
+        parsedSVGs.clear();
+        files.clear();
+    }
+
+private:
+    struct FileText
+    {
+        String path, text;
+        Time modified;
+        int64 size;
+    };
+
+    struct ParsedSVG
+    {
+        int64 hash;
+        ScopedPointer<Drawable> drawable;
+        int width, height;
+    };
+
+    struct Rendering
+    {
+        Rendering(int64 k, int64 svg, int w, int h, const AffineTransform& t, const Image& img)
+            : key(k), svgHash(svg), width(w), height(h), transform(t), image(img),
+              bytes((size_t)w*(size_t)h*4), previous(nullptr), next(nullptr)
+        {}
+
+        bool matches(int64 svg, int w, int h, const AffineTransform& t) const
+        {
+            return svgHash==svg && width==w && height==h && transform==t;
+        }
+
+        int64 key, svgHash;
+        int width, height;
+        AffineTransform transform;
+        Image image;
+        size_t bytes;
+        Rendering* previous;
+        Rendering* next;
+    };
+
+    static int64 getRenderingKey(int64 svgHash, int width, int height, const AffineTransform& t)
+    {
+        const float values[] = {t.mat00, t.mat01, t.mat02, t.mat10, t.mat11, t.mat12};
+        uint64 key = (uint64)svgHash*31 + (uint64)width*1000003 + (uint64)height;
+        for(int i=0; i<numElementsInArray(values); i++)
+        {
+            uint32 bits;
+            memcpy(&bits, &values[i], sizeof(bits));
+            key = key*1000003 ^ bits;
+        }
+        return (int64)(key ^ (key>>32));
+    }
+
+    //parses svgText unless it was parsed before. Svgs that don't parse are kept
+    //too, with no drawable, so they aren't parsed again on each repaint
+    ParsedSVG* getParsedSVG(const String& svgText, int64 hash)
+    {
+        for(int i=parsedSVGs.size(); --i>=0;)
+        {
+            if(parsedSVGs[i]->hash==hash)
+            {
+                parsedSVGs.move(i, parsedSVGs.size()-1);
+                return parsedSVGs.getLast();
+            }
+        }
+
+        if(parsedSVGs.size()>=maxParsedFiles)
+            parsedSVGs.remove(0);
+        ParsedSVG* parsed = parsedSVGs.add(new ParsedSVG());
+        parsed->hash = hash;
+        parsed->width = parsed->height = 0;
+        ScopedPointer<XmlElement> svg(XmlDocument::parse(svgText));
+        if(svg!=nullptr)
+        {
+            parsed->width = svg->getIntAttribute("width");
+            parsed->height = svg->getIntAttribute("height");
+            parsed->drawable = Drawable::createFromSVG(*svg);
+        }
+        return parsed;
+    }
+
+    void addAsNewest(Rendering* rendering)
+    {
+        rendering->previous = newest;
+        rendering->next = nullptr;
+        if(newest!=nullptr)
+            newest->next = rendering;
+        newest = rendering;
+        if(oldest==nullptr)
+            oldest = rendering;
+    }
+
+    void unlink(Rendering* rendering)
+    {
+        if(rendering->previous!=nullptr)
+            rendering->previous->next = rendering->next;
+        else
+            oldest = rendering->next;
+        if(rendering->next!=nullptr)
+            rendering->next->previous = rendering->previous;
+        else
+            newest = rendering->previous;
+    }
+
+    void moveToNewest(Rendering* rendering)
+    {
+        if(rendering!=newest)
+        {
+            unlink(rendering);
+            addAsNewest(rendering);
+        }
+    }
+
+    void removeRendering(Rendering* rendering)
+    {
+        unlink(rendering);
+        renderings.remove(rendering->key);
+        memoryUsed -= rendering->bytes;
+        delete rendering;
+    }
+
+    CriticalSection lock;
+    OwnedArray<FileText> files;
+    OwnedArray<ParsedSVG> parsedSVGs;
+    HashMap<int64, Rendering*> renderings;
+    size_t memoryBudget, memoryUsed;
+    Rendering* oldest;
+    Rendering* newest;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageSVGCache);
+};
+
+#endif
@@ -0,0 +1,277 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+
+#ifndef CABBAGETABLEMIRROR_H
+#define CABBAGETABLEMIRROR_H
+
+#include "CabbageUtils.h"
+
+//==============================================================================
+// Read-only view of a Csound function table as last published by
+// CabbageTableMirror. data stays valid until the table changes twice, and
+// version only moves when the contents do.
+//==============================================================================
+struct CabbageTableSnapshot
+{
+    const float* data;
+    int size;
+    uint32 version;
+};
+
+#ifndef Cabbage_No_Csound
+#include "csound.hpp"
+
+//==============================================================================
+// Keeps a float copy of each function table the GUI displays. update() looks
+// at the table in place through csoundGetTable() and only copies it when its
+// size, storage or contents have changed since the last call. Each copy goes
+// into the table's spare buffer, which is then published, so a snapshot
+// handed out by the previous call is never overwritten by the next one.
+// Only call this from the message thread.
+//
+// Tables are only compared in full after markTablesWritten(). Otherwise an
+// update checks a few points spread over the table plus one slice of it,
+// moving on to the next slice each time, so a change Cabbage didn't make
+// itself, from tablew say, is still picked up within a few refreshes.
+//==============================================================================
+class CabbageTableMirror
+{
+public:
+    enum
+    {
+        sampledPoints = 32,             //spread over the table, checked on every update
+        sliceLength = 256               //checked in turn after those
+    };
+
+    CabbageTableMirror() {}
+    ~CabbageTableMirror() {}
+
+    //any thread. Call this whenever something is known to have written to the
+    //tables, and each one is compared in full on its next update
+    void markTablesWritten()
+    {
+        ++writeCount;
+    }
+
+    //returns the latest snapshot of tableNum, or nullptr if Csound has no such table
+    const CabbageTableSnapshot* update(Csound* csound, int tableNum)
+    {
+        MYFLT* source = nullptr;
+        const int size = csound->GetTable(source, tableNum);
+        if(size<0 || source==nullptr)
+            return nullptr;
+
+        MirroredTable* table = tables[tableNum];
+        if(table==nullptr)
+        {
+            table = mirroredTables.add(new MirroredTable());
+            tables.set(tableNum, table);
+        }
+
+        const int writes = writeCount.get();
+        if(source!=table->source || size!=table->snapshot.size
+                || !(table->writeCount==writes ? table->matchesSampled(source) : table->matches(source)))
+            table->publish(source, size);
+        table->writeCount = writes;
+
+        return &table->snapshot;
+    }
+
+    void clear()
+    {
+        tables.clear();
+        mirroredTables.clear();
+    }
+
+private:
+    struct MirroredTable
+    {
+        MirroredTable(): source(nullptr), active(0), nextSlice(0), writeCount(0)
+        {
+            capacity[0] = capacity[1] = 0;
+            snapshot.data = nullptr;
+            snapshot.size = 0;
+            snapshot.version = 0;
+        }
+
+        bool matches(const MYFLT* src) const
+        {
+            for(int i=0; i<snapshot.size; i++)
+                if((float)src[i]!=snapshot.data[i])
+                    return false;
+            return true;
+        }
+
+        bool matchesSampled(const MYFLT* src)
+        {
+            const int size = snapshot.size;
+            const int step = jmax(1, size/sampledPoints);
+            for(int i=0; i<size; i+=step)
+                if((float)src[i]!=snapshot.data[i])
+                    return false;
+
+            const int end = jmin(size, nextSlice+sliceLength);
+            for(int i=nextSlice; i<end; i++)
+                if((float)src[i]!=snapshot.data[i])
+                    return false;
+            nextSlice = end<size ? end : 0;
+            return true;
+        }
+
+        void publish(const MYFLT* src, int size)
+        {
+            const int back = 1-active;
+            if(capacity[back]<size)
+            {
+                buffers[back].malloc(size);
+                capacity[back] = size;
+            }
+
+            for(int i=0; i<size; i++)
+                buffers[back][i] = (float)src[i];
+
+            active = back;
+            source = src;
+            snapshot.data = buffers[back];
+            snapshot.size = size;
+            ++snapshot.version;
+            nextSlice = 0;
+        }
+
+        HeapBlock<float> buffers[2];
+        int capacity[2];
+        const MYFLT* source;
+        int active;
+        int nextSlice;                  //where matchesSampled() looks next
+        int writeCount;                 //as of the last update
+        CabbageTableSnapshot snapshot;
+    };
+
+    HashMap<int, MirroredTable*> tables;
+    OwnedArray<MirroredTable> mirroredTables;
+    Atomic<int> writeCount;
+};
+
+//==============================================================================
+// Carries edited table contents from the GUI to Csound. The message thread
+// computes a table straight into a staging buffer from getStagingBuffer() and
+// then calls post(). The audio thread copies everything that was posted into
+// the live tables with csoundTableCopyIn() between k-cycles. A table can only
+// be staged again once its last update has been committed.
+//==============================================================================
+class CabbageTableUpdateMailbox
+{
+public:
+    enum
+    {
+        maxTables = 64
+    };
+
+    CabbageTableUpdateMailbox(): numEntries(0) {}
+    ~CabbageTableUpdateMailbox() {}
+
+    //message thread only. Returns nullptr if the table's last update is still
+    //waiting to be committed, or if too many different tables are being edited
+    MYFLT* getStagingBuffer(int tableNum, int size)
+    {
+        Entry* entry = findEntry(tableNum);
+        if(entry==nullptr || entry->ready.get()!=0)
+            return nullptr;
+
+        if(entry->capacity<size)
+        {
+            entry->data.malloc(size);
+            entry->capacity = size;
+        }
+        entry->size = size;
+        return entry->data;
+    }
+
+    //message thread only, call once the staging buffer has been filled
+    void post(int tableNum)
+    {
+        if(Entry* entry = findEntry(tableNum))
+            entry->ready.set(1);
+    }
+
+    //audio thread only, between calls to PerformKsmps(). Returns true if any
+    //table was written
+    bool commit(Csound* csound)
+    {
+        bool written = false;
+        const int n = numEntries.get();
+        for(int i=0; i<n; i++)
+        {
+            Entry& entry = entries[i];
+            if(entry.ready.get()!=0)
+            {
+                //the table may have been replaced by a different size since it was staged
+                if(csound->TableLength(entry.tableNumber)==entry.size)
+                {
+                    csound->TableCopyIn(entry.tableNumber, entry.data);
+                    //TableCopyIn() stops short of the guard point, which wrapping
+                    //opcodes like oscili interpolate against, so it follows point 0
+                    MYFLT* table = nullptr;
+                    if(csound->GetTable(&table, entry.tableNumber)==entry.size && table!=nullptr && entry.size>0)
+                        table[entry.size] = table[0];
+                    written = true;
+                }
+                entry.ready.set(0);
+            }
+        }
+        return written;
+    }
+
+private:
+    struct Entry
+    {
+        Entry(): tableNumber(0), size(0), capacity(0), ready(0) {}
+
+        int tableNumber;
+        HeapBlock<MYFLT> data;
+        int size, capacity;
+        Atomic<int> ready;
+    };
+
+    Entry* findEntry(int tableNum)
+    {
+        const int n = numEntries.get();
+        for(int i=0; i<n; i++)
+            if(entries[i].tableNumber==tableNum)
+                return &entries[i];
+
+        if(n==maxTables)
+            return nullptr;
+
+        //the audio thread only looks at entries below numEntries, so this one is ours until then
+        entries[n].tableNumber = tableNum;
+        numEntries.set(n+1);
+        return &entries[n];
+    }
+
+    Entry entries[maxTables];
+    Atomic<int> numEntries;
+
+    JUCE_DECLARE_NON_COPYABLE(CabbageTableUpdateMailbox)
+};
+
+#endif
+#endif
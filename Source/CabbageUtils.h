@@ -24,6 +24,7 @@
 #include <time.h>
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "CabbageSVGCache.h"
 
 #ifndef Cabbage_Plugin_Host
 #include "BinaryData.h"
@@ -125,6 +126,127 @@ public:
     cUtils() {};
     ~cUtils() {};
 
+//===========================================================================================
+//copies and scales one contiguous run of samples. When Csound is built with floats this
+//is a single vector op, otherwise the conversion and scaling happen in the same pass
+//===========================================================================================
+    static void copyScaled(float* dest, const float* src, int numSamples, float scale)
+    {
+        FloatVectorOperations::copyWithMultiply(dest, src, scale, numSamples);
+    }
+
+    template <typename DestType, typename SourceType, typename ScaleType>
+    static void copyScaled(DestType* dest, const SourceType* src, int numSamples, ScaleType scale)
+    {
+        for(int i=0; i<numSamples; i++)
+            dest[i] = DestType(src[i]*scale);
+    }
+
+//===========================================================================================
+//copies numFrames from each host channel into an interleaved Csound buffer and scales
+//them by 0dbfs on the way in, so each sample is written once. Mono is a single vector op.
+//Wider layouts go four channels at a time, so each frame gets a run of four adjacent
+//samples rather than every channel taking its own strided pass over the whole span
+//===========================================================================================
+    template <typename SampleType>
+    static void interleaveSamples(SampleType* dest, const float* const* src, int srcOffset,
+                                  int numChannels, int numFrames, SampleType scale)
+    {
+        if(numChannels==1)
+        {
+            copyScaled(dest, src[0]+srcOffset, numFrames, scale);
+            return;
+        }
+
+        if(numChannels==2)
+        {
+            const float* left = src[0]+srcOffset;
+            const float* right = src[1]+srcOffset;
+            for(int i=0; i<numFrames; i++)
+            {
+                dest[i*2] = left[i]*scale;
+                dest[i*2+1] = right[i]*scale;
+            }
+            return;
+        }
+
+        int channel = 0;
+        for(; channel+4<=numChannels; channel+=4)
+        {
+            const float* in0 = src[channel]+srcOffset;
+            const float* in1 = src[channel+1]+srcOffset;
+            const float* in2 = src[channel+2]+srcOffset;
+            const float* in3 = src[channel+3]+srcOffset;
+            SampleType* out = dest+channel;
+            for(int i=0; i<numFrames; i++, out+=numChannels)
+            {
+                out[0] = in0[i]*scale;
+                out[1] = in1[i]*scale;
+                out[2] = in2[i]*scale;
+                out[3] = in3[i]*scale;
+            }
+        }
+
+        for(; channel<numChannels; channel++)
+        {
+            const float* in = src[channel]+srcOffset;
+            SampleType* out = dest+channel;
+            for(int i=0; i<numFrames; i++)
+                out[i*numChannels] = in[i]*scale;
+        }
+    }
+
+//===========================================================================================
+//the reverse of interleaveSamples(), also scaling as it goes
+//===========================================================================================
+    template <typename SampleType>
+    static void deinterleaveSamples(float* const* dest, int destOffset, const SampleType* src,
+                                    int numChannels, int numFrames, float scale)
+    {
+        if(numChannels==1)
+        {
+            copyScaled(dest[0]+destOffset, src, numFrames, scale);
+            return;
+        }
+
+        if(numChannels==2)
+        {
+            float* left = dest[0]+destOffset;
+            float* right = dest[1]+destOffset;
+            for(int i=0; i<numFrames; i++)
+            {
+                left[i] = float(src[i*2]*scale);
+                right[i] = float(src[i*2+1]*scale);
+            }
+            return;
+        }
+
+        int channel = 0;
+        for(; channel+4<=numChannels; channel+=4)
+        {
+            float* out0 = dest[channel]+destOffset;
+            float* out1 = dest[channel+1]+destOffset;
+            float* out2 = dest[channel+2]+destOffset;
+            float* out3 = dest[channel+3]+destOffset;
+            const SampleType* in = src+channel;
+            for(int i=0; i<numFrames; i++, in+=numChannels)
+            {
+                out0[i] = float(in[0]*scale);
+                out1[i] = float(in[1]*scale);
+                out2[i] = float(in[2]*scale);
+                out3[i] = float(in[3]*scale);
+            }
+        }
+
+        for(; channel<numChannels; channel++)
+        {
+            float* out = dest[channel]+destOffset;
+            const SampleType* in = src+channel;
+            for(int i=0; i<numFrames; i++)
+                out[i] = float(in[i*numChannels]*scale);
+        }
+    }
+
 
 //===========================================================================================
     string juce2Str(juce::String inStr)
@@ -543,6 +665,35 @@ public:
         return sr/64.f;
     }
 
+    //the first argument of one of the form's identifiers, for settings that have to
+    //be known before the file is compiled and so can't wait for the parser
+    static int getFormIdentifierFromFile(const String& csdText, const String& identifier, int defaultValue)
+    {
+        StringArray array;
+        array.addLines(csdText.fromFirstOccurrenceOf("<Cabbage>", false, false)
+                       .upToFirstOccurrenceOf("</Cabbage>", false, false));
+
+        for(int i=0; i<array.size(); i++)
+        {
+            const String line = array[i].trimStart();
+            if(!line.startsWith("form ") || !line.contains(identifier+"("))
+                continue;
+
+            return line.fromFirstOccurrenceOf(identifier+"(", false, false)
+                   .upToFirstOccurrenceOf(")", false, false).upToFirstOccurrenceOf(",", false, false)
+                   .trim().getIntValue();
+        }
+
+        return defaultValue;
+    }
+
+    //the factor given to oversample(), or 1 if there isn't one
+    static int getOversamplingFromFile(const String& csdText)
+    {
+        const int factor = getFormIdentifierFromFile(csdText, "oversample", 1);
+        return (factor==2 || factor==4 || factor==8) ? factor : 1;
+    }
+
     static int getNumberOfDecimalPlaces(StringArray array)
     {
         int longest=0;
@@ -867,24 +1018,18 @@ public:
 //====================================================================================
     static int getSVGWidth(String svgContents)
     {
-        ScopedPointer<XmlElement> svg (XmlDocument::parse(svgContents));
-        for(int i=0; i<svg->getNumAttributes(); i++)
-        {
-            if(svg->getAttributeName(i)=="width")
-                return svg->getAttributeValue(i).getIntValue();
-        }
-        return 0;
+        return CabbageSVGCache::getInstance()->getWidth(svgContents);
     }
 
     static int getSVGHeight(String svgContents)
     {
-        ScopedPointer<XmlElement> svg (XmlDocument::parse(svgContents));
-        for(int i=0; i<svg->getNumAttributes(); i++)
-        {
-            if(svg->getAttributeName(i)=="height")
-                return svg->getAttributeValue(i).getIntValue();
-        }
-        return 0;
+        return CabbageSVGCache::getInstance()->getHeight(svgContents);
+    }
+
+    //svg files are only read from disk again if they have changed
+    static String loadSVGFile(File svgFile)
+    {
+        return CabbageSVGCache::getInstance()->getFileText(svgFile);
     }
 
 //============================================================================
@@ -894,9 +1039,9 @@ public:
         {
             if(svgFile.existsAsFile())
             {
-                comp.getProperties().set("svggroupbox", svgFile.loadFileAsString());
-                comp.getProperties().set("svggroupboxheight", cUtils::getSVGHeight(svgFile.loadFileAsString()));
-                comp.getProperties().set("svggroupboxwidth", cUtils::getSVGWidth(svgFile.loadFileAsString()));
+                comp.getProperties().set("svggroupbox", loadSVGFile(svgFile));
+                comp.getProperties().set("svggroupboxheight", cUtils::getSVGHeight(loadSVGFile(svgFile)));
+                comp.getProperties().set("svggroupboxwidth", cUtils::getSVGWidth(loadSVGFile(svgFile)));
             }
             else if(svgPath.exists())
             {
@@ -904,9 +1049,9 @@ public:
                 cUtils::debug(filename.getFullPathName());
                 if(filename.existsAsFile())
                 {
-                    comp.getProperties().set("svggroupbox", filename.loadFileAsString());
-                    comp.getProperties().set("svggroupboxheight", cUtils::getSVGHeight(filename.loadFileAsString()));
-                    comp.getProperties().set("svggroupboxwidth", cUtils::getSVGWidth(filename.loadFileAsString()));
+                    comp.getProperties().set("svggroupbox", loadSVGFile(filename));
+                    comp.getProperties().set("svggroupboxheight", cUtils::getSVGHeight(loadSVGFile(filename)));
+                    comp.getProperties().set("svggroupboxwidth", cUtils::getSVGWidth(loadSVGFile(filename)));
                 }
             }
         }
@@ -914,9 +1059,9 @@ public:
         {
             if(svgFile.existsAsFile())
             {
-                comp.getProperties().set("svgbuttonon", svgFile.loadFileAsString());
-                comp.getProperties().set("svgbuttonheight", cUtils::getSVGHeight(svgFile.loadFileAsString()));
-                comp.getProperties().set("svgbuttonwidth", cUtils::getSVGWidth(svgFile.loadFileAsString()));
+                comp.getProperties().set("svgbuttonon", loadSVGFile(svgFile));
+                comp.getProperties().set("svgbuttonheight", cUtils::getSVGHeight(loadSVGFile(svgFile)));
+                comp.getProperties().set("svgbuttonwidth", cUtils::getSVGWidth(loadSVGFile(svgFile)));
             }
             else if(svgPath.exists())
             {
@@ -924,9 +1069,9 @@ public:
                 cUtils::debug(filename.getFullPathName());
                 if(filename.existsAsFile())
                 {
-                    comp.getProperties().set("svgbuttonon", filename.loadFileAsString());
-                    comp.getProperties().set("svgbuttonheight", cUtils::getSVGHeight(filename.loadFileAsString()));
-                    comp.getProperties().set("svgbuttonwidth", cUtils::getSVGWidth(filename.loadFileAsString()));
+                    comp.getProperties().set("svgbuttonon", loadSVGFile(filename));
+                    comp.getProperties().set("svgbuttonheight", cUtils::getSVGHeight(loadSVGFile(filename)));
+                    comp.getProperties().set("svgbuttonwidth", cUtils::getSVGWidth(loadSVGFile(filename)));
                 }
             }
         }
@@ -934,11 +1079,11 @@ public:
         {
             if(svgFile.existsAsFile())
             {
-                comp.getProperties().set("svgbuttonoff", svgFile.loadFileAsString());
-                cUtils::debug(svgFile.loadFileAsString());
-                comp.getProperties().set("svgbuttonheight", cUtils::getSVGHeight(svgFile.loadFileAsString()));
-                cUtils::debug(cUtils::getSVGHeight(svgFile.loadFileAsString()));
-                comp.getProperties().set("svgbuttonwidth", cUtils::getSVGWidth(svgFile.loadFileAsString()));
+                comp.getProperties().set("svgbuttonoff", loadSVGFile(svgFile));
+                cUtils::debug(loadSVGFile(svgFile));
+                comp.getProperties().set("svgbuttonheight", cUtils::getSVGHeight(loadSVGFile(svgFile)));
+                cUtils::debug(cUtils::getSVGHeight(loadSVGFile(svgFile)));
+                comp.getProperties().set("svgbuttonwidth", cUtils::getSVGWidth(loadSVGFile(svgFile)));
             }
             else if(svgPath.exists())
             {
@@ -946,10 +1091,10 @@ public:
                 cUtils::debug(filename.getFullPathName());
                 if(filename.existsAsFile())
                 {
-                    comp.getProperties().set("svgbuttonoff", filename.loadFileAsString());
-                    cUtils::debug(cUtils::getSVGHeight(filename.loadFileAsString()));
-                    comp.getProperties().set("svgbuttonheight", cUtils::getSVGHeight(filename.loadFileAsString()));
-                    comp.getProperties().set("svgbuttonwidth", cUtils::getSVGWidth(filename.loadFileAsString()));
+                    comp.getProperties().set("svgbuttonoff", loadSVGFile(filename));
+                    cUtils::debug(cUtils::getSVGHeight(loadSVGFile(filename)));
+                    comp.getProperties().set("svgbuttonheight", cUtils::getSVGHeight(loadSVGFile(filename)));
+                    comp.getProperties().set("svgbuttonwidth", cUtils::getSVGWidth(loadSVGFile(filename)));
                 }
             }
         }
@@ -957,10 +1102,10 @@ public:
         {
             if(svgFile.existsAsFile())
             {
-                comp.getProperties().set("svgsliderbg", svgFile.loadFileAsString());
-                comp.getProperties().set("svgsliderbgheight", cUtils::getSVGHeight(svgFile.loadFileAsString()));
-                cUtils::debug(cUtils::getSVGHeight(svgFile.loadFileAsString()));
-                comp.getProperties().set("svgsliderbgwidth", cUtils::getSVGWidth(svgFile.loadFileAsString()));
+                comp.getProperties().set("svgsliderbg", loadSVGFile(svgFile));
+                comp.getProperties().set("svgsliderbgheight", cUtils::getSVGHeight(loadSVGFile(svgFile)));
+                cUtils::debug(cUtils::getSVGHeight(loadSVGFile(svgFile)));
+                comp.getProperties().set("svgsliderbgwidth", cUtils::getSVGWidth(loadSVGFile(svgFile)));
             }
             else if(svgPath.exists())
             {
@@ -974,10 +1119,10 @@ public:
 
                 if(filename.existsAsFile())
                 {
-                    comp.getProperties().set("svgsliderbg", filename.loadFileAsString());
-                    cUtils::debug(cUtils::getSVGHeight(filename.loadFileAsString()));
-                    comp.getProperties().set("svgsliderbgheight", cUtils::getSVGHeight(filename.loadFileAsString()));
-                    comp.getProperties().set("svgsliderbgwidth", cUtils::getSVGWidth(filename.loadFileAsString()));
+                    comp.getProperties().set("svgsliderbg", loadSVGFile(filename));
+                    cUtils::debug(cUtils::getSVGHeight(loadSVGFile(filename)));
+                    comp.getProperties().set("svgsliderbgheight", cUtils::getSVGHeight(loadSVGFile(filename)));
+                    comp.getProperties().set("svgsliderbgwidth", cUtils::getSVGWidth(loadSVGFile(filename)));
                 }
             }
         }
@@ -985,10 +1130,10 @@ public:
         {
             if(svgFile.existsAsFile())
             {
-                comp.getProperties().set("svgslider", svgFile.loadFileAsString());
-                comp.getProperties().set("svgsliderheight", cUtils::getSVGHeight(svgFile.loadFileAsString()));
-                cUtils::debug(cUtils::getSVGHeight(svgFile.loadFileAsString()));
-                comp.getProperties().set("svgsliderwidth", cUtils::getSVGWidth(svgFile.loadFileAsString()));
+                comp.getProperties().set("svgslider", loadSVGFile(svgFile));
+                comp.getProperties().set("svgsliderheight", cUtils::getSVGHeight(loadSVGFile(svgFile)));
+                cUtils::debug(cUtils::getSVGHeight(loadSVGFile(svgFile)));
+                comp.getProperties().set("svgsliderwidth", cUtils::getSVGWidth(loadSVGFile(svgFile)));
             }
             else if(svgPath.exists())
             {
@@ -1003,34 +1148,45 @@ public:
                 //cUtils::debug(filename.getFullPathName());
                 if(filename.existsAsFile())
                 {
-                    comp.getProperties().set("svgslider", filename.loadFileAsString());
-                    cUtils::debug(cUtils::getSVGHeight(filename.loadFileAsString()));
-                    comp.getProperties().set("svgsliderheight", cUtils::getSVGHeight(filename.loadFileAsString()));
-                    comp.getProperties().set("svgsliderwidth", cUtils::getSVGWidth(filename.loadFileAsString()));
+                    comp.getProperties().set("svgslider", loadSVGFile(filename));
+                    cUtils::debug(cUtils::getSVGHeight(loadSVGFile(filename)));
+                    comp.getProperties().set("svgsliderheight", cUtils::getSVGHeight(loadSVGFile(filename)));
+                    comp.getProperties().set("svgsliderwidth", cUtils::getSVGWidth(loadSVGFile(filename)));
                 }
             }
         }
 
     }
 
+    //the image is shared with CabbageSVGCache, so it must not be drawn into
     static Image drawFromSVG(String svgString, int width, int height, AffineTransform affine)
     {
-        Image svgImg;
-        svgImg = Image(Image::ARGB, width, height, true);
-        ScopedPointer<XmlElement> svg (XmlDocument::parse(svgString));
-        if(svg == nullptr)
-            return Image::null;
+        return CabbageSVGCache::getInstance()->getImage(svgString, width, height, affine);
+    }
+
+    //draws a width by height svg into bounds, turned by angle about the centre
+    //of an svgRSliderDiameter square. It is rendered once, unrotated, at the
+    //size it takes up on screen, and turned as it's drawn
+    static void drawRotatedSVG(Graphics& g, const String& svgString, int width, int height,
+                               const Rectangle<float>& bounds, float angle)
+    {
+        if(width<=0 || height<=0)
+            return;
 
-        ScopedPointer<Drawable> drawable;
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const int imageWidth = jmax(1, roundToInt(bounds.getWidth()*scale));
+        const int imageHeight = jmax(1, roundToInt(bounds.getHeight()*scale));
+        const float svgScaleX = imageWidth/(float)width;
+        const float svgScaleY = imageHeight/(float)height;
+        const Image image = drawFromSVG(svgString, imageWidth, imageHeight, AffineTransform::scale(svgScaleX, svgScaleY));
+        if(image.isNull())
+            return;
 
-        Graphics graph(svgImg);
-        if (svg != nullptr)
-        {
-            drawable = Drawable::createFromSVG (*svg);
-            drawable->draw(graph, 1.f, affine);
-            return svgImg;
-        }
-        return Image::null;
+        Graphics::ScopedSaveState state(g);
+        g.reduceClipRegion(bounds.getSmallestIntegerContainer());
+        g.drawImageTransformed(image, AffineTransform::rotation(angle, svgRSliderDiameter/2.f*svgScaleX, svgRSliderDiameter/2.f*svgScaleY)
+                               .scaled(bounds.getWidth()/imageWidth, bounds.getHeight()/imageHeight)
+                               .translated(bounds.getX(), bounds.getY()));
     }
 
 
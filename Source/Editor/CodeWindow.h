@@ -42,6 +42,7 @@ public:
         textEditor->setColour(TextEditor::backgroundColourId, cUtils::getDarkerBackgroundSkin());
         textEditor->setColour(TextEditor::textColourId, Colours::cornflowerblue);
         textEditor->setMultiLine(true);
+        textEditor->setReadOnly(true);
         textEditor->setFont(Font("Arial", 18, 0));
         addAndMakeVisible(textEditor, true);
         setText("");
@@ -53,8 +54,14 @@ public:
     void setText(String text)
     {
         //textEditor->setColour(TextEditor::textColourId, Colours::cornflowerblue.brighter());
+        textEditor->setText(text, false);
+        textEditor->moveCaretToEnd();
+    }
+
+    void appendText(String text)
+    {
+        textEditor->moveCaretToEnd();
         textEditor->insertTextAtCaret(text);
-        textEditor->setCaretPosition(textEditor->getText().length());
     }
 
     String getText()
@@ -20,9 +20,6 @@ AudioFilePlaybackProcessor::AudioFilePlaybackProcessor():
     shouldLoop(false),
     isLinkedToMasterTransport(false),
     sourceSampleRate(44100),
-    rmsLeft(0),
-    rmsRight(0),
-    updateCounter(0),
     beatOffset(0),
     gain(.5f),
     pan(.5f),
@@ -72,6 +69,8 @@ void AudioFilePlaybackProcessor::prepareToPlay (double sampleRate, int samplesPe
 
     if(bufferingAudioFileSource)
         bufferingAudioFileSource->prepareToPlay(samplesPerBlock, sampleRate);
+
+    levelMeter.prepare(sampleRate);
 }
 //==============================================================================
 void AudioFilePlaybackProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
@@ -155,16 +154,7 @@ void AudioFilePlaybackProcessor::playSoundFile(AudioSampleBuffer& buffer, bool i
         }
 
 
-        rmsLeft = buffer.getRMSLevel(0, 0, buffer.getNumSamples());
-        rmsRight = buffer.getRMSLevel(1, 0, buffer.getNumSamples());
-
-
-        if(updateCounter==0)
-            sendActionMessage("rmsValues "+String(rmsLeft)+" "+String(rmsRight));
-
-        updateCounter++;
-        if(updateCounter>5)
-            updateCounter=0;
+        levelMeter.process(buffer, buffer.getNumSamples());
     }
 }
 //==============================================================================
@@ -12,6 +12,7 @@
 #define __AUDIOFILEPLUGINPROCESSOR_H_99BF5AFC__
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "../CabbageLevelMeter.h"
 
 
 //==============================================================================
@@ -101,6 +102,11 @@ public:
     bool producesMidi() const;
     void changeListenerCallback(ChangeBroadcaster* source);
 
+    const CabbageLevelMeter& getLevelMeter() const
+    {
+        return levelMeter;
+    }
+
     //==============================================================================
     int getNumPrograms();
     int getCurrentProgram();
@@ -167,10 +173,9 @@ private:
     AudioSampleBuffer* audioBuffer;
     int samplingRate;
     TimeSliceThread thread;
-    float rmsLeft, rmsRight;
+    CabbageLevelMeter levelMeter;
     int beatOffset;
     String currentFile;
-    int updateCounter;
     int numFileChannels;
     int totalLength;
     bool showGainEnv;
@@ -232,31 +232,30 @@ void AutomationProcessor::sendOutgoingMessagesToCsound()
             csound->SetChannel(CabbageIDs::timeSigDenom.toUTF8(), hostInfo.timeSigDenominator);
             csound->SetChannel(CabbageIDs::timeSigNum.toUTF8(), hostInfo.timeSigNumerator);
         }
-        for(int i=0; i<messageQueue.getNumberOfOutgoingChannelMessagesInQueue(); i++)
+        CabbageChannelMessage message;
+        while(messageQueue.getNextOutgoingChannelMessage(message))
         {
             //update Csound function tables with values from table widget
-            if(messageQueue.getOutgoingChannelMessageFromQueue(i).type=="updateTable")
+            if(message.type==CabbageChannelMessage::tableMessage)
             {
-                //Logger::writeToLog(messageQueue.getOutgoingChannelMessageFromQueue(i).fStatement.toUTF8());
-                const int tableNum = messageQueue.getOutgoingChannelMessageFromQueue(i).tableNumber;
+                const String& fStatement = messageQueue.getPayload(message);
                 //update table data for saving...
-                cUtils::debug("fstatement", messageQueue.getOutgoingChannelMessageFromQueue(i).fStatement);
-                updateAutomatableNodefStatement(tableNum, messageQueue.getOutgoingChannelMessageFromQueue(i).fStatement);
-                csound->InputMessage(messageQueue.getOutgoingChannelMessageFromQueue(i).fStatement.getCharPointer());
+                cUtils::debug("fstatement", fStatement);
+                updateAutomatableNodefStatement(message.tableNumber, fStatement);
+                csound->InputMessage(fStatement.getCharPointer());
             }
             //catch string messags
-            else if(messageQueue.getOutgoingChannelMessageFromQueue(i).type==CabbageIDs::stringchannel)
+            else if(message.type==CabbageChannelMessage::stringMessage)
             {
-                Logger::writeToLog(messageQueue.getOutgoingChannelMessageFromQueue(i).channelName);
-                Logger::writeToLog(messageQueue.getOutgoingChannelMessageFromQueue(i).stringVal);
-                csound->SetChannel(messageQueue.getOutgoingChannelMessageFromQueue(i).channelName.getCharPointer(),
-                                   messageQueue.getOutgoingChannelMessageFromQueue(i).stringVal.toUTF8().getAddress());
+                csound->SetChannel(messageQueue.getChannelName(message).getCharPointer(),
+                                   const_cast<char*>(messageQueue.getPayload(message).getCharPointer().getAddress()));
             }
             else
-                csound->SetChannel(messageQueue.getOutgoingChannelMessageFromQueue(i).channelName.getCharPointer(),
-                                   messageQueue.getOutgoingChannelMessageFromQueue(i).value);
+                csound->SetChannel(messageQueue.getChannelName(message).getCharPointer(),
+                                   message.value);
+
+            messageQueue.releaseOutgoingChannelMessage(message);
         }
-        messageQueue.flushOutgoingChannelMessages();
     }
 
     if(newTableAdded == true)
@@ -138,6 +138,7 @@ FilterComponent::FilterComponent (FilterGraph& graph_, const uint32 filterID_)
       font (13.0f, Font::bold),
 
       rmsRight(0),
+      levelMeter(nullptr),
       numIns (0),
       numOuts (0),
       isMuted(false),
@@ -261,6 +262,7 @@ void FilterComponent::mouseDown (const MouseEvent& e)
             {
                 File csdFile = nativeCabbagePlugin->getCsoundInputFile();
                 codeWindow = new CodeWindow(csdFile.getFileNameWithoutExtension());
+                consoleReader = CabbageConsoleBuffer::Reader();
                 codeWindow->addActionListener(this);
                 codeWindow->splitBottomWindow->SetSplitBarPosition(codeWindow->getWidth()/3);
                 codeWindow->textEditor->setShowTabButtons(false);
@@ -275,7 +277,8 @@ void FilterComponent::mouseDown (const MouseEvent& e)
                 CabbagePluginAudioProcessor* const processor = (CabbagePluginAudioProcessor*)graph.getNodeForId (filterID)->getProcessor();
                 processor->codeEditor = codeWindow->textEditor;
 
-                startTimer(100);
+                if(!isTimerRunning())
+                    startTimer(100);
             }
         }
         else if(r == 0)
@@ -443,19 +446,13 @@ void FilterComponent::changeListenerCallback(ChangeBroadcaster* source)
 //================================================================================
 void FilterComponent::actionListenerCallback (const String &message)
 {
-    if(message.contains("rmsValues"))
-    {
-        String newMessage = message.replace("rmsValues ", "");
-        rmsLeft = newMessage.substring(0, newMessage.indexOf(" ")).getFloatValue();
-        rmsRight = newMessage.substring(newMessage.indexOf(" ")+1).getFloatValue();
-        repaint(16, getHeight() - pinSize * 2, getWidth()-32.f, 20);
-    }
-    else if(message == "closing editor")
+    if(message == "closing editor")
     {
         enableEditMode(false);
         getGraphDocument()->disableWidetPropertiesInSidebarPanel();
         codeWindow = nullptr;
-        stopTimer();
+        if(levelMeter==nullptr)
+            stopTimer();
     }
     else if(message == "enableEditMode")
     {
@@ -492,7 +489,7 @@ void FilterComponent::actionListenerCallback (const String &message)
             {
 
                 instance->suspendProcessing(true);
-                instance->recompileCsound(file);
+                instance->recompileCsound(file, false);
                 instance->setPlayConfigDetails(newChannelCount,
                                                newChannelCount,
                                                instance->getCsoundSamplingRate(),
@@ -526,7 +523,8 @@ void FilterComponent::actionListenerCallback (const String &message)
         {
             enableEditMode(false);
             codeWindow = nullptr;
-            stopTimer();
+            if(levelMeter==nullptr)
+                stopTimer();
         }
 
     }
@@ -535,6 +533,8 @@ void FilterComponent::actionListenerCallback (const String &message)
 //================================================================================
 void FilterComponent::timerCallback()
 {
+    updateLevels();
+
     if(pluginType==CABBAGE)
     {
         CabbagePluginAudioProcessor* instance = (CabbagePluginAudioProcessor*)(graph.getNodeForId (filterID)->getProcessor());
@@ -542,18 +542,37 @@ void FilterComponent::timerCallback()
 
         if(codeWindow)
         {
-            if(codeWindow->csoundOutputComponent->getText()!=instance->getCsoundOutput())
-                codeWindow->csoundOutputComponent->setText(instance->getCsoundOutput());
+            String consoleText;
+            if(instance->readCsoundOutput(consoleReader, consoleText))
+            {
+                if(consoleText.isNotEmpty())
+                    codeWindow->csoundOutputComponent->appendText(consoleText);
+            }
+            else
+                codeWindow->csoundOutputComponent->setText(consoleText);
 
             if(codeWindow->csoundDebuggerComponent->getText()!=instance->getDebuggerOutput())
                 codeWindow->csoundDebuggerComponent->setText(instance->getDebuggerOutput());
-                
-            instance->clearDebugMessage();
         }
     }
 
 }
 //================================================================================
+void FilterComponent::updateLevels()
+{
+    if(levelMeter==nullptr)
+        return;
+
+    const float left = levelMeter->getRMS(0);
+    const float right = levelMeter->getRMS(levelMeter->getNumChannels()>1 ? 1 : 0);
+    if(left!=rmsLeft || right!=rmsRight)
+    {
+        rmsLeft = left;
+        rmsRight = right;
+        repaint(16, getHeight() - pinSize * 2, getWidth()-32.f, 20);
+    }
+}
+//================================================================================
 void FilterComponent::paint (Graphics& g)
 {
     int selected = getProperties().getWithDefault("selected", 0);
@@ -773,20 +792,27 @@ void FilterComponent::update()
     {
         setName (tmpPlug->getPluginName());
         tmpPlug->addActionListener(this);
+        levelMeter = &tmpPlug->getLevelMeter();
     }
 
     else if(CabbagePluginAudioProcessor* tmpPlug = dynamic_cast <CabbagePluginAudioProcessor*> (f->getProcessor()))
     {
         setName (tmpPlug->getPluginName());
         tmpPlug->addActionListener(this);
+        levelMeter = &tmpPlug->getLevelMeter();
     }
 
     else if(AudioFilePlaybackProcessor* tmpPlug = dynamic_cast <AudioFilePlaybackProcessor*> (f->getProcessor()))
     {
         setName (pluginName);
         tmpPlug->addActionListener(this);
+        levelMeter = &tmpPlug->getLevelMeter();
     }
 
+    //meters are polled at display rate rather than pushed from the audio thread
+    if(levelMeter!=nullptr && !isTimerRunning())
+        startTimer(40);
+
     setName(pluginName);
 
 
@@ -81,12 +81,15 @@ public:
 
 private:
     ScopedPointer<CodeWindow> codeWindow;
+    CabbageConsoleBuffer::Reader consoleReader;   //where codeWindow's console is up to
     int pluginType;
     int pinSize;
     Colour filterColour;
     bool filterIsPartofSelectedGroup;
     Point<int> originalPos;
     float rmsLeft, rmsRight;
+    const CabbageLevelMeter* levelMeter;   //polled by timerCallback()
+    void updateLevels();
     void resized();
     Font font;
     int numIns, numOuts;
@@ -17,7 +17,6 @@ PluginWrapper::PluginWrapper(AudioPluginInstance* instance)
 {
     isBypassed = false;
     isMuted = false;
-    updateCounter = 0;
     vstInstance = instance;
     if(!vstInstance)
         assert(0);
@@ -177,6 +176,7 @@ void PluginWrapper::prepareToPlay (double sampleRate, int samplesPerBlock)
     // initialisation that you need..
     if(vstInstance)
         vstInstance->prepareToPlay(sampleRate,samplesPerBlock);
+    levelMeter.prepare(sampleRate);
 }
 
 void PluginWrapper::releaseResources() {}
@@ -194,16 +194,7 @@ void PluginWrapper::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMes
 
 
 
-    rmsLeft = buffer.getRMSLevel(0, 0, buffer.getNumSamples());
-    rmsRight = buffer.getRMSLevel(1, 0, buffer.getNumSamples());
-
-
-    if(updateCounter==0)
-        sendActionMessage("rmsValues "+String(rmsLeft)+" "+String(rmsRight));
-
-    updateCounter++;
-    if(updateCounter>5)
-        updateCounter=0;
+    levelMeter.process(buffer, buffer.getNumSamples());
 }
 
 //==============================================================================
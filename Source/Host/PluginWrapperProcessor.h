@@ -12,6 +12,7 @@
 #define PLUGINWRAPPER_H_INCLUDED
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "../CabbageLevelMeter.h"
 
 
 //==============================================================================
@@ -89,14 +90,17 @@ public:
     void setCurrentProgram (int index) override;
     const String getProgramName (int index) override;
     void changeProgramName (int index, const String& newName) override;
-    float rmsLeft, rmsRight;
+    const CabbageLevelMeter& getLevelMeter() const
+    {
+        return levelMeter;
+    }
     ScopedPointer<AudioPluginInstance> vstInstance;
 private:
     CriticalSection callbackLock;
     PluginDescription pluginDesc;
     bool isBypassed, isMuted;
     String pluginName;
-    int updateCounter;
+    CabbageLevelMeter levelMeter;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginWrapper)
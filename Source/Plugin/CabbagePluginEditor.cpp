@@ -48,8 +48,11 @@ CabbagePluginAudioProcessorEditor::CabbagePluginAudioProcessorEditor (CabbagePlu
       propsWindow(new CabbagePropertiesDialog("Properties")),
 #endif
       xyPadIndex(0),
+      rebuildingWidgets(false),
+      reusedWidgets(false),
       tableBuffer(2, 44100),
-      showScrollbars(true)
+      showScrollbars(true),
+      tableEditTimer(*this)
 {
 
     //setup swatches for colour selector.
@@ -409,6 +412,97 @@ void CabbagePluginAudioProcessorEditor::InsertGUIControls(CabbageGUIType cAttr)
     }
 }
 
+//==============================================================================
+// Incremental rebuilds. The components built last time are set aside, and as
+// the processor walks the new widget list it either hands one of them back,
+// if the widget it was built from hasn't changed, or inserts a new one as
+// usual. Whatever isn't handed back is deleted at the end.
+//==============================================================================
+void CabbagePluginAudioProcessorEditor::beginWidgetRebuild()
+{
+    previousComps.clear(true);
+    previousLayoutComps.clear(true);
+    comps.swapWith(previousComps);
+    layoutComps.swapWith(previousLayoutComps);
+    subPatches.clear(true);
+    popupMenus.clear();
+    rebuildingWidgets = true;
+    reusedWidgets = false;
+}
+
+bool CabbagePluginAudioProcessorEditor::reuseWidgetComponent(bool isLayout, int previousIndex, int index, CabbageGUIType& cAttr)
+{
+    OwnedArray<Component>& previous = (isLayout ? previousLayoutComps : previousComps);
+    OwnedArray<Component>& current = (isLayout ? layoutComps : comps);
+
+    //widgets are added in order, so the component goes on the end
+    if(!rebuildingWidgets || previous[previousIndex]==nullptr)
+        return false;
+    jassert(index==current.size());
+
+    Component* comp = previous.set(previousIndex, nullptr, false);
+    current.add(comp);
+    comp->getProperties().set(CabbageIDs::lineNumber, cAttr.getNumProp(CabbageIDs::lineNumber));
+
+    //the component, and the slider, button or combo inside it, know their
+    //widget by index and by name, and both may have changed. Other widgets'
+    //components in a plant are children too, and are left to themselves
+    const String oldName = comp->getName();
+    const String name = cAttr.getStringProp(CabbageIDs::name);
+    for(int i=-1; i<comp->getNumChildComponents(); i++)
+    {
+        Component* child = (i<0 ? comp : comp->getChildComponent(i));
+        if(i>=0 && (comps.contains(child) || layoutComps.contains(child)
+                    || previousComps.contains(child) || previousLayoutComps.contains(child)))
+            continue;
+
+        if(child->getProperties().contains(CabbageIDs::index))
+            child->getProperties().set(CabbageIDs::index, index);
+        if(oldName.isNotEmpty() && oldName!=name)
+        {
+            if(child->getName()==oldName)
+                child->setName(name);
+            else if(child->getName()=="groupbox_"+oldName)
+                child->setName("groupbox_"+name);
+        }
+    }
+
+    reusedWidgets = true;
+    return true;
+}
+
+void CabbagePluginAudioProcessorEditor::endWidgetRebuild(const StringArray& widgetTypes)
+{
+    if(!rebuildingWidgets)
+        return;
+
+    rebuildingWidgets = false;
+    previousComps.clear(true);
+    previousLayoutComps.clear(true);
+    if(!reusedWidgets)
+        return;
+
+    //reused components are still where they were among their siblings, and
+    //setupWindow() has shrunk the panel back to the form, so restore the
+    //stacking order and panel size a full rebuild would have given
+    int layoutIndex=0, interactiveIndex=0;
+    for(int i=0; i<widgetTypes.size(); i++)
+    {
+        Component* comp = (widgetTypes[i]=="layout" ? layoutComps[layoutIndex++] : comps[interactiveIndex++]);
+        if(comp==nullptr || comp->getParentComponent()==nullptr)
+            continue;
+
+        comp->toFront(false);
+        if(comp->getParentComponent()==componentPanel
+                && (comp->getRight()>componentPanel->getWidth() || comp->getBottom()>componentPanel->getHeight()))
+        {
+            componentPanel->setSize(jmax(componentPanel->getWidth(), comp->getRight()),
+                                    jmax(componentPanel->getHeight(), comp->getBottom()));
+            viewportComponent->setBounds(0, 0, componentPanel->getWidth(), componentPanel->getHeight());
+        }
+    }
+}
+
 
 //===========================================================================
 //WHEN IN GUI EDITOR MODE THIS CALLBACK WILL NOTIFIY THE HOST OF EVENTS
@@ -478,7 +572,7 @@ void CabbagePluginAudioProcessorEditor::changeListenerCallback(ChangeBroadcaster
         if((genTable->getCurrentHandle() && genTable->displayAsGrid()!=1))
             popupBubble->showAt(genTable->getCurrentHandle(), AttributedString(genTable->getCoordinates()), 1050);
         if(genTable->changeMessage == "updateFunctionTable")
-            updatefTableData(genTable);
+            queueTableEdit(genTable);
     }
 
     CabbageTextEditor* textEditor = dynamic_cast<CabbageTextEditor*>(source);
@@ -710,76 +804,100 @@ void CabbagePluginAudioProcessorEditor::createfTableData(Table* table, bool )
 
 }
 
-void CabbagePluginAudioProcessorEditor::updatefTableData(GenTable* table)
+//fills dest with what GEN02, GEN05 or GEN07 would produce from a gentable's pfields.
+//pFields is laid out as GenTable::getPfields() returns it
+static void generateTableFromPfields(int realGenRoutine, const Array<double>& pFields, MYFLT* dest, int size)
 {
-#ifndef Cabbage_No_Csound
-
-    Array<double> pFields = table->getPfields();
-    if( table->genRoutine==5 || table->genRoutine==7 || table->genRoutine==2)
+    const int genRoutine = abs(realGenRoutine);
+    if(genRoutine==2)
     {
-        FUNC *ftpp;
-        EVTBLK  evt;
-        memset(&evt, 0, sizeof(EVTBLK));
-        evt.pcnt = 5+pFields.size();
-        evt.opcod = 'f';
-        evt.p[0]=0;
-
-
-//		cUtils::debug("table->tableSize", table->tableSize);
-
-
-        //setting table number to 0.
-        evt.p[1]=0;
-        evt.p[2]=0;
-        evt.p[3]=table->tableSize;
-        evt.p[4]=table->realGenRoutine;
-        if(table->genRoutine==5)
-        {
-            for(int i=0; i<pFields.size()-1; i++)
-                evt.p[5+i]= jmax(0.00001, pFields[i+1]);
-        }
-        else if(table->genRoutine==7)
-        {
-            for(int i=0; i<pFields.size()-1; i++)
-                evt.p[5+i]= pFields[i+1];
-        }
-        else
+        for(int i=0; i<size; i++)
+            dest[i] = i<pFields.size() ? pFields[i] : 0;
+    }
+    else
+    {
+        //pFields holds {x, y} pairs, where each x is the length of the segment leading to y
+        double value = genRoutine==5 ? jmax(0.00001, pFields[1]) : pFields[1];
+        int pos = 0;
+        for(int i=2; i+1<pFields.size(); i+=2)
         {
-            for(int i=0; i<pFields.size(); i++)
-                evt.p[5+i] = pFields[i];
+            const int length = (int)pFields[i];
+            const double target = genRoutine==5 ? jmax(0.00001, pFields[i+1]) : pFields[i+1];
+            for(int j=0; j<length && pos<size; j++, pos++)
+            {
+                const double fraction = double(j)/length;
+                dest[pos] = genRoutine==5 ? value*pow(target/value, fraction) : value+(target-value)*fraction;
+            }
+            value = target;
         }
+        //like Csound, hold the last value to the end of the table
+        for(; pos<size; pos++)
+            dest[pos] = value;
+    }
 
+    //a positive GEN number means the table is post-normalised
+    if(realGenRoutine>0)
+    {
+        MYFLT maxValue = 0;
+        for(int i=0; i<size; i++)
+            maxValue = jmax(maxValue, (MYFLT)fabs(dest[i]));
+        if(maxValue>0)
+            for(int i=0; i<size; i++)
+                dest[i] /= maxValue;
+    }
+}
 
-        StringArray fStatement;
-        int pCnt=0;
-        for(int i=0; i<evt.pcnt-1; i++)
-        {
-            fStatement.add(String(evt.p[i]));
-            //cUtils::debug(i, fStatement[i]);
-            pCnt=i;
-        }
+//computes the edited table into a staging buffer on the message thread. The audio
+//thread copies it into Csound's table at the next k-cycle. Returns false if the
+//previous edit to this table hasn't been committed yet, so it can be retried
+bool CabbagePluginAudioProcessorEditor::updatefTableData(GenTable* table)
+{
+#ifndef Cabbage_No_Csound
+    if( table->genRoutine==5 || table->genRoutine==7 || table->genRoutine==2)
+    {
+        const int tableSize = getFilter()->checkTable(table->tableNumber);
+        if(tableSize<=0)
+            return true;
 
-        if(table->genRoutine!=2)
-        {
-            fStatement.add(String(1));
-            fStatement.add(String(evt.p[pCnt]));
-        }
+        MYFLT* staging = getFilter()->tableUpdateMailbox.getStagingBuffer(table->tableNumber, tableSize);
+        if(staging==nullptr)
+            return false;
 
-        //now set table number and set score char to f
-        fStatement.set(1, String(table->tableNumber));
-        fStatement.set(0, "f");
+        generateTableFromPfields(table->realGenRoutine, table->getPfields(), staging, tableSize);
+        table->setWaveform(Array<float, CriticalSection>(staging, tableSize), false);
+        getFilter()->tableUpdateMailbox.post(table->tableNumber);
+    }
+#endif
+    return true;
+}
 
-        //Logger::writeToLog(fStatement.joinIntoString(" "));
-        getFilter()->getCsound()->GetCsound()->hfgens(getFilter()->getCsound()->GetCsound(), &ftpp, &evt, 1);
-        Array<float, CriticalSection> points;
+void CabbagePluginAudioProcessorEditor::queueTableEdit(GenTable* table)
+{
+    for(int i=0; i<pendingTableEdits.size(); i++)
+        if(pendingTableEdits.getReference(i).getComponent()==table)
+            return;
 
-        points = Array<float, CriticalSection>(ftpp->ftable, ftpp->flen);
-        table->setWaveform(points, false);
-        //table->enableEditMode(fStatement);
+    pendingTableEdits.add(table);
+    if(!tableEditTimer.isTimerRunning())
+        tableEditTimer.startTimer(16);
+}
 
-        getFilter()->messageQueue.addOutgoingTableUpdateMessageToQueue(fStatement.joinIntoString(" "), table->tableNumber);
+void CabbagePluginAudioProcessorEditor::flushTableEdits()
+{
+    for(int i=pendingTableEdits.size(); --i>=0;)
+    {
+        GenTable* table = pendingTableEdits.getReference(i).getComponent();
+        if(table==nullptr || updatefTableData(table))
+            pendingTableEdits.remove(i);
     }
-#endif
+
+    if(pendingTableEdits.size()==0)
+        tableEditTimer.stopTimer();
+}
+
+void TableEditTimer::timerCallback()
+{
+    owner.flushTableEdits();
 }
 
 //=======================================================
@@ -2248,7 +2366,7 @@ void CabbagePluginAudioProcessorEditor::InsertCsoundOutput(CabbageGUIType &cAttr
     layoutComps[idx]->getProperties().set(CabbageIDs::index, idx);
     //set visiblilty
     layoutComps[idx]->setVisible((cAttr.getNumProp(CabbageIDs::visible)==1 ? true : false));
-    static_cast<CabbageTextbox*>(layoutComps[idx])->editor->setText(getFilter()->getCsoundOutput());
+    updateCsoundOutputWidget(static_cast<CabbageTextbox*>(layoutComps[idx]));
     startTimer(100);
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -2507,11 +2625,14 @@ void CabbagePluginAudioProcessorEditor::InsertSoundfiler(CabbageGUIType &cAttr)
     for(int y=0; y<numberOfTables; y++)
     {
         int tableNumber = cAttr.getIntArrayPropValue(CabbageIDs::tablenumber, y);
-        tableValues.clear();
-        tableValues = getFilter()->getTableFloats(tableNumber);
-        if(tableBuffer.getNumSamples()<tableValues.size())
-            tableBuffer.setSize(numberOfTables, tableValues.size());
-        tableBuffer.addFrom(y, 0, tableValues.getRawDataPointer(), tableValues.size());
+        const CabbageTableSnapshot* snapshot = getFilter()->getTableSnapshot(tableNumber);
+        isNewTableVersion(layoutComps[idx], tableNumber, snapshot);
+        if(snapshot!=nullptr)
+        {
+            if(tableBuffer.getNumSamples()<snapshot->size)
+                tableBuffer.setSize(numberOfTables, snapshot->size);
+            tableBuffer.addFrom(y, 0, snapshot->data, snapshot->size);
+        }
     }
     dynamic_cast<CabbageSoundfiler*>(layoutComps[idx])->setWaveform(tableBuffer, numberOfTables);
     if(File(cAttr.getStringProp(CabbageIDs::file)).existsAsFile())
@@ -2570,6 +2691,7 @@ void CabbagePluginAudioProcessorEditor::InsertGenTable(CabbageGUIType &cAttr)
         int tableNumber = tables[y];
         tableValues.clear();
         tableValues = getFilter()->getTableFloats(tableNumber);
+        isNewTableVersion(layoutComps[idx], tableNumber, getFilter()->getTableSnapshot(tableNumber));
         if(tableNumber>0 && tableValues.size()>0)
         {
             //Logger::writeToLog("Table Number:"+String(tableNumber));
@@ -3512,7 +3634,8 @@ void CabbagePluginAudioProcessorEditor::comboBoxChanged (ComboBox* combo)
                 filename = workingDir+"/"+combo->getText()+".snaps";
 #endif
                 //Logger::writeToLog(filename);
-                if(File(filename).existsAsFile())
+                //presets in the bank are switched on the next k-cycle, without any file access
+                if(!getFilter()->recallPreset(combo->getText()) && File(filename).existsAsFile())
                     restoreParametersFromPresets(XmlDocument::parse(File(filename)));
                 //File(combo->getText())
             }
@@ -3743,6 +3866,7 @@ void CabbagePluginAudioProcessorEditor::InsertTable(CabbageGUIType &cAttr)
     {
         tableNumber = cAttr.getIntArrayPropValue(CabbageIDs::tablenumber, y);
         Array <float, CriticalSection> tableValues = getFilter()->getTableFloats(tableNumber);
+        isNewTableVersion(layoutComps[idx], tableNumber, getFilter()->getTableSnapshot(tableNumber));
         ((CabbageTable*)layoutComps[idx])->fillTable(y, tableValues);
         //	StringArray statement = getFilter()->getTableEvtCode(tableNumber);
         //	((CabbageTable*)layoutComps[idx])->setTableEvtCode(y, statement);
@@ -3922,6 +4046,9 @@ void CabbagePluginAudioProcessorEditor::savePresetsFromParameters(File selectedF
 
     File file(selectedFile.getFullPathName());
     file.replaceWithText(xml.createDocument(""));
+
+    //keep a copy in the preset bank so it can be recalled without reading the file
+    getFilter()->storePreset(selectedFile.getFileNameWithoutExtension());
 }
 
 void CabbagePluginAudioProcessorEditor::restoreParametersFromPresets(XmlElement* xmlState)
@@ -4002,403 +4129,26 @@ void CabbagePluginAudioProcessorEditor::updateGUIControls()
                 getFilter()->getXYAutomater(y)->update();
         }
 
-        //don't check the whole ctrls vector here, only ones that have been updated
-        for(int index=0; index<getFilter()->dirtyControls.size(); index++)
+        //only widgets that the processor has marked as changed get looked at,
+        //each is handed to the updater for its kind, see getWidgetUpdater()
+        const int numberOfControls = getFilter()->getGUICtrlsSize();
+        getFilter()->dirtyWidgets.takeMarked(dirtyWidgetIndices);
+        for(int n=0; n<dirtyWidgetIndices.size(); n++)
         {
-            int i = getFilter()->dirtyControls[index];
-            if(i<getFilter()->getGUICtrlsSize())
-            {
-                inValue = getFilter()->getParameter(i);
-                if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type).contains("slider")||
-                        getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::numberbox)
-                {
-                    Slider* slider = nullptr;
-                    if(comps[i])
-                        if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::numberbox)
-                        {
-                            slider = static_cast<CabbageNumberBox*>(comps[i])->slider;
-                        }
-                        else
-                        {
-                            slider = static_cast<CabbageSlider*>(comps[i])->slider;
-                        }
-                    if(slider)
-                    {
-#if !defined(Cabbage_Build_Standalone)
-                        if(slider->getSliderStyle()==Slider::LinearVertical ||
-                                slider->getSliderStyle()==Slider::RotaryVerticalDrag ||
-                                slider->getSliderStyle()==Slider::LinearHorizontal ||
-                                slider->getSliderStyle()==Slider::LinearBarVertical ||
-                                slider->getSliderStyle()==Slider::ThreeValueVertical ||
-                                slider->getSliderStyle()==Slider::ThreeValueHorizontal)
-                        {
-                            float val = getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::range)*getFilter()->getParameter(i)+
-                                        getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::min);
-                            slider->setValue(val, dontSendNotification);
-                        }
-                        else
-                        {
-                            float bottomVal = getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::range)*getFilter()->getParameter(i);
-                            float topVal = getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::range)*getFilter()->getParameter(i+1);
-
-                            slider->setMinAndMaxValues(topVal, bottomVal);
-
-                        }
-#else
-                        if(slider->getSliderStyle()==Slider::LinearVertical ||
-                                slider->getSliderStyle()==Slider::LinearHorizontal ||
-                                slider->getSliderStyle()==Slider::RotaryVerticalDrag ||
-                                slider->getSliderStyle()==Slider::LinearBarVertical ||
-                                slider->getSliderStyle()==Slider::ThreeValueVertical ||
-                                slider->getSliderStyle()==Slider::ThreeValueHorizontal)
-                        {
-                            slider->setValue(inValue, sendNotification);
-                        }
-                        else
-                        {
-                            float bottomVal = getFilter()->getParameter(i);
-                            float topVal = getFilter()->getParameter(i+1);
-                            slider->setMinAndMaxValues(topVal, bottomVal);
-                        }
-#endif
-                    }
-                }
-
-                else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::button)
-                {
-                    CabbageButton* cabButton = static_cast<CabbageButton*>(comps[i]);
-                    cabButton->button->setToggleState(inValue, dontSendNotification);
-                    cabButton->button->setButtonText(getFilter()->getGUICtrls(i).getStringArrayPropValue(CabbageIDs::text, inValue));
-
-                }
-
-                else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::xypad &&
-                        getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::xychannel).equalsIgnoreCase("x"))
-                {
-                    if(comps[i])
-                    {
-#if !defined(Cabbage_Build_Standalone)
-                        float xRange = getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::range);
-                        float xMin = getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::minx);
-                        float yMin = getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::miny);
-                        float yRange = getFilter()->getGUICtrls(i+1).getNumProp(CabbageIDs::range);
-                        ((CabbageXYController*)comps[i])->xypad->setXYValues(getFilter()->getParameter(i)*xRange+xMin, getFilter()->getParameter(i+1)*yRange+yMin);
-#else
-                        ((CabbageXYController*)comps[i])->xypad->setXYValues(getFilter()->getParameter(i), getFilter()->getParameter(i+1));
-#endif
-                    }
-                }
-
-
-                else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::combobox)
-                {
-                    float val;
-                    NotificationType notify;
-                    if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::filetype).contains("snaps"))
-                        notify = sendNotification;
-                    else
-                        notify = dontSendNotification;
-#if defined(Cabbage_Build_Standalone) || defined(CABBAGE_HOST)
-                    val = getFilter()->getParameter(i);
-                    ((CabbageComboBox*)comps[i])->combo->setSelectedItemIndex((int)val-1, notify);
-                    //Logger::writeToLog(String("timerCallback():")+String(val));
-#else
-                    //needed to move combobox to full when controlled by a host
-                    if(getFilter()->getParameter(i)>=0.98)
-                        val = getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::comborange);
-                    else
-                        val = getFilter()->getGUICtrls(i).getNumProp("comborange")*getFilter()->getParameter(i);
-
-                    ((CabbageComboBox*)comps[i])->combo->setSelectedItemIndex(int(val)-1, notify);
-#endif
-                }
-
-                else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::checkbox)
-                {
-                    if(comps[i])
-                    {
-                        if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-                            static_cast<CabbageCheckbox*>(comps[i])->update(getFilter()->getGUICtrls(i));
-                        int val = getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::value);
-                        static_cast<CabbageCheckbox*>(comps[i])->button->setToggleState((bool)val, dontSendNotification);
-                    }
-                }
-
-                else if((getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::hrange
-                         ||getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::vrange))
-                {
-                    if(comps[i])
-                    {
-                        int index = getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::name).contains("dummy") ? i-1 : i;
-                        {
-                            if(getFilter()->getGUICtrls(index).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-                                static_cast<CabbageRangeSlider2*>(comps[index])->update(getFilter()->getGUICtrls(index));
-
-#ifndef Cabbage_Build_Standalone
-                            static_cast<CabbageRangeSlider2*>(comps[index])->getSlider().setValue(getFilter()->getParameter(index),
-                                    getFilter()->getParameter(index+1));
-#endif
-                        }
-                    }
-                }
-
-
-            }
-        }
-
-        //now going to move through array again only this time updating position/sizes/colour, etc
-        //via identchannel() messages.
-        for(int index=0; index<(int)getFilter()->dirtyControls.size(); index++)
-        {
-            int i = getFilter()->dirtyControls[index];
-            if(i<getFilter()->getGUICtrlsSize())
-            {
-                if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-                {
-                    if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::hslider||
-                            getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::rslider||
-                            getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::vslider)
-                    {
-                        static_cast<CabbageSlider*>(comps[i])->update(getFilter()->getGUICtrls(i));
-                        String sliderText = getFilter()->getGUICtrls(i).getStringArrayPropValue(CabbageIDs::text, getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::value));
-                        static_cast<CabbageSlider*>(comps[i])->setLabelText(sliderText);
-                    }
-
-                    else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::button)
-                    {
-                        static_cast<CabbageButton*>(comps[i])->update(getFilter()->getGUICtrls(i));
-                        String buttonText = getFilter()->getGUICtrls(i).getStringArrayPropValue(CabbageIDs::text, getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::value));
-                        static_cast<CabbageButton*>(comps[i])->button->setButtonText(buttonText);
-                        getFilter()->getGUICtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-                    }
-
-                    else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::checkbox)
-                    {
-                        static_cast<CabbageCheckbox*>(comps[i])->update(getFilter()->getGUICtrls(i));
-                        getFilter()->getGUICtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-                    }
-
-                    else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::encoder)
-                    {
-                        static_cast<CabbageEncoder*>(comps[i])->update(getFilter()->getGUICtrls(i));
-                        getFilter()->getGUICtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-                    }
-
-                    else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::numberbox)
-                    {
-                        ((CabbageNumberBox*)comps[i])->update(getFilter()->getGUICtrls(i));
-                        getFilter()->getGUICtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-                    }
-
-                    else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::combobox)
-                    {
-                        ((CabbageComboBox*)comps[i])->update(getFilter()->getGUICtrls(i));
-                        ((CabbageComboBox*)comps[i])->combo->clear();
-                        StringArray prop = getFilter()->getGUICtrls(i).getStringArrayProp(CabbageIDs::text);
-                        for(int cnt=0; cnt<prop.size(); cnt++)
-                            ((CabbageComboBox*)comps[i])->combo->addItem(getFilter()->getGUICtrls(i).getStringArrayPropValue(CabbageIDs::text, cnt), cnt+1);
-
-                        ((CabbageComboBox*)comps[i])->combo->setSelectedItemIndex(getFilter()->getGUICtrls(i).getNumProp(CabbageIDs::value)-1);
-
-                        getFilter()->getGUICtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-                    }
-                    else if(getFilter()->getGUICtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::xypad)
-                    {
-                        ((CabbageXYController*)comps[i])->update(getFilter()->getGUICtrls(i));
-                    }
-
-                }
-            }
-
+            const int index = dirtyWidgetIndices.getUnchecked(n);
+            if(index<numberOfControls)
+                updateWidget(false, index);
+            else if(index-numberOfControls<getFilter()->getGUILayoutCtrlsSize())
+                updateWidget(true, index-numberOfControls);
         }
 
-        getFilter()->dirtyControls.clear();
-
         //the following code looks after updating any objects that don't get recognised as plugin parameters,
-        //for example, table objects don't get listed by the host as a paramters. Likewise the csoundoutput widget..
-        for(int i=0; i<getFilter()->getGUILayoutCtrlsSize(); i++)
+        //and have nothing to mark them as dirty, i.e, the csoundoutput and fftdisplay widgets
+        for(int n=0; n<getFilter()->polledLayoutCtrls.size(); n++)
         {
-            //csoundoutput
-            if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).containsIgnoreCase("csoundoutput"))
-            {
-                static_cast<CabbageTextbox*>(layoutComps[i])->editor->setText(getFilter()->getCsoundOutput());
-                static_cast<CabbageTextbox*>(layoutComps[i])->editor->setCaretPosition(getFilter()->getCsoundOutput().length());
-                if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-                    static_cast<CabbageTextbox*>(layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //label
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("label") &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                ((CabbageLabel*)layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //keyboard
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("keyboard") &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                ((CabbageKeyboard*)layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //textbox
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("textbox") &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                static_cast<CabbageTextbox*>(layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //groupbox
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("groupbox") &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                String message = getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage);
-                if(message.contains("show(1)") && getFilter()->getGUILayoutCtrls(i).getNumProp(CabbageIDs::popup)==1)
-                {
-                    int index = ((CabbageGroupbox*)layoutComps[i])->getProperties().getWithDefault(String("popupPlantIndex"), 0);
-                    if(subPatches[index])
-                    {
-                        //getFilter()->getGUILayoutCtrls(i).setNumProp(CabbageIDs::left, 0);
-                        //getFilter()->getGUILayoutCtrls(i).setNumProp(CabbageIDs::top, 0);
-                        subPatches[index]->setVisible(true);
-                        subPatches[index]->setAlwaysOnTop(true);
-                        subPatches[index]->toFront(true);
-                    }
-                }
-                ((CabbageGroupbox*)layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //soundfiler
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("soundfiler") &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                String message = getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage);
-                if(message.contains("tablenumber")||message.contains("tablenumbers"))
-                {
-                    int numberOfTables = getFilter()->getGUILayoutCtrls(i).getStringArrayProp(CabbageIDs::tablenumber).size();
-                    tableBuffer.clear();
-                    for(int y=0; y<numberOfTables; y++)
-                    {
-                        int tableNumber = getFilter()->getGUILayoutCtrls(i).getIntArrayPropValue(CabbageIDs::tablenumber, y);
-                        tableValues.clear();
-                        tableValues = getFilter()->getTableFloats(tableNumber);
-                        if(tableBuffer.getNumSamples()<tableValues.size())
-                            tableBuffer.setSize(numberOfTables, tableValues.size());
-                        tableBuffer.addFrom(y, 0, tableValues.getRawDataPointer(), tableValues.size());
-                    }
-                    ((CabbageSoundfiler*)layoutComps[i])->setWaveform(tableBuffer, numberOfTables);
-
-                }
-                else if(message.contains("file("))
-                    ((CabbageSoundfiler*)layoutComps[i])->setFile(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::file));
-
-                ((CabbageSoundfiler*)layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //image
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("image") &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                ((CabbageImage*)layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-                //repaint();
-            }
-            //texteditor
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("texteditor") &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                ((CabbageTextEditor*)layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //encoder
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("encoder") &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                static_cast<CabbageEncoder*>(layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //table
-            else if((getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::table) &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                String message = getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage);
-                if(message.contains("tablenumber")||message.contains("tablenumbers"))
-                {
-                    int numberOfTables = getFilter()->getGUILayoutCtrls(i).getStringArrayProp(CabbageIDs::tablenumber).size();
-                    for(int y=0; y<numberOfTables; y++)
-                    {
-                        const int tableNumber = getFilter()->getGUILayoutCtrls(i).getIntArrayPropValue(CabbageIDs::tablenumber, y);
-                        tableValues.clear();
-                        tableValues = getFilter()->getTableFloats(tableNumber);
-                        ((CabbageTable*)layoutComps[i])->fillTable(y, tableValues);
-                    }
-                }
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-            //gentable
-            else if((getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type)==CabbageIDs::gentable) &&
-                    getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            {
-                String message = getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::identchannelmessage);
-                TableManager* table = static_cast<CabbageGenTable*>(layoutComps[i])->table;
-                if(message.contains("tablenumber")||message.contains("tablenumbers"))
-                {
-                    int numberOfTables = getFilter()->getGUILayoutCtrls(i).getStringArrayProp(CabbageIDs::tablenumber).size();
-                    for(int y=0; y<numberOfTables; y++)
-                    {
-
-                        const int tableNumber = getFilter()->getGUILayoutCtrls(i).getIntArrayPropValue(CabbageIDs::tablenumber, y);
-
-                        tableValues = getFilter()->getTableFloats(tableNumber);
-                        if(table->getTableFromFtNumber(tableNumber)->tableSize>=MAX_TABLE_SIZE)
-                        {
-                            tableBuffer.clear();
-                            tableBuffer.addFrom(y, 0, tableValues.getRawDataPointer(), tableValues.size());
-                            table->setWaveform(tableBuffer, tableNumber);
-                        }
-                        else
-                        {
-                            table->setWaveform(tableValues, tableNumber, false);
-                            StringArray pFields = getFilter()->getTableStatement(tableNumber);
-                            table->enableEditMode(pFields, tableNumber);
-                        }
-                    }
-                }
-                else if(message.contains("file("))
-                    table->setFile(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::file));
-
-                static_cast<CabbageGenTable*>(layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-
-            //sample stepper widget
-            else if(checkForIdentifierMessage(getFilter()->getGUILayoutCtrls(i), "stepper"))
-            {
-                static_cast<CabbageStepper*>(layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-            }
-
-
-            //FFT Widget
-            else if(getFilter()->getGUILayoutCtrls(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("fftdisplay"))
-            {
-                if(checkForIdentifierMessage(getFilter()->getGUILayoutCtrls(i), "fftdisplay"))
-                {
-                    static_cast<CabbageFFTDisplay*>(layoutComps[i])->update(getFilter()->getGUILayoutCtrls(i));
-                    getFilter()->getGUILayoutCtrls(i).setStringProp(CabbageIDs::identchannelmessage, "");
-                }
-
-                if(getFilter()->shouldUpdateFFTDisplay())
-                {
-                    const int tableNumber = getFilter()->getGUILayoutCtrls(i).getNumProp(CabbageIDs::ffttablenumber);
-
-                    //const int min = getFilter()->getFFTTable(tableNumber)->min;
-                    //const int max = getFilter()->getFFTTable(tableNumber)->min;
-                    static_cast<CabbageFFTDisplay*>(layoutComps[i])->setPoints(getFilter()->getFFTTable(tableNumber)->getPoints());
-                    //static_cast<CabbageFFTDisplay*>(layoutComps[i])->setBins(min, max);
-                    getFilter()->resetUpdateFFTDisplayFlag();
-                }
-            }
+            const int index = getFilter()->polledLayoutCtrls.getUnchecked(n);
+            if(index<getFilter()->getGUILayoutCtrlsSize())
+                updateWidget(true, index);
         }
 
 
@@ -4471,19 +4221,433 @@ void CabbagePluginAudioProcessorEditor::updateGUIControls()
 
 }
 
+//==========================================================================================
+//updateGUIControls() hands each dirty widget to the updater registered here for its
+//kind. Widgets whose kind has no updater don't have anything to refresh
+//==========================================================================================
+CabbagePluginAudioProcessorEditor::WidgetUpdater CabbagePluginAudioProcessorEditor::getWidgetUpdater(CabbageGUIType::WidgetKind kind, bool isLayout)
+{
+    struct UpdaterTable
+    {
+        UpdaterTable()
+        {
+            for(int i=0; i<CabbageGUIType::numWidgetKinds; i++)
+                controls[i] = layout[i] = nullptr;
+
+            controls[CabbageGUIType::sliderWidget] = &CabbagePluginAudioProcessorEditor::updateSliderWidget;
+            controls[CabbageGUIType::numberboxWidget] = &CabbagePluginAudioProcessorEditor::updateNumberBoxWidget;
+            controls[CabbageGUIType::buttonWidget] = &CabbagePluginAudioProcessorEditor::updateButtonWidget;
+            controls[CabbageGUIType::xypadWidget] = &CabbagePluginAudioProcessorEditor::updateXYPadWidget;
+            controls[CabbageGUIType::comboboxWidget] = &CabbagePluginAudioProcessorEditor::updateComboBoxWidget;
+            controls[CabbageGUIType::checkboxWidget] = &CabbagePluginAudioProcessorEditor::updateCheckBoxWidget;
+            controls[CabbageGUIType::rangeWidget] = &CabbagePluginAudioProcessorEditor::updateRangeWidget;
+            controls[CabbageGUIType::encoderWidget] = &CabbagePluginAudioProcessorEditor::updateFromIdentMessage<CabbageEncoder>;
+
+            layout[CabbageGUIType::csoundoutputWidget] = &CabbagePluginAudioProcessorEditor::updateOutputConsoleWidget;
+            layout[CabbageGUIType::labelWidget] = &CabbagePluginAudioProcessorEditor::updateFromIdentMessage<CabbageLabel>;
+            layout[CabbageGUIType::keyboardWidget] = &CabbagePluginAudioProcessorEditor::updateFromIdentMessage<CabbageKeyboard>;
+            layout[CabbageGUIType::textboxWidget] = &CabbagePluginAudioProcessorEditor::updateFromIdentMessage<CabbageTextbox>;
+            layout[CabbageGUIType::groupboxWidget] = &CabbagePluginAudioProcessorEditor::updateGroupBoxWidget;
+            layout[CabbageGUIType::soundfilerWidget] = &CabbagePluginAudioProcessorEditor::updateSoundfilerWidget;
+            layout[CabbageGUIType::imageWidget] = &CabbagePluginAudioProcessorEditor::updateFromIdentMessage<CabbageImage>;
+            layout[CabbageGUIType::texteditorWidget] = &CabbagePluginAudioProcessorEditor::updateFromIdentMessage<CabbageTextEditor>;
+            layout[CabbageGUIType::encoderWidget] = &CabbagePluginAudioProcessorEditor::updateFromIdentMessage<CabbageEncoder>;
+            layout[CabbageGUIType::tableWidget] = &CabbagePluginAudioProcessorEditor::updateTableWidget;
+            layout[CabbageGUIType::gentableWidget] = &CabbagePluginAudioProcessorEditor::updateGenTableWidget;
+            layout[CabbageGUIType::stepperWidget] = &CabbagePluginAudioProcessorEditor::updateFromIdentMessage<CabbageStepper>;
+            layout[CabbageGUIType::fftdisplayWidget] = &CabbagePluginAudioProcessorEditor::updateFFTDisplayWidget;
+        }
+
+        WidgetUpdater controls[CabbageGUIType::numWidgetKinds];
+        WidgetUpdater layout[CabbageGUIType::numWidgetKinds];
+    };
+
+    static const UpdaterTable updaters;
+    return isLayout ? updaters.layout[kind] : updaters.controls[kind];
+}
+
+void CabbagePluginAudioProcessorEditor::updateWidget(bool isLayout, int index)
+{
+    CabbageGUIType& cAttr = (isLayout ? getFilter()->getGUILayoutCtrls(index) : getFilter()->getGUICtrls(index));
+    Component* comp = (isLayout ? layoutComps[index] : comps[index]);
+    if(comp==nullptr)
+        return;
+
+    if(WidgetUpdater updater = getWidgetUpdater(cAttr.getKind(), isLayout))
+        (this->*updater)(cAttr, comp, index);
+}
+
+//widgets that only ever change through identchannel() messages
+template <class WidgetType>
+void CabbagePluginAudioProcessorEditor::updateFromIdentMessage(CabbageGUIType& cAttr, Component* comp, int)
+{
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+    {
+        static_cast<WidgetType*>(comp)->update(cAttr);
+        cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+    }
+}
+
+void CabbagePluginAudioProcessorEditor::updateSliderValue(Slider* slider, int i)
+{
+#if !defined(Cabbage_Build_Standalone)
+    if(slider->getSliderStyle()==Slider::LinearVertical ||
+            slider->getSliderStyle()==Slider::RotaryVerticalDrag ||
+            slider->getSliderStyle()==Slider::LinearHorizontal ||
+            slider->getSliderStyle()==Slider::LinearBarVertical ||
+            slider->getSliderStyle()==Slider::ThreeValueVertical ||
+            slider->getSliderStyle()==Slider::ThreeValueHorizontal)
+    {
+        float val = getFilter()->getGUICtrls(i).getRange()*getFilter()->getParameter(i)+
+                    getFilter()->getGUICtrls(i).getMin();
+        slider->setValue(val, dontSendNotification);
+    }
+    else
+    {
+        float bottomVal = getFilter()->getGUICtrls(i).getRange()*getFilter()->getParameter(i);
+        float topVal = getFilter()->getGUICtrls(i).getRange()*getFilter()->getParameter(i+1);
+
+        slider->setMinAndMaxValues(topVal, bottomVal);
+
+    }
+#else
+    if(slider->getSliderStyle()==Slider::LinearVertical ||
+            slider->getSliderStyle()==Slider::LinearHorizontal ||
+            slider->getSliderStyle()==Slider::RotaryVerticalDrag ||
+            slider->getSliderStyle()==Slider::LinearBarVertical ||
+            slider->getSliderStyle()==Slider::ThreeValueVertical ||
+            slider->getSliderStyle()==Slider::ThreeValueHorizontal)
+    {
+        slider->setValue(getFilter()->getParameter(i), sendNotification);
+    }
+    else
+    {
+        float bottomVal = getFilter()->getParameter(i);
+        float topVal = getFilter()->getParameter(i+1);
+        slider->setMinAndMaxValues(topVal, bottomVal);
+    }
+#endif
+}
+
+void CabbagePluginAudioProcessorEditor::updateSliderWidget(CabbageGUIType& cAttr, Component* comp, int i)
+{
+    CabbageSlider* cabSlider = static_cast<CabbageSlider*>(comp);
+    if(cabSlider->slider)
+        updateSliderValue(cabSlider->slider, i);
+
+    //the message is left in place so that the label keeps following the value
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+    {
+        const String type = cAttr.getStringProp(CabbageIDs::type);
+        if(type==CabbageIDs::hslider || type==CabbageIDs::rslider || type==CabbageIDs::vslider)
+        {
+            cabSlider->update(cAttr);
+            String sliderText = cAttr.getStringArrayPropValue(CabbageIDs::text, cAttr.getNumProp(CabbageIDs::value));
+            cabSlider->setLabelText(sliderText);
+        }
+    }
+}
+
+void CabbagePluginAudioProcessorEditor::updateNumberBoxWidget(CabbageGUIType& cAttr, Component* comp, int i)
+{
+    CabbageNumberBox* numberBox = static_cast<CabbageNumberBox*>(comp);
+    if(numberBox->slider)
+        updateSliderValue(numberBox->slider, i);
+
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+    {
+        numberBox->update(cAttr);
+        cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+    }
+}
+
+void CabbagePluginAudioProcessorEditor::updateButtonWidget(CabbageGUIType& cAttr, Component* comp, int i)
+{
+    CabbageButton* cabButton = static_cast<CabbageButton*>(comp);
+    inValue = getFilter()->getParameter(i);
+    cabButton->button->setToggleState(inValue, dontSendNotification);
+    cabButton->button->setButtonText(cAttr.getStringArrayPropValue(CabbageIDs::text, inValue));
+
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+    {
+        cabButton->update(cAttr);
+        String buttonText = cAttr.getStringArrayPropValue(CabbageIDs::text, cAttr.getNumProp(CabbageIDs::value));
+        cabButton->button->setButtonText(buttonText);
+        cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+    }
+}
+
+void CabbagePluginAudioProcessorEditor::updateXYPadWidget(CabbageGUIType& cAttr, Component* comp, int i)
+{
+    CabbageXYController* xyController = static_cast<CabbageXYController*>(comp);
+    if(cAttr.getStringProp(CabbageIDs::xychannel).equalsIgnoreCase("x"))
+    {
+#if !defined(Cabbage_Build_Standalone)
+        float xRange = cAttr.getRange();
+        float xMin = cAttr.getNumProp(CabbageIDs::minx);
+        float yMin = cAttr.getNumProp(CabbageIDs::miny);
+        float yRange = getFilter()->getGUICtrls(i+1).getRange();
+        xyController->xypad->setXYValues(getFilter()->getParameter(i)*xRange+xMin, getFilter()->getParameter(i+1)*yRange+yMin);
+#else
+        xyController->xypad->setXYValues(getFilter()->getParameter(i), getFilter()->getParameter(i+1));
+#endif
+    }
+
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+        xyController->update(cAttr);
+}
+
+void CabbagePluginAudioProcessorEditor::updateComboBoxWidget(CabbageGUIType& cAttr, Component* comp, int i)
+{
+    CabbageComboBox* cabCombo = static_cast<CabbageComboBox*>(comp);
+    float val;
+    NotificationType notify;
+    if(cAttr.getStringProp(CabbageIDs::filetype).contains("snaps"))
+        notify = sendNotification;
+    else
+        notify = dontSendNotification;
+#if defined(Cabbage_Build_Standalone) || defined(CABBAGE_HOST)
+    val = getFilter()->getParameter(i);
+    cabCombo->combo->setSelectedItemIndex((int)val-1, notify);
+#else
+    //needed to move combobox to full when controlled by a host
+    if(getFilter()->getParameter(i)>=0.98)
+        val = cAttr.getComboRange();
+    else
+        val = cAttr.getComboRange()*getFilter()->getParameter(i);
+
+    cabCombo->combo->setSelectedItemIndex(int(val)-1, notify);
+#endif
+
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+    {
+        cabCombo->update(cAttr);
+        cabCombo->combo->clear();
+        StringArray prop = cAttr.getStringArrayProp(CabbageIDs::text);
+        for(int cnt=0; cnt<prop.size(); cnt++)
+            cabCombo->combo->addItem(cAttr.getStringArrayPropValue(CabbageIDs::text, cnt), cnt+1);
+
+        cabCombo->combo->setSelectedItemIndex(cAttr.getNumProp(CabbageIDs::value)-1);
+
+        cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+    }
+}
+
+void CabbagePluginAudioProcessorEditor::updateCheckBoxWidget(CabbageGUIType& cAttr, Component* comp, int)
+{
+    CabbageCheckbox* checkbox = static_cast<CabbageCheckbox*>(comp);
+    int val = cAttr.getValue();
+    checkbox->button->setToggleState((bool)val, dontSendNotification);
+
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+    {
+        checkbox->update(cAttr);
+        cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+    }
+}
+
+void CabbagePluginAudioProcessorEditor::updateRangeWidget(CabbageGUIType& cAttr, Component*, int i)
+{
+    //both ends of a range share the component of the first one
+    int index = cAttr.getStringProp(CabbageIDs::name).contains("dummy") ? i-1 : i;
+    if(comps[index]==nullptr)
+        return;
+
+    if(getFilter()->getGUICtrls(index).getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+        static_cast<CabbageRangeSlider2*>(comps[index])->update(getFilter()->getGUICtrls(index));
+
+#ifndef Cabbage_Build_Standalone
+    static_cast<CabbageRangeSlider2*>(comps[index])->getSlider().setValue(getFilter()->getParameter(index),
+            getFilter()->getParameter(index+1));
+#endif
+}
+
+void CabbagePluginAudioProcessorEditor::updateOutputConsoleWidget(CabbageGUIType& cAttr, Component* comp, int)
+{
+    updateCsoundOutputWidget(static_cast<CabbageTextbox*>(comp));
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+    {
+        static_cast<CabbageTextbox*>(comp)->update(cAttr);
+        cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+    }
+}
+
+void CabbagePluginAudioProcessorEditor::updateGroupBoxWidget(CabbageGUIType& cAttr, Component* comp, int)
+{
+    String message = cAttr.getStringProp(CabbageIDs::identchannelmessage);
+    if(message.isEmpty())
+        return;
+
+    if(message.contains("show(1)") && cAttr.getNumProp(CabbageIDs::popup)==1)
+    {
+        int index = comp->getProperties().getWithDefault(String("popupPlantIndex"), 0);
+        if(subPatches[index])
+        {
+            subPatches[index]->setVisible(true);
+            subPatches[index]->setAlwaysOnTop(true);
+            subPatches[index]->toFront(true);
+        }
+    }
+    static_cast<CabbageGroupbox*>(comp)->update(cAttr);
+    cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+}
+
+void CabbagePluginAudioProcessorEditor::updateSoundfilerWidget(CabbageGUIType& cAttr, Component* comp, int)
+{
+    String message = cAttr.getStringProp(CabbageIDs::identchannelmessage);
+    if(message.isEmpty())
+        return;
+
+    CabbageSoundfiler* soundfiler = static_cast<CabbageSoundfiler*>(comp);
+    if(message.contains("tablenumber")||message.contains("tablenumbers"))
+    {
+        int numberOfTables = cAttr.getStringArrayProp(CabbageIDs::tablenumber).size();
+        //only redraw the waveform if one of its tables has changed since it was last drawn
+        Array<const CabbageTableSnapshot*> snapshots;
+        bool tablesChanged = false;
+        for(int y=0; y<numberOfTables; y++)
+        {
+            int tableNumber = cAttr.getIntArrayPropValue(CabbageIDs::tablenumber, y);
+            snapshots.add(getFilter()->getTableSnapshot(tableNumber));
+            if(isNewTableVersion(comp, tableNumber, snapshots.getLast()))
+                tablesChanged = true;
+        }
+        if(tablesChanged)
+        {
+            tableBuffer.clear();
+            for(int y=0; y<numberOfTables; y++)
+                if(const CabbageTableSnapshot* snapshot = snapshots[y])
+                {
+                    if(tableBuffer.getNumSamples()<snapshot->size)
+                        tableBuffer.setSize(numberOfTables, snapshot->size);
+                    tableBuffer.addFrom(y, 0, snapshot->data, snapshot->size);
+                }
+            soundfiler->setWaveform(tableBuffer, numberOfTables);
+        }
+
+    }
+    else if(message.contains("file("))
+        soundfiler->setFile(cAttr.getStringProp(CabbageIDs::file));
+
+    soundfiler->update(cAttr);
+    cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+}
+
+void CabbagePluginAudioProcessorEditor::updateTableWidget(CabbageGUIType& cAttr, Component* comp, int)
+{
+    String message = cAttr.getStringProp(CabbageIDs::identchannelmessage);
+    if(message.isEmpty())
+        return;
+
+    if(message.contains("tablenumber")||message.contains("tablenumbers"))
+    {
+        int numberOfTables = cAttr.getStringArrayProp(CabbageIDs::tablenumber).size();
+        for(int y=0; y<numberOfTables; y++)
+        {
+            const int tableNumber = cAttr.getIntArrayPropValue(CabbageIDs::tablenumber, y);
+            const CabbageTableSnapshot* snapshot = getFilter()->getTableSnapshot(tableNumber);
+            if(isNewTableVersion(comp, tableNumber, snapshot))
+                static_cast<CabbageTable*>(comp)->fillTable(y, Array<float, CriticalSection>(snapshot->data, snapshot->size));
+        }
+    }
+    cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+}
+
+void CabbagePluginAudioProcessorEditor::updateGenTableWidget(CabbageGUIType& cAttr, Component* comp, int)
+{
+    String message = cAttr.getStringProp(CabbageIDs::identchannelmessage);
+    if(message.isEmpty())
+        return;
+
+    TableManager* table = static_cast<CabbageGenTable*>(comp)->table;
+    if(message.contains("tablenumber")||message.contains("tablenumbers"))
+    {
+        int numberOfTables = cAttr.getStringArrayProp(CabbageIDs::tablenumber).size();
+        for(int y=0; y<numberOfTables; y++)
+        {
+
+            const int tableNumber = cAttr.getIntArrayPropValue(CabbageIDs::tablenumber, y);
+
+            const CabbageTableSnapshot* snapshot = getFilter()->getTableSnapshot(tableNumber);
+            if(!isNewTableVersion(comp, tableNumber, snapshot))
+                continue;
+
+            if(table->getTableFromFtNumber(tableNumber)->tableSize>=MAX_TABLE_SIZE)
+            {
+                //hand the snapshot over without copying it into tableBuffer first
+                float* channels[1] = {const_cast<float*>(snapshot->data)};
+                table->setWaveform(AudioSampleBuffer(channels, 1, snapshot->size), tableNumber);
+            }
+            else
+            {
+                table->setWaveform(Array<float, CriticalSection>(snapshot->data, snapshot->size), tableNumber, false);
+                StringArray pFields = getFilter()->getTableStatement(tableNumber);
+                table->enableEditMode(pFields, tableNumber);
+            }
+        }
+    }
+    else if(message.contains("file("))
+        table->setFile(cAttr.getStringProp(CabbageIDs::file));
+
+    static_cast<CabbageGenTable*>(comp)->update(cAttr);
+    cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+}
+
+void CabbagePluginAudioProcessorEditor::updateFFTDisplayWidget(CabbageGUIType& cAttr, Component* comp, int)
+{
+    CabbageFFTDisplay* fftDisplay = static_cast<CabbageFFTDisplay*>(comp);
+    if(cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
+    {
+        fftDisplay->update(cAttr);
+        cAttr.setStringProp(CabbageIDs::identchannelmessage, "");
+    }
+
+    const int tableNumber = cAttr.getNumProp(CabbageIDs::ffttablenumber);
+    const CabbageTableSnapshot* frame = getFilter()->getGraphFrame(tableNumber);
+    if(frame!=nullptr && frame->size>0 && isNewTableVersion(comp, tableNumber, frame))
+    {
+        fftDisplay->setPoints(Array<float, CriticalSection>(frame->data, frame->size));
+    }
+}
+
 void CabbagePluginAudioProcessorEditor::timerCallback()
 {
     CabbageTextbox* object = dynamic_cast<CabbageTextbox*>(layoutComps[csoundOutputWidget]);
     if(object)
+        updateCsoundOutputWidget(object);
+}
+
+//==============================================================================
+//adds whatever Csound printed since the textbox was last updated. Where the
+//textbox is up to lives in its properties, like table versions do
+//==============================================================================
+void CabbagePluginAudioProcessorEditor::updateCsoundOutputWidget(CabbageTextbox* textbox)
+{
+    CabbageConsoleBuffer::Reader reader;
+    NamedValueSet& props = textbox->getProperties();
+    if(props.contains("consolePosition"))
+    {
+        reader.position = props["consolePosition"];
+        reader.shownFrom = props["consoleShownFrom"];
+    }
+
+    String text;
+    if(getFilter()->readCsoundOutput(reader, text))
     {
-        if(object->editor->getText()!=getFilter()->getCsoundOutput())
+        if(text.isNotEmpty())
         {
-            object->editor->setText(getFilter()->getCsoundOutput());
-            object->editor->setCaretPosition(object->editor->getText().length());
+            textbox->editor->moveCaretToEnd();
+            textbox->editor->insertTextAtCaret(text);
         }
-
+    }
+    else
+    {
+        textbox->editor->setText(text, false);
+        textbox->editor->moveCaretToEnd();
     }
 
+    props.set("consolePosition", reader.position);
+    props.set("consoleShownFrom", reader.shownFrom);
 }
 //==============================================================================
 //update frames displayed by layout editor
@@ -108,6 +108,21 @@ public:
     ~PointData() {}
 };
 
+//==============================================================================
+// regenerates edited gentables at most once per display frame, however
+// quickly their handles are being dragged
+//==============================================================================
+class CabbagePluginAudioProcessorEditor;
+class TableEditTimer : public Timer
+{
+public:
+    TableEditTimer(CabbagePluginAudioProcessorEditor& editor): owner(editor) {}
+    void timerCallback();
+
+private:
+    CabbagePluginAudioProcessorEditor& owner;
+};
+
 //==============================================================================
 // main GUI editor window
 //==============================================================================
@@ -132,6 +147,7 @@ public:
     void resized();
     void setEditMode(bool on);
     void InsertGUIControls(CabbageGUIType cAttr);
+    void flushTableEdits();
     void ksmpsYieldCallback();
     void updateSize();
     //used in Android mode to rescale according to screen res
@@ -139,6 +155,14 @@ public:
     //main GUI controls vectors..
     OwnedArray<Component> comps;
     OwnedArray<Component> layoutComps;
+    //lets a reload keep the components of widgets that haven't changed
+    void beginWidgetRebuild();
+    bool isRebuildingWidgets() const
+    {
+        return rebuildingWidgets;
+    }
+    bool reuseWidgetComponent(bool isLayout, int previousIndex, int index, CabbageGUIType& cAttr);
+    void endWidgetRebuild(const StringArray& widgetTypes);
     void updateLayoutEditorFrames();
     ScopedPointer<CabbageTable> cabTable;
     ScopedPointer<CabbageCornerResizer> resizer;
@@ -223,18 +247,45 @@ private:
     void restoreParametersFromPresets(XmlElement* xmlData);
     void savePresetsFromParameters(File selectedFile, String mode);
     void refreshDiskReadingGUIControls(String typeOfControl);
-    void updatefTableData(GenTable* table);
-    bool checkForIdentifierMessage(CabbageGUIType cAttr, String type)
+    bool updatefTableData(GenTable* table);
+    void queueTableEdit(GenTable* table);
+    Array<Component::SafePointer<GenTable> > pendingTableEdits;
+    TableEditTimer tableEditTimer;
+    //updateGUIControls() passes each dirty widget to the updater for its kind
+    typedef void (CabbagePluginAudioProcessorEditor::*WidgetUpdater)(CabbageGUIType& cAttr, Component* comp, int index);
+    static WidgetUpdater getWidgetUpdater(CabbageGUIType::WidgetKind kind, bool isLayout);
+    void updateWidget(bool isLayout, int index);
+    template <class WidgetType>
+    void updateFromIdentMessage(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateSliderValue(Slider* slider, int index);
+    void updateSliderWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateNumberBoxWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateButtonWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateXYPadWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateComboBoxWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateCheckBoxWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateRangeWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateOutputConsoleWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateGroupBoxWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateSoundfilerWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateTableWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateGenTableWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    void updateFFTDisplayWidget(CabbageGUIType& cAttr, Component* comp, int index);
+    Array<int> dirtyWidgetIndices;
+    //records which version of a table comp is showing. Returns false if it already shows this one
+    bool isNewTableVersion(Component* comp, int tableNumber, const CabbageTableSnapshot* snapshot)
     {
-        if(cAttr.getStringProp(CabbageIDs::type).equalsIgnoreCase(type) &&
-                cAttr.getStringProp(CabbageIDs::identchannelmessage).isNotEmpty())
-            return true;
-
-        else
+        if(snapshot==nullptr)
+            return false;
+        const Identifier versionID("tableVersion"+String(tableNumber));
+        if(comp->getProperties().contains(versionID) && (int)comp->getProperties()[versionID]==(int)snapshot->version)
             return false;
+        comp->getProperties().set(versionID, (int)snapshot->version);
+        return true;
     }
     void timerCallback();
     int csoundOutputWidget;
+    void updateCsoundOutputWidget(CabbageTextbox* textbox);
     int mouseX, mouseY;
     bool LOCKED;
     void insertComponentsFromCabbageText(StringArray text, bool useOffset);
@@ -283,6 +334,8 @@ private:
     String formPic;
     float inValue;
     int xyPadIndex;
+    bool rebuildingWidgets, reusedWidgets;
+    OwnedArray<Component> previousComps, previousLayoutComps;
     ScopedPointer<CabbageLookAndFeel> lookAndFeel;
     ScopedPointer<CabbageLookAndFeelBasic> basicLookAndFeel;
     ScopedPointer<Label> debugLabel;
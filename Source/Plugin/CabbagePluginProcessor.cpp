@@ -87,8 +87,16 @@ CabbagePluginAudioProcessor::CabbagePluginAudioProcessor(String inputfile, bool
      firstTime(true),
      isMuted(false),
      isBypassed(false),
-     vuCounter(0),
-     updateFFTDisplay(false)
+     runningCsdHash(0),
+    oversampling(1),
+    recompileOversampling(1),
+    latencyMode(bufferedLatency),
+    reportedDroppedMessages(0),
+    alignKsmps(false),
+    alignedKsmps(0),
+    preparedBlockSize(0),
+    hostRecompilePending(false),
+    compiledAsPlugin(false)
 {
     codeEditor = nullptr;
     if(compileCsoundAndCreateGUI(false)==0)
@@ -129,9 +137,17 @@ CabbagePluginAudioProcessor::CabbagePluginAudioProcessor(String sourcefile, Poin
     firstTime(false),
     isMuted(false),
     isBypassed(false),
-    vuCounter(0),
     scale(instrScale),
-    updateFFTDisplay(false)
+    runningCsdHash(0),
+    oversampling(1),
+    recompileOversampling(1),
+    latencyMode(bufferedLatency),
+    reportedDroppedMessages(0),
+    alignKsmps(false),
+    alignedKsmps(0),
+    preparedBlockSize(0),
+    hostRecompilePending(false),
+    compiledAsPlugin(false)
 {
     //If a sourcefile is not given, Cabbage plugins always try to load a csd file with the same name as the plugin library.
     //Therefore we need to find the name of the library and append a '.csd' to it.
@@ -223,26 +239,26 @@ CabbagePluginAudioProcessor::~CabbagePluginAudioProcessor()
 //============================================================================
 //SET SCREEN WIDTH AND SCREEN HEIGHT MACROS
 //============================================================================
-void CabbagePluginAudioProcessor::setScreenMacros()
+void CabbagePluginAudioProcessor::setScreenMacros(CabbageCsound* instance)
 {
 //android opens full screen by default.
 #ifdef AndroidBuild
     Rectangle<int> rect(Desktop::getInstance().getDisplays().getMainDisplay().userArea);
     String screenWidth = "--omacro:SCREEN_WIDTH=\""+String(rect.getWidth()-60)+"\"";
-    csound->SetOption(screenWidth.toUTF8().getAddress());
+    instance->SetOption(screenWidth.toUTF8().getAddress());
     String screenHeight = "--omacro:SCREEN_HEIGHT=\""+String(rect.getHeight()-60)+"\"";
-    csound->SetOption(screenHeight.toUTF8().getAddress());
+    instance->SetOption(screenHeight.toUTF8().getAddress());
 #else
     String width = "--omacro:SCREEN_WIDTH=\""+String(screenWidth)+"\"";
-    csound->SetOption(width.toUTF8().getAddress());
+    instance->SetOption(width.toUTF8().getAddress());
     String height = "--omacro:SCREEN_HEIGHT=\""+String(screenHeight)+"\"";
-    csound->SetOption(height.toUTF8().getAddress());
+    instance->SetOption(height.toUTF8().getAddress());
 #endif
 }
 //============================================================================
 //FIND MACROS AND ADD THEM TO SETUP OPTIONS
 //============================================================================
-void CabbagePluginAudioProcessor::addMacros(String csdText)
+void CabbagePluginAudioProcessor::addMacros(CabbageCsound* instance, String csdText)
 {
     StringArray csdArray;
     String macroName, macroText;
@@ -259,7 +275,7 @@ void CabbagePluginAudioProcessor::addMacros(String csdText)
             tokens.remove(0);
             macroText = "\\\"" + tokens.joinIntoString(" ").replace("\"", "\\\\\\\"")+"\\\"";
             String fullMacro = "--omacro:"+macroName+"="+macroText+"\"";
-            csound->SetOption(fullMacro.toUTF8().getAddress());
+            instance->SetOption(fullMacro.toUTF8().getAddress());
         }
 
         if(csdArray[i].contains("</Cabbage>"))
@@ -267,44 +283,168 @@ void CabbagePluginAudioProcessor::addMacros(String csdText)
     }
 }
 
+//the widgets' values are written straight into the new instance rather than
+//queued. Anything still in the queue, such as values setStateInformation() or the
+//host sent while a recompile was running, is newer and gets applied after them
 void CabbagePluginAudioProcessor::initAllChannels()
 {
-    //init all channels with their init val, and set parameters
+    setInitialChannelValues(csound);
+    this->updateCabbageControls();
+}
+
+//============================================================================
+//INIT ALL CHANNELS WITH THEIR INIT VAL. THE INSTANCE DOESN'T HAVE TO BE THE
+//ONE THAT IS CURRENTLY RUNNING, SEE recompileCsound()
+//============================================================================
+void CabbagePluginAudioProcessor::setInitialChannelValues(CabbageCsound* instance)
+{
     for(int i=0; i<guiCtrls.size(); i++)
     {
         //		Logger::writeToLog(guiCtrls.getReference(i).getStringProp(CabbageIDs::channel)+": "+String(guiCtrls[i].getNumProp(CabbageIDs::value)));
         if(guiCtrls.getReference(i).getStringProp("channeltype")=="string")
             //deal with combobox strings..
-            csound->SetChannel(guiCtrls.getReference(i).getStringProp(CabbageIDs::channel).toUTF8(), "");
+            instance->SetChannel(guiCtrls.getReference(i).getStringProp(CabbageIDs::channel).toUTF8(), "");
         //									guiCtrls.getReference(i).getStringArrayPropValue("text", guiCtrls[i].getNumProp(CabbageIDs::value)-1).toUTF8().getAddress());
         else
         {
             if(guiCtrls.getReference(i).getStringProp(CabbageIDs::type)==CabbageIDs::hrange ||
                     guiCtrls.getReference(i).getStringProp(CabbageIDs::type)==CabbageIDs::vrange)
             {
-                csound->SetChannel( guiCtrls.getReference(i).getStringArrayPropValue(CabbageIDs::channel, 0).toUTF8(), guiCtrls[i].getNumProp(CabbageIDs::minvalue));
-                csound->SetChannel( guiCtrls.getReference(i).getStringArrayPropValue(CabbageIDs::channel, 1).toUTF8(), guiCtrls[i].getNumProp(CabbageIDs::maxvalue));
+                instance->SetChannel( guiCtrls.getReference(i).getStringArrayPropValue(CabbageIDs::channel, 0).toUTF8(), guiCtrls[i].getNumProp(CabbageIDs::minvalue));
+                instance->SetChannel( guiCtrls.getReference(i).getStringArrayPropValue(CabbageIDs::channel, 1).toUTF8(), guiCtrls[i].getNumProp(CabbageIDs::maxvalue));
             }
             else
-                csound->SetChannel( guiCtrls.getReference(i).getStringProp(CabbageIDs::channel).toUTF8(), guiCtrls[i].getNumProp(CabbageIDs::value));
+                instance->SetChannel( guiCtrls.getReference(i).getStringProp(CabbageIDs::channel).toUTF8(), guiCtrls[i].getNumProp(CabbageIDs::value));
         }
-
-
-        messageQueue.addOutgoingChannelMessageToQueue(guiCtrls.getReference(i).getStringProp(CabbageIDs::channel),
-                guiCtrls.getReference(i).getNumProp(CabbageIDs::value), guiCtrls.getReference(i).getStringProp(CabbageIDs::type));
     }
 
-    //init all channels with their init val, and set parameters
     for(int i=0; i<guiLayoutCtrls.size(); i++)
     {
         if(guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::type).equalsIgnoreCase("texteditor"))
-            csound->SetChannel(guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::channel).toUTF8(),
-                               guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::text).toUTF8().getAddress());
+            instance->SetChannel(guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::channel).toUTF8(),
+                                 guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::text).toUTF8().getAddress());
         if(guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::identchannel).isNotEmpty())
             //deal with combobox strings..
-            csound->SetChannel(guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::identchannel).toUTF8(), "");
+            instance->SetChannel(guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::identchannel).toUTF8(), "");
     }
-    this->updateCabbageControls();
+}
+
+//============================================================================
+//RESOLVE ALL WIDGET AND HOST CHANNELS TO CSOUND CHANNEL POINTERS. MUST BE
+//CALLED AFTER EVERY SUCCESSFUL COMPILE, AND WHILE THE AUDIO THREAD IS LOCKED OUT
+//============================================================================
+void CabbagePluginAudioProcessor::bindCsoundChannels()
+{
+#ifndef Cabbage_No_Csound
+    channelBindings.clear();
+    identMailbox.clear(0);
+    if(csound==nullptr || csCompileResult!=OK)
+        return;
+
+    //channels the new orchestra no longer uses give their queue slots back
+    messageQueue.reclaimChannelSlots();
+    allocateIdentMailbox();
+
+    resolveCsoundChannels(csound, channelBindings, channelSmoother);
+
+    //presets leave the morph control, snapshot selectors and string channels alone
+    StringArray presetChannels;
+    for(int i=0; i<guiCtrls.size(); i++)
+    {
+        CabbageGUIType &guiCtrl = guiCtrls.getReference(i);
+        if(guiCtrl.isStringChannel() || guiCtrl.getStringProp(CabbageIDs::channel)==CabbageIDs::presetmorph
+                || guiCtrl.getStringProp("filetype").contains("snaps"))
+            presetChannels.add(String::empty);
+        else
+            presetChannels.add(guiCtrl.getStringProp(CabbageIDs::channel));
+    }
+    presetBank.mapToControls(presetChannels, channelBindings.getHostChannel(CabbageChannelBindings::presetMorph));
+#endif
+}
+
+//layout widgets follow the interactive ones in the identchannel mailbox. Only
+//call this while the audio thread is locked out
+void CabbagePluginAudioProcessor::allocateIdentMailbox()
+{
+    identMailbox.clear(guiCtrls.size()+guiLayoutCtrls.size());
+    for(int i=0; i<guiCtrls.size(); i++)
+        if(guiCtrls.getReference(i).getStringProp(CabbageIDs::identchannel).isNotEmpty())
+            identMailbox.allocateEntry(i);
+    for(int i=0; i<guiLayoutCtrls.size(); i++)
+        if(guiLayoutCtrls.getReference(i).getStringProp(CabbageIDs::identchannel).isNotEmpty())
+            identMailbox.allocateEntry(guiCtrls.size()+i);
+}
+
+//============================================================================
+//FILLS bindings AND smoother FOR instance. THE AUDIO THREAD MUSTN'T BE USING
+//EITHER OF THEM, BUT IT CAN BE PLAYING ANOTHER INSTANCE, SEE swapInCompiledCsound()
+//============================================================================
+void CabbagePluginAudioProcessor::resolveCsoundChannels(CabbageCsound* instance, CabbageChannelBindings& bindings, CabbageChannelSmoother& smoother)
+{
+#ifndef Cabbage_No_Csound
+    bindings.clear();
+    smoother.clear(guiCtrls.size());
+    for(int i=0; i<guiCtrls.size(); i++)
+    {
+        CabbageGUIType &guiCtrl = guiCtrls.getReference(i);
+        MYFLT* value = nullptr;
+        int slot = -1;
+        //string channels are still sent through the message queue
+        if(!guiCtrl.getStringProp(CabbageIDs::channeltype).equalsIgnoreCase(CabbageIDs::stringchannel))
+        {
+            value = CabbageChannelBindings::resolveControlChannel(instance, guiCtrl.getStringProp(CabbageIDs::channel));
+            slot = messageQueue.getChannelSlot(guiCtrl.getStringProp(CabbageIDs::channel));
+            bindings.addSlotControl(slot, value, guiCtrl.getNumProp(CabbageIDs::smooth)>0 ? i : -1);
+        }
+
+        if(guiCtrl.getNumProp(CabbageIDs::smooth)>0)
+            smoother.addControl(i, value, guiCtrl.getNumProp(CabbageIDs::smooth),
+                                guiCtrl.getStringProp(CabbageIDs::smoothmode).equalsIgnoreCase("linear"),
+                                guiCtrl.getNumProp(CabbageIDs::max)-guiCtrl.getNumProp(CabbageIDs::min));
+
+        const String identChannel(guiCtrl.getStringProp(CabbageIDs::identchannel));
+        bindings.addControl(value, slot, CabbageChannelBindings::resolveStringChannel(instance, identChannel), identChannel);
+    }
+
+    for(int i=0; i<guiLayoutCtrls.size(); i++)
+    {
+        CabbageGUIType &guiLayoutCtrl = guiLayoutCtrls.getReference(i);
+        Array<MYFLT*> tableChannels;
+        if(guiLayoutCtrl.getStringProp(CabbageIDs::type)==CabbageIDs::table)
+        {
+            const StringArray channels = guiLayoutCtrl.getStringArrayProp(CabbageIDs::channel);
+            for(int y=0; y<channels.size(); y++)
+            {
+                MYFLT* value = CabbageChannelBindings::resolveControlChannel(instance, channels[y]);
+                tableChannels.add(value);
+                bindings.addSlotControl(messageQueue.getChannelSlot(channels[y]), value);
+            }
+        }
+
+        const String identChannel(guiLayoutCtrl.getStringProp(CabbageIDs::identchannel));
+        bindings.addLayoutControl(CabbageChannelBindings::resolveStringChannel(instance, identChannel), identChannel, tableChannels);
+    }
+
+    bindings.setHostChannelPtr(CabbageChannelBindings::hostBpm, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::hostbpm));
+    bindings.setHostChannelPtr(CabbageChannelBindings::timeInSeconds, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::timeinseconds));
+    bindings.setHostChannelPtr(CabbageChannelBindings::isPlaying, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::isplaying));
+    bindings.setHostChannelPtr(CabbageChannelBindings::isRecording, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::isrecording));
+    bindings.setHostChannelPtr(CabbageChannelBindings::hostPPQPos, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::hostppqpos));
+    bindings.setHostChannelPtr(CabbageChannelBindings::timeInSamples, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::timeinsamples));
+    bindings.setHostChannelPtr(CabbageChannelBindings::timeSigDenom, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::timeSigDenom));
+    bindings.setHostChannelPtr(CabbageChannelBindings::timeSigNum, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::timeSigNum));
+    bindings.setHostChannelPtr(CabbageChannelBindings::cpuLoad, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::cpuload));
+    bindings.setHostChannelPtr(CabbageChannelBindings::presetMorph, CabbageChannelBindings::resolveControlChannel(instance, CabbageIDs::presetmorph));
+    smoother.prepare(instance->GetSr()/instance->GetKsmps());
+
+    //mouse channels are written by the editor through the message queue
+    const String mouseChannels[] = { CabbageIDs::mousex, CabbageIDs::mousey, CabbageIDs::mousedownleft,
+                                     CabbageIDs::mousedownright, CabbageIDs::mousedownlmiddle
+                                   };
+    for(int i=0; i<numElementsInArray(mouseChannels); i++)
+        bindings.addSlotControl(messageQueue.getChannelSlot(mouseChannels[i]),
+                                CabbageChannelBindings::resolveControlChannel(instance, mouseChannels[i]));
+#endif
 }
 
 //============================================================================
@@ -349,56 +489,39 @@ int CabbagePluginAudioProcessor::compileCsoundAndCreateGUI(bool isPlugin)
     //csound->setOpenSlCallbacks(); // for android audio to work
 #endif
 
-    csound->SetHostImplementedMIDIIO(true);
-    csound->SetHostData(this);
     midiOutputBuffer.clear();
-    csound->CreateMessageBuffer(0);
-    csound->SetExternalMidiInOpenCallback(OpenMidiInputDevice);
-    csound->SetExternalMidiReadCallback(ReadMidiData);
-    csound->SetExternalMidiOutOpenCallback(OpenMidiOutputDevice);
-    csound->SetExternalMidiWriteCallback(WriteMidiData);
-
-
-    csound->SetIsGraphable(true);
-    csound->SetMakeGraphCallback(makeGraphCallback);
-    csound->SetDrawGraphCallback(drawGraphCallback);
-    csound->SetKillGraphCallback(killGraphCallback);
-    csound->SetExitGraphCallback(exitGraphCallback);
-
+    midiInputQueue.malloc(midiInputQueueSize);
+    midiInputQueueUsed = 0;
+    midiReadPosition = 0;
+    midiWritePosition = 0;
+    configureCsoundInstance(csound);
 
     csoundChanList = NULL;
     numCsoundChannels = 0;
     csndIndex = 32;
+    retiringSpin = nullptr;
+    retiringSpout = nullptr;
+    retiringScale = 1;
+    crossfadeLength = 0;
+    crossfadePosition = 0;
+    preparedCsoundTime = 0;
     startTimer(20);
 
-    csoundParams = nullptr;
-    csoundParams = new CSOUND_PARAMS();
-#ifndef CABBAGE_HOST
-    csoundParams->nchnls_override = this->getNumOutputChannels();
-#endif
-
-    csoundParams->sample_rate_override = this->getSampleRate();
-    csoundParams->control_rate_override = cUtils::getKrFromFile(csdFile.getFullPathName(), (int)getSampleRate());
-
-
-    csoundParams->displays = 0;
-    csound->SetParams(csoundParams);
-    csound->SetOption((char*)"-n");
-    csound->SetOption((char*)"-d");
-    if(isPlugin)
-        csound->SetOption((char*)"--omacro:IS_A_PLUGIN=\"1\"");
-
-#ifdef AndroidBuild
-    csound->SetOption((char*)"--omacro:IS_ANDROID=\"1\"");
-#endif
-    setScreenMacros();
-    addMacros(csdFile.loadFileAsString());
+    const String csdText(csdFile.loadFileAsString());
+    oversampling = cUtils::getOversamplingFromFile(csdText);
+    oversampler = nullptr;
+    compiledAsPlugin = isPlugin;
+    setCompileOptions(csound, csdFile, csdText, oversampling);
+    runningCsdHash = 0;
     csCompileResult = csound->Compile(const_cast<char*>(csdFile.getFullPathName().toUTF8().getAddress()));
     //csoundSetBreakpointCallback(csound->GetCsound(), breakpointCallback, (void*)this);
     csdFile.getParentDirectory().setAsCurrentWorkingDirectory();
     if(csCompileResult==OK)
     {
+        runningCsdHash = csdText.hashCode64();
+        bindCsoundChannels();
         initAllChannels();
+        loadPresetBank(getPresetBankFile());
         firstTime=false;
         guiRefreshRate = getCsoundKsmpsSize()*2;
 
@@ -424,8 +547,15 @@ int CabbagePluginAudioProcessor::compileCsoundAndCreateGUI(bool isPlugin)
         CSspout = csound->GetSpout();
         CSspin  = csound->GetSpin();
         cs_scale = csound->Get0dBFS();
-        csndIndex = csound->GetKsmps();
-        this->setLatencySamples(csound->GetKsmps());
+        csndIndex = getCsoundKsmpsSize();
+        if(oversampling>1)
+        {
+            oversampler = new CabbageOversampler(oversampling);
+            prepareOversampler(oversampler, getCsoundKsmpsSize());
+        }
+        latencyMode = bufferedLatency;
+        chooseLatencyMode();
+        this->setLatencySamples(getReportedLatency());
         updateHostDisplay();
         csoundStatus = true;
         debugMessageArray.add(VERSION);
@@ -476,6 +606,9 @@ int CabbagePluginAudioProcessor::compileCsoundAndCreateGUI(bool isPlugin)
         if(getActiveEditor() && getPreference(appProperties, "DisableCompilerErrorWarning")==0)
             showMessage(message, &getActiveEditor()->getLookAndFeel());
         csoundStatus=false;
+        //no widgets will be added, so drop the components set aside for reuse
+        if(CabbagePluginAudioProcessorEditor* editor = dynamic_cast<CabbagePluginAudioProcessorEditor*>(getActiveEditor()))
+            editor->endWidgetRebuild(getWidgetTypes());
         return 0;
     }
 #endif
@@ -486,173 +619,311 @@ int CabbagePluginAudioProcessor::compileCsoundAndCreateGUI(bool isPlugin)
 }
 //============================================================================
 //RECOMPILE CSOUND. THIS IS CALLED FROM THE PLUGIN HOST WHEN UDPATES ARE MADE ON THE FLY
+//THE NEW ORCHESTRA IS COMPILED IN A SECOND INSTANCE ON A WORKER THREAD WHILE THE CURRENT
+//ONE KEEPS PLAYING. timerCallback() SWAPS IT IN WHEN IT'S READY. WHEN inBackground IS FALSE
+//THE COMPILE HAPPENS HERE AND THE NEW INSTANCE REPLACES THE OLD ONE WITHOUT A CROSSFADE
 //============================================================================
-int CabbagePluginAudioProcessor::recompileCsound(File file)
+int CabbagePluginAudioProcessor::recompileCsound(File file, bool inBackground)
 {
 #ifndef Cabbage_No_Csound
+    //a newer edit replaces anything that is still compiling. Deleting the old
+    //thread would wait for its compile, so it's left to finish on its own
+    if(compileThread!=nullptr)
+    {
+        compileThread->signalThreadShouldExit();
+        supersededCompiles.add(compileThread.release());
+    }
+    hostRecompilePending = false;
 
-    stopProcessing = true;
-    getCallbackLock().enter();
-    numChannelsChanged();
-    midiOutputBuffer.clear();
-    //csound->DeleteChannelList(csoundChanList);
+    CabbageCsound* instance = new CabbageCsound();
+    configureCsoundInstance(instance);
 
-    //cUtils::debug(file.loadFileAsString());
+    const String csdText(file.loadFileAsString());
+    recompileOversampling = cUtils::getOversamplingFromFile(csdText);
+    setCompileOptions(instance, file, csdText, recompileOversampling);
+    recompileCsdHash = csdText.hashCode64();
+    setInitialChannelValues(instance);
+    file.getParentDirectory().setAsCurrentWorkingDirectory();
 
-    csound->DestroyMessageBuffer();
-    //csound = nullptr;
-    //csound = new Csound();
-    csound->Reset();
-    ksmpsOffset = 0;
-    breakCount = 0;
+    recompileFile = file;
+    compileThread = new CsoundCompileThread(instance, file);
 
-    csound->SetHostImplementedMIDIIO(true);
-    csound->SetHostData(this);
-    csound->CreateMessageBuffer(0);
-    csound->SetExternalMidiInOpenCallback(OpenMidiInputDevice);
-    csound->SetExternalMidiReadCallback(ReadMidiData);
-    csound->SetExternalMidiOutOpenCallback(OpenMidiOutputDevice);
-    csound->SetExternalMidiWriteCallback(WriteMidiData);
-    //csound->SetIsGraphable(0);
-
-    csound->SetIsGraphable(true);
-    csound->SetMakeGraphCallback(makeGraphCallback);
-    csound->SetDrawGraphCallback(drawGraphCallback);
-    csound->SetKillGraphCallback(killGraphCallback);
-    csound->SetExitGraphCallback(exitGraphCallback);
+    if(inBackground)
+    {
+        compileThread->startThread();
+        return OK;
+    }
 
-    csoundParams = nullptr;
-    csoundParams = new CSOUND_PARAMS();
-#ifndef CABBAGE_HOST
-    csoundParams->nchnls_override =2;
+    compileThread->run();
+    swapInCompiledCsound(false);
+    return csCompileResult;
 #endif
-    csoundParams->displays = 0;
-    //csoundParams->sample_rate_override = this->getSampleRate();
-    //csoundParams->control_rate_override = cUtils::getKrFromFile(file.getFullPathName(), (int)getSampleRate());
-    csound->SetParams(csoundParams);
-    csound->SetOption((char*)"-n");
-    //csound->SetOption((char*)"-d");
+}
 
-    setScreenMacros();
+//============================================================================
+//SETS UP HOST CALLBACKS FOR A NEW CSOUND INSTANCE
+//============================================================================
+void CabbagePluginAudioProcessor::configureCsoundInstance(CabbageCsound* instance)
+{
+#ifndef Cabbage_No_Csound
+    instance->SetHostImplementedMIDIIO(true);
+    instance->SetHostData(this);
+    instance->SetMessageCallback(messageCallback);
+    instance->SetExternalMidiInOpenCallback(OpenMidiInputDevice);
+    instance->SetExternalMidiReadCallback(ReadMidiData);
+    instance->SetExternalMidiOutOpenCallback(OpenMidiOutputDevice);
+    instance->SetExternalMidiWriteCallback(WriteMidiData);
+
+    instance->SetIsGraphable(true);
+    instance->SetMakeGraphCallback(makeGraphCallback);
+    instance->SetDrawGraphCallback(drawGraphCallback);
+    instance->SetKillGraphCallback(killGraphCallback);
+    instance->SetExitGraphCallback(exitGraphCallback);
+#endif
+}
 
-    addMacros(file.loadFileAsString());
-    csound->SetHostImplementedMIDIIO(true);
-    xyAutosCreated = false;
-    numCsoundChannels = 0;
+//============================================================================
+//HANDS THE INSTANCE BUILT BY recompileCsound() OVER TO THE AUDIO THREAD. ITS CHANNELS
+//ARE RESOLVED AND GIVEN THEIR VALUES HERE WHILE THE CURRENT INSTANCE KEEPS PLAYING,
+//AND processBlock() TAKES IT OVER AT ITS NEXT K-CYCLE BOUNDARY. IF REQUESTED, AND BOTH
+//INSTANCES RUN AT THE SAME KSMPS, THE OLD ONE KEEPS RUNNING UNTIL processBlock() HAS
+//FADED IT OUT. A COMPILE THE CALLER IS WAITING FOR, OR ONE WITH NOTHING PLAYING,
+//IS SWAPPED IN STRAIGHT AWAY
+//============================================================================
+void CabbagePluginAudioProcessor::swapInCompiledCsound(bool crossfade)
+{
+#ifndef Cabbage_No_Csound
+    const int result = compileThread->getCompileResult();
+    ScopedPointer<CabbagePreparedCsound> prepared(new CabbagePreparedCsound());
+    prepared->instance = compileThread->releaseInstance();
+    compileThread = nullptr;
+    const bool hostRecompile = hostRecompilePending;
+    hostRecompilePending = false;
+
+    if(result!=OK)
+    {
+        //leave the current instance playing, its messages are already in the console.
+        //Nobody asked for a compile the host caused, so that one only goes to the log
+        Logger::writeToLog("Csound couldn't compile your file");
+        String message= "Csound couldn't compile your file. Please check the Csound output console for more information\n\nYou can disable this warning from the Options->Preference menu.";
+        if(!hostRecompile && getActiveEditor() && getPreference(appProperties, "DisableCompilerErrorWarning")==0)
+            showMessage(message, &getActiveEditor()->getLookAndFeel());
+        return;
+    }
 
+    CabbageCsound* instance = prepared->instance;
+    const bool running = csCompileResult==OK && csound!=nullptr && csoundStatus && !stopProcessing;
+    const bool swapNow = !crossfade || !running;
 
-    CSspout = nullptr;
-    CSspin = nullptr;
-    //csound->Stop();
+    prepared->oversampling = recompileOversampling;
+    if(recompileOversampling>1)
+    {
+        prepared->oversampler = new CabbageOversampler(recompileOversampling);
+        prepareOversampler(prepared->oversampler, instance->GetKsmps()/recompileOversampling);
+    }
+
+    //the crossfade works on host rate samples, so oversampled instruments switch without one.
+    //adoptPreparedCsound() checks again that the two instances still match
+    if(!swapNow && instance->GetKsmps()==csdKsmps && instance->GetNchnls()==csound->GetNchnls()
+            && instance->GetSr()==csound->GetSr()
+            && oversampling==1 && recompileOversampling==1)
+    {
+        //equal power, rounded up to whole k-cycles
+        int fadeLength = jmax(0, roundToInt(getSampleRate()*recompileCrossfadeTime/1000.0));
+        fadeLength = ((fadeLength+csdKsmps-1)/csdKsmps)*csdKsmps;
+        prepared->fadeGains.malloc(jmax(1, fadeLength));
+        for(int i=0; i<fadeLength; i++)
+            prepared->fadeGains[i] = std::sin((i+0.5)/fadeLength*float_Pi*0.5);
+        prepared->fadeLength = fadeLength;
+    }
 
+    //the instrument hasn't changed, so the new instance carries on from the
+    //values the old one has now
+    if(hostRecompile && running)
+    {
+        const ScopedLock sl(getCallbackLock());
+        updateCabbageControls();
+    }
 
-    csCompileResult = csound->Compile(const_cast<char*>(file.getFullPathName().toUTF8().getAddress()));
-    file.getParentDirectory().setAsCurrentWorkingDirectory();
-    initAllChannels();
+    //nothing plays the new instance yet, so its channels are set up without locking
+    //the audio thread out. Values still in the queue, such as those setStateInformation()
+    //or the host sent while the compile was running, are newer and get applied after these
+    setInitialChannelValues(instance);
+    resolveCsoundChannels(instance, prepared->bindings, prepared->smoother);
+    prepared->csdHash = recompileCsdHash;
+
+#ifdef WIN32
+    instance->SetChannel("CSD_PATH", recompileFile.getParentDirectory().getFullPathName().replace("\\", "\\\\").toUTF8().getAddress());
+#else
+    instance->SetChannel("CSD_PATH", recompileFile.getParentDirectory().getFullPathName().toUTF8().getAddress());
+#endif
+    instance->SetChannel("IS_A_PLUGIN", compiledAsPlugin ? 1.0 : 0.0);
 
 #ifdef BUILD_DEBUGGER
     for(int i=0; i<breakpointInstruments.size(); i++)
     {
-        getCallbackLock().enter();
         if(i==0)
-            csoundDebuggerInit(csound->GetCsound());
-        csoundSetBreakpointCallback(csound->GetCsound(), breakpointCallback, (void*)this);
-        csoundSetInstrumentBreakpoint(csound->GetCsound(), breakpointInstruments[i], 0);
-        getCallbackLock().exit();
+            csoundDebuggerInit(instance->GetCsound());
+        csoundSetBreakpointCallback(instance->GetCsound(), breakpointCallback, (void*)this);
+        csoundSetInstrumentBreakpoint(instance->GetCsound(), breakpointInstruments[i], 0);
     }
 #endif
 
-    StringArray lines, includeFiles;
-    lines.addLines(file.loadFileAsString());
+    ScopedPointer<CabbagePreparedCsound> superseded, replaced;
+    {
+        const ScopedLock sl(getCallbackLock());
+        //a compile the audio thread hasn't got round to yet is replaced by this one
+        superseded = preparedCsound.release();
+        replaced = replacedCsound.release();
+        csoundReplaced.set(0);
+        preparedCsound = prepared.release();
+        preparedCsoundPending.set(1);
+        preparedCsoundTime = Time::getMillisecondCounter();
+
+        //bindCsoundChannels() leaves the mailbox empty if there was no instance to bind
+        if(identMailbox.getNumEntries()!=guiCtrls.size()+guiLayoutCtrls.size())
+            allocateIdentMailbox();
+        if(swapNow)
+            adoptPreparedCsound();
+    }
 
-    for(int i=0; i<lines.size(); i++)
-        if(lines[i].contains("include("))
-        {
-            CabbageGUIType cAttr(lines[i], -99);
-            for(int y=0; y<cAttr.getStringArrayProp(CabbageIDs::include).size(); y++)
-            {
-                String infile = cAttr.getStringArrayPropValue(CabbageIDs::include, y);
-                if(!File::isAbsolutePath(infile))
-                {
-                    String ifile = returnFullPathForFile(infile, file.getParentDirectory().getFullPathName());
-                    includeFiles.add(ifile);
-                }
-                else
-                    includeFiles.add(infile);
-            }
-            break;
-        }
+    numChannelsChanged();
+    xyAutosCreated = false;
+    numCsoundChannels = 0;
+    firstTime=false;
+    keyboardState.allNotesOff(0);
+    keyboardState.reset();
 
-    includeFiles.removeDuplicates(0);
+    Logger::writeToLog("Csound compiled your file");
+    if(swapNow)
+        setLatencySamples(getReportedLatency());
 
+    debugMessageArray.add(CABBAGE_VERSION);
+    debugMessageArray.add(String("\n"));
 
-    if(csCompileResult==OK)
-    {
-        firstTime=false;
-        keyboardState.allNotesOff(0);
-        keyboardState.reset();
+    //presets belong to the file they were stored with
+    const File bankFile = recompileFile.withFileExtension(".snapbank");
+    if(bankFile!=presetBankFile)
+        loadPresetBank(bankFile);
+#endif
+}
 
-        //simple hack to allow tables to be set up correctly.
-        csound->PerformKsmps();
-        csound->SetScoreOffsetSeconds(0);
-        csound->RewindScore();
-        for(int i=0; i<includeFiles.size(); i++)
-        {
-            //	csound->CompileOrc(File(includeFiles[i]).loadFileAsString().toUTF8().getAddress());
-            //	csound->InputMessage("i\"PROCESSOR\" 0 3600 1");
-        }
-        csndIndex = 0;
-        CSspout = csound->GetSpout();
-        CSspin  = csound->GetSpin();
-        //csound->PerformKsmps();
-        //csound->SetScoreOffsetSeconds(0);
-        //csound->RewindScore();
-        Logger::writeToLog("Csound compiled your file");
-        //numCsoundChannels = csoundListChannels(csound->GetCsound(), &csoundChanList);
-        cs_scale = csound->Get0dBFS();
-        csoundStatus = true;
+//============================================================================
+//MAKES THE INSTANCE swapInCompiledCsound() PREPARED THE CURRENT ONE. processBlock()
+//CALLS THIS BETWEEN K-CYCLES, SO THE OUTGOING INSTANCE FINISHES THE ONE IT IS IN.
+//ONLY POINTERS CHANGE HANDS, AND WHATEVER IS REPLACED IS LEFT FOR THE MESSAGE
+//THREAD TO DELETE, SEE deleteReplacedCsound()
+//============================================================================
+void CabbagePluginAudioProcessor::adoptPreparedCsound()
+{
+#ifndef Cabbage_No_Csound
+    const ScopedLock sl(getCallbackLock());
+    if(preparedCsound==nullptr)
+        return;
+
+    CabbagePreparedCsound& prepared = *preparedCsound;
+    CabbageCsound* incoming = prepared.instance.release();
+    const bool fade = prepared.fadeLength>0 && csCompileResult==OK && csound!=nullptr
+                      && incoming->GetKsmps()==csound->GetKsmps() && incoming->GetNchnls()==csound->GetNchnls()
+                      && oversampling==1 && prepared.oversampling==1;
+
+    //an instance that is still being faded out stops here
+    prepared.retired = retiringCsound.release();
+    if(fade)
+    {
+        retiringCsound = csound.release();
+        retiringSpin = CSspin;
+        retiringSpout = CSspout;
+        retiringScale = cs_scale;
+        crossfadeGains.swapWith(prepared.fadeGains);
+        crossfadeLength = prepared.fadeLength;
+        crossfadePosition = 0;
+        retiringCsoundFinished.set(0);
+    }
+    else
+        prepared.instance = csound.release();
+    csound = incoming;
 
-        //init all channels with their init val
-        for(int i=0; i<guiCtrls.size(); i++)
-        {
-            messageQueue.addOutgoingChannelMessageToQueue(guiCtrls.getReference(i).getStringProp(CabbageIDs::channel),
-                    guiCtrls.getReference(i).getNumProp(CabbageIDs::value), guiCtrls.getReference(i).getStringProp(CabbageIDs::type));
-            csound->SetChannel( guiCtrls.getReference(i).getStringProp(CabbageIDs::channel).toUTF8(),
-                                guiCtrls.getReference(i).getNumProp(CabbageIDs::value));
-            this->updateCabbageControls();
-        }
+    oversampler.swapWith(prepared.oversampler);
+    std::swap(oversampling, prepared.oversampling);
+    channelBindings.swapWith(prepared.bindings);
+    channelSmoother.swapWith(prepared.smoother);
+    presetBank.setMorphPosition(channelBindings.getHostChannel(CabbageChannelBindings::presetMorph));
 
-        debugMessageArray.add(CABBAGE_VERSION);
-        debugMessageArray.add(String("\n"));
-        //removeAllChangeListeners();
-        getCallbackLock().exit();
+    midiOutputBuffer.clear();
+    midiInputQueueUsed = 0;
+    ksmpsOffset = 0;
+    breakCount = 0;
+    csCompileResult = OK;
+    runningCsdHash = prepared.csdHash;
+    csdKsmps = csound->GetKsmps();
+    CSspout = csound->GetSpout();
+    CSspin  = csound->GetSpin();
+    cs_scale = csound->Get0dBFS();
+    //both instances start their next k-cycle together, on the new one's first
+    csndIndex = getCsoundKsmpsSize();
+    chooseLatencyMode();
+    tableMirror.markTablesWritten();
+    latencyChanged.set(1);
+    csoundStatus = true;
+    stopProcessing = false;
+
+    jassert(replacedCsound==nullptr);
+    replacedCsound = preparedCsound.release();
+    preparedCsoundPending.set(0);
+    csoundReplaced.set(1);
+#endif
+}
 
+//============================================================================
+//DELETES THE PREVIOUS INSTANCE ONCE processBlock() HAS FINISHED FADING IT OUT
+//============================================================================
+void CabbagePluginAudioProcessor::deleteRetiredCsound()
+{
+#ifndef Cabbage_No_Csound
+    if(retiringCsound==nullptr || retiringCsoundFinished.get()==0)
+        return;
 
-#ifdef WIN32
-        csound->SetChannel("CSD_PATH", file.getParentDirectory().getFullPathName().replace("\\", "\\\\").toUTF8().getAddress());
-#else
-        csound->SetChannel("CSD_PATH", file.getParentDirectory().getFullPathName().toUTF8().getAddress());
+    ScopedPointer<CabbageCsound> retired;
+    {
+        //the audio thread may have started fading out another one since
+        const ScopedLock sl(getCallbackLock());
+        if(retiringCsoundFinished.get()!=0)
+            retired = retiringCsound.release();
+    }
 #endif
+}
 
-        csound->SetChannel("IS_A_PLUGIN", 0.0);
-
-        stopProcessing = false;
+//============================================================================
+//DELETES WHAT adoptPreparedCsound() REPLACED
+//============================================================================
+void CabbagePluginAudioProcessor::deleteReplacedCsound()
+{
+#ifndef Cabbage_No_Csound
+    if(csoundReplaced.get()==0)
+        return;
 
-        return csCompileResult;
-    }
-    else
+    ScopedPointer<CabbagePreparedCsound> replaced;
     {
-        Logger::writeToLog("Csound couldn't compile your file");
-        csoundStatus=false;
-        String message= "Csound couldn't compile your file. Please check the Csound output console for more information\n\nYou can disable this warning from the Options->Preference menu.";
-        if(getActiveEditor() && getPreference(appProperties, "DisableCompilerErrorWarning")==0)
-            showMessage(message, &getActiveEditor()->getLookAndFeel());
+        const ScopedLock sl(getCallbackLock());
+        replaced = replacedCsound.release();
+        csoundReplaced.set(0);
     }
-    getCallbackLock().exit();
+#endif
+}
 
-    return csCompileResult;
+//============================================================================
+//DELETES COMPILES THAT recompileCsound() GAVE UP ON, ONCE THEIR THREADS HAVE STOPPED
+//============================================================================
+void CabbagePluginAudioProcessor::deleteSupersededCompiles()
+{
+#ifndef Cabbage_No_Csound
+    for(int i=supersededCompiles.size(); --i>=0;)
+        if(!supersededCompiles.getUnchecked(i)->isThreadRunning())
+            supersededCompiles.remove(i);
 #endif
 }
+
 //===========================================================
 // PARSE CSD FILE AND FILL GUI/GUI-LAYOUT VECTORs.
 // NO JUCE WIDGETS GET CREATED IN THIS CLASS. ALL
@@ -668,16 +939,15 @@ void CabbagePluginAudioProcessor::initialiseWidgets(String source, bool refresh)
 
     if(refresh==true)
     {
+        //keep what the current components were built from, so that
+        //addWidgetsToEditor() can hold on to the ones that haven't changed
+        previousGuiLayoutCtrls.swapWith(guiLayoutCtrls);
+        previousGuiCtrls.swapWith(guiCtrls);
         guiLayoutCtrls.clear();
         guiCtrls.clear();
         CabbagePluginAudioProcessorEditor* editor = dynamic_cast<CabbagePluginAudioProcessorEditor*>(this->getActiveEditor());
         if(editor)
-        {
-            editor->comps.clear(true);
-            editor->layoutComps.clear(true);
-            editor->subPatches.clear(true);
-            editor->popupMenus.clear();
-        }
+            editor->beginWidgetRebuild();
     }
 
     widgetTypes.clear();
@@ -992,52 +1262,78 @@ void CabbagePluginAudioProcessor::initialiseWidgets(String source, bool refresh)
         else break;
     } //end of scan through entire csd text, control vectors are now populated
 
+    resetDirtyWidgets();
+
+#ifndef Cabbage_No_Csound
+    //widget indices may have changed, so channel pointers need to be resolved again
+    ScopedPointer<CabbagePreparedCsound> prepared;
+    {
+        const ScopedLock sl(getCallbackLock());
+        prepared = preparedCsound.release();
+        preparedCsoundPending.set(0);
+        if(csoundStatus)
+            bindCsoundChannels();
+    }
+
+    //that includes a compile the audio thread hasn't taken over yet
+    if(prepared!=nullptr)
+    {
+        resolveCsoundChannels(prepared->instance, prepared->bindings, prepared->smoother);
+        const ScopedLock sl(getCallbackLock());
+        preparedCsound = prepared.release();
+        preparedCsoundPending.set(1);
+    }
+#endif
 }
 
 //===========================================================================================
-// graphing functions...
+//new components are built from the current values, so nothing starts out dirty.
+//The csound output console and fft displays have nothing to mark them, so the
+//editor polls those instead
 //===========================================================================================
-
-void CabbagePluginAudioProcessor::makeGraphCallback(CSOUND *csound, WINDAT *windat, const char * /*name*/)
+void CabbagePluginAudioProcessor::resetDirtyWidgets()
 {
-    CabbagePluginAudioProcessor *ud = (CabbagePluginAudioProcessor *) csoundGetHostData(csound);
-    ud->windowIDs.addIfNotAlreadyThere(windat->windid);
-    cUtils::debug("tableMin:"+String(windat->min));
-    cUtils::debug("tableMa:"+String(windat->max));
-
-    fftDisplay* fft = new fftDisplay(String(windat->caption),windat->windid, windat->oabsmax, windat->min, windat->max, windat->npts);
-
-    bool addFFT = true;
-    for(int i=0; i<ud->fftArrays.size(); i++)
     {
-        if(ud->fftArrays[i]->windid==windat->windid)
-            addFFT = false;
+        //the audio and host threads mark widgets while they run
+        const ScopedLock sl(getCallbackLock());
+        dirtyWidgets.clear(guiCtrls.size()+guiLayoutCtrls.size());
     }
+    polledLayoutCtrls.clearQuick();
+    for(int i=0; i<guiLayoutCtrls.size(); i++)
+    {
+        const CabbageGUIType::WidgetKind kind = guiLayoutCtrls.getReference(i).getKind();
+        if(kind==CabbageGUIType::csoundoutputWidget || kind==CabbageGUIType::fftdisplayWidget)
+            polledLayoutCtrls.add(i);
+    }
+}
 
-    if(addFFT)
-        ud->fftArrays.add(fft);
+//===========================================================================================
+// graphing functions...
+//===========================================================================================
 
-    //cUtils::debug(String(ud->fftArrays.size())+":"+String(windat->windid));
+//an instance that is pre-rolling has no host data, see CsoundCompileThread::run()
+void CabbagePluginAudioProcessor::makeGraphCallback(CSOUND *csound, WINDAT *windat, const char * /*name*/)
+{
+    CabbagePluginAudioProcessor *ud = (CabbagePluginAudioProcessor *) csoundGetHostData(csound);
+    //buffers are allocated here, at init time, so drawing never has to. Windows
+    //past the last one graphFrames has room for are left undrawn
+    if(ud!=nullptr)
+        ud->graphFrames.prepare(windat);
 }
 
 void CabbagePluginAudioProcessor::drawGraphCallback(CSOUND *csound, WINDAT *windat)
 {
     CabbagePluginAudioProcessor *ud = (CabbagePluginAudioProcessor *) csoundGetHostData(csound);
-    Array<float, CriticalSection> tablePoints = Array<float, CriticalSection>(&windat->fdata[0], windat->npts);
-    ud->fftArrays.getUnchecked(windat->windid)->setPoints(tablePoints);
-    ud->updateFFTDisplay = true;
+    if(ud!=nullptr)
+        ud->graphFrames.write(windat);
 }
 
-void CabbagePluginAudioProcessor::killGraphCallback(CSOUND *csound, WINDAT *windat)
+void CabbagePluginAudioProcessor::killGraphCallback(CSOUND* /*csound*/, WINDAT* /*windat*/)
 {
-    CabbagePluginAudioProcessor *udata = (CabbagePluginAudioProcessor *) csoundGetHostData(csound);
-    cUtils::debug("killGraphCallback");
 }
 
-int CabbagePluginAudioProcessor::exitGraphCallback(CSOUND *csound)
+int CabbagePluginAudioProcessor::exitGraphCallback(CSOUND* /*csound*/)
 {
-    CabbagePluginAudioProcessor *udata = (CabbagePluginAudioProcessor *) csoundGetHostData(csound);
-    cUtils::debug("exitGraphCallback");
     return 0;
 }
 
@@ -1050,10 +1346,14 @@ void CabbagePluginAudioProcessor::addWidgetsToEditor(bool refresh)
     {
         CabbagePluginAudioProcessorEditor* editor = dynamic_cast<CabbagePluginAudioProcessorEditor*>(this->getActiveEditor());
 
+        const bool incremental = refresh && editor->isRebuildingWidgets() && canReuseWidgetComponents();
         if(refresh)
         {
-            editor->comps.clear();
-            editor->layoutComps.clear();
+            if(!editor->isRebuildingWidgets())
+            {
+                editor->comps.clear();
+                editor->layoutComps.clear();
+            }
             editor->repaint();
             //((CabbagePluginAudioProcessorEditor*)getActiveEditor())->setEditMode(false);
             //editor->setEditMode(false);
@@ -1061,22 +1361,29 @@ void CabbagePluginAudioProcessor::addWidgetsToEditor(bool refresh)
 
         int layoutCtrlIndex=indexOfLastLayoutCtrl;
         int interactiveCtrlIndex=indexOfLastGUICtrl;
+        StringArray rebuiltPlants;
+        BigInteger matchedLayoutCtrls, matchedCtrls;
 
         //this ensures that widgets get added in order they appear
-        //in text
+        //in text. On a refresh, widgets that are the same as last time
+        //keep their components
         for(int i=0; i<getWidgetTypes().size(); i++)
         {
-            if(getWidgetTypes()[i]=="layout")
-            {
-                editor->InsertGUIControls(getGUILayoutCtrls(layoutCtrlIndex));
-                layoutCtrlIndex++;
-            }
-            else //interactive
-            {
-                editor->InsertGUIControls(getGUICtrls(interactiveCtrlIndex));
-                interactiveCtrlIndex++;
-            }
+            const bool isLayout = (getWidgetTypes()[i]=="layout");
+            const int index = (isLayout ? layoutCtrlIndex++ : interactiveCtrlIndex++);
+            CabbageGUIType& cAttr = (isLayout ? getGUILayoutCtrls(index) : getGUICtrls(index));
+            int previousIndex = -1;
+
+            if(incremental && isWidgetUnchanged(cAttr, isLayout, index, rebuiltPlants,
+                                                (isLayout ? matchedLayoutCtrls : matchedCtrls), previousIndex)
+                    && editor->reuseWidgetComponent(isLayout, previousIndex, index, cAttr))
+                continue;
+
+            if(cAttr.getStringProp(CabbageIDs::plant).isNotEmpty())
+                rebuiltPlants.add(cAttr.getStringProp(CabbageIDs::plant));
+            editor->InsertGUIControls(cAttr);
         }
+        editor->endWidgetRebuild(getWidgetTypes());
 //
 //        for(int i=indexOfLastLayoutCtrl; i<guiLayoutCtrls.size(); i++)
 //            editor->InsertGUIControls(guiLayoutCtrls[i]);
@@ -1090,6 +1397,84 @@ void CabbagePluginAudioProcessor::addWidgetsToEditor(bool refresh)
 }
 
 
+//popup plants live in their own windows, and the form sets up things like the
+//global svg path that every widget is built with, so if either changed, or
+//there are popup plants at all, everything gets built from scratch
+bool CabbagePluginAudioProcessor::canReuseWidgetComponents()
+{
+    for(int pass=0; pass<2; pass++)
+    {
+        const Array<CabbageGUIType, CriticalSection>& ctrls = (pass==0 ? guiLayoutCtrls : previousGuiLayoutCtrls);
+        for(int i=0; i<ctrls.size(); i++)
+            if(ctrls.getReference(i).getNumProp("popup")==1)
+                return false;
+    }
+
+    for(int i=0; i<guiLayoutCtrls.size(); i++)
+        if(guiLayoutCtrls.getReference(i).getKind()==CabbageGUIType::formWidget)
+            return i<previousGuiLayoutCtrls.size() && guiLayoutCtrls.getReference(i).isEquivalentTo(previousGuiLayoutCtrls.getReference(i));
+    return true;
+}
+
+//widgets are matched with last time's by channel, or by name for those that
+//have none, leaving out the count of widgets before them that ends each name,
+//so adding or removing a line doesn't stop the rest from being matched
+static String getWidgetMatchKey(const CabbageGUIType& cAttr)
+{
+    if(cAttr.getChannel().isNotEmpty())
+        return cAttr.getChannel();
+    return cAttr.cabbageIdentifiers.getWithDefault(CabbageIDs::name, "").toString().trimCharactersAtEnd("0123456789");
+}
+
+//a widget keeps a component if it matches one that hasn't been matched yet,
+//was declared the same way, and isn't inside a plant that had to be rebuilt.
+//previousIndex is set to the index that component was built for. Controls
+//carry their current value over so the two stay in step, unless the csd now
+//declares a different one, which the component is then marked to take on
+bool CabbagePluginAudioProcessor::isWidgetUnchanged(CabbageGUIType& cAttr, bool isLayout, int index, const StringArray& rebuiltPlants,
+        BigInteger& matched, int& previousIndex)
+{
+    const Array<CabbageGUIType, CriticalSection>& previous = (isLayout ? previousGuiLayoutCtrls : previousGuiCtrls);
+    previousIndex = -1;
+
+    //the form only sets up the window, popup menus register themselves with the
+    //editor, and xypads with their automation, so those are always inserted again
+    const CabbageGUIType::WidgetKind kind = cAttr.getKind();
+    const String type = cAttr.getStringProp(CabbageIDs::type);
+    if(kind==CabbageGUIType::formWidget || kind==CabbageGUIType::xypadWidget || type=="popupmenu")
+        return false;
+
+    const String plant = cAttr.getStringProp("reltoplant");
+    if(plant.isNotEmpty() && rebuiltPlants.contains(plant))
+        return false;
+
+    //most widgets are where they were, so look there first
+    const String key = getWidgetMatchKey(cAttr);
+    for(int n=-1; n<previous.size() && previousIndex<0; n++)
+    {
+        const int i = (n<0 ? index : n);
+        if((n>=0 && i==index) || i>=previous.size() || matched[i])
+            continue;
+
+        const CabbageGUIType& candidate = previous.getReference(i);
+        if(getWidgetMatchKey(candidate)==key && cAttr.isEquivalentTo(candidate, true))
+            previousIndex = i;
+    }
+    if(previousIndex<0)
+        return false;
+
+    matched.setBit(previousIndex);
+    const CabbageGUIType& previousAttr = previous.getReference(previousIndex);
+    if(!isLayout && previousAttr.cabbageIdentifiers.contains(CabbageIDs::value))
+    {
+        if(cAttr.getDeclaredValue()==previousAttr.getDeclaredValue())
+            cAttr.setNumProp(CabbageIDs::value, previousAttr.getValue());
+        else if(cAttr.getValue()!=previousAttr.getValue())
+            dirtyWidgets.mark(index);
+    }
+    return true;
+}
+
 //===========================================================
 // SHOW SOURCE EDITOR
 //===========================================================
@@ -1380,47 +1765,25 @@ void CabbagePluginAudioProcessor::stopRecording()
 }
 
 
+//returns everything the console still holds. Consoles that are refreshed
+//regularly should use readCsoundOutput() so they only get the new lines
 String CabbagePluginAudioProcessor::getCsoundOutput()
 {
-    const int messageCnt = csound->GetMessageCnt();
-
-    if(messageCnt==0)
-        return csoundOutput;
-
-    for(int i=0; i<messageCnt; i++)
-    {
-        csoundOutput+=csound->GetFirstMessage();
-        csound->PopFirstMessage();
-    }
-
-    return csoundOutput;
-}
+    return console.getText();
+}
 
 //===========================================================
-// CALLBACKS FOR STANDALONE
+// CSOUND MESSAGE CALLBACK
 //===========================================================
-//#ifndef Cabbage_No_Csound
-//void CabbagePluginAudioProcessor::messageCallback(CSOUND* csound, int /*attr*/,  const char* fmt, va_list args)
-//{
-//    if(fmt)
-//    {
-//        CabbagePluginAudioProcessor* ud = (CabbagePluginAudioProcessor *) csoundGetHostData(csound);
-//        char msg[MAX_BUFFER_SIZE];
-//        vsnprintf(msg, MAX_BUFFER_SIZE, fmt, args);
-//
-//        ud->debugMessage += String(msg); //We have to append the incoming msg
-//		//const MessageManagerLock mmLock;
-//        ud->csoundOutput += ud->debugMessage;
-//        ud->debugMessageArray.add(ud->debugMessage);
-//        if(ud->createLog)
-//            Logger::writeToLog(String(msg).trim());
-//        ud->sendChangeMessage();
-//        ud->debugMessage = "";
-//        ud = nullptr;
-//
-//    }
-//}
-//#endif
+#ifndef Cabbage_No_Csound
+//called on whichever thread Csound is printing from, including the audio thread
+void CabbagePluginAudioProcessor::messageCallback(CSOUND* csound, int /*attr*/,  const char* fmt, va_list args)
+{
+    CabbagePluginAudioProcessor* ud = (CabbagePluginAudioProcessor *) csoundGetHostData(csound);
+    if(fmt && ud)
+        ud->console.post(fmt, args);
+}
+#endif
 
 #if defined(BUILD_DEBUGGER) && !defined(Cabbage_No_Csound)
 
@@ -1562,42 +1925,116 @@ StringArray CabbagePluginAudioProcessor::getTableStatement(int tableNum)
     return fdata;
 }
 //==============================================================================
-fftDisplay* CabbagePluginAudioProcessor::getFFTTable(int tableNum)
+//returns the newest frame drawn into the windowNum'th graph window, or nullptr if Csound
+//hasn't made that many. Like table snapshots, compare versions to skip repaints
+const CabbageTableSnapshot* CabbagePluginAudioProcessor::getGraphFrame(int windowNum)
 {
-    if(fftArrays[tableNum])
-        return fftArrays[tableNum];
-    else
-        return new fftDisplay("", -1, 0, 0, 0, 0);
+#ifndef Cabbage_No_Csound
+    return graphFrames.fetch(windowNum);
+#else
+    return nullptr;
+#endif
 }
 
+//==============================================================================
+// Preset bank. Presets are stored with the widgets' current values and saved
+// next to the .csd, so they can be recalled without reading any files
+//==============================================================================
+File CabbagePluginAudioProcessor::getPresetBankFile() const
+{
+    return csdFile.withFileExtension(".snapbank");
+}
 
-const Array<float, CriticalSection> CabbagePluginAudioProcessor::getTableFloats(int tableNum)
+//the file is read and laid out before the audio thread is locked out. If
+//there is no bank, the presets that belonged to the last file are dropped
+bool CabbagePluginAudioProcessor::loadPresetBank(const File& file)
 {
-    Array<float, CriticalSection> points;
-    if(csCompileResult==OK)
+#ifndef Cabbage_No_Csound
+    CabbagePresetBank loaded;
+    const bool found = file.existsAsFile() && loaded.loadFromFile(file);
+    loaded.mapToControlsOf(presetBank);
+    {
+        const ScopedLock sl(getCallbackLock());
+        presetBank.swapWith(loaded);
+    }
+    presetBankFile = file;
+    return found;
+#else
+    return false;
+#endif
+}
+
+void CabbagePluginAudioProcessor::storePreset(const String& name)
+{
+#ifndef Cabbage_No_Csound
+    StringArray channels;
+    Array<float> values;
+    for(int i=0; i<guiCtrls.size(); i++)
     {
-        points.clear();
+        channels.add(guiCtrls[i].getStringProp(CabbageIDs::channel));
+        values.add(guiCtrls[i].getNumProp(CabbageIDs::value));
+    }
+
+    {
+        const ScopedLock sl(getCallbackLock());
+        presetBank.storePreset(name, channels, values);
+    }
+    presetBank.saveToFile(presetBankFile);
+#endif
+}
 
-        int tableSize=0;
+//returns false if the bank has no preset called name
+bool CabbagePluginAudioProcessor::recallPreset(const String& name)
+{
 #ifndef Cabbage_No_Csound
+    const int index = presetBank.indexOf(name);
+    if(index<0)
+        return false;
+    presetBank.recall(index);
+    return true;
+#else
+    return false;
+#endif
+}
 
-        tableSize = csound->TableLength(tableNum);
-        temp.clear();
-        //not good if table size is -1!
-        if(tableSize<0)
-            return points;
+void CabbagePluginAudioProcessor::setMorphPresets(const Array<int>& presetIndexes)
+{
+#ifndef Cabbage_No_Csound
+    const ScopedLock sl(getCallbackLock());
+    presetBank.setMorphPresets(presetIndexes);
+#endif
+}
 
-        temp.reserve(tableSize);
-        csound->TableCopyOut(tableNum, &temp[0]);
+//frames Csound drew faster than the editor picked them up, for diagnostics
+int CabbagePluginAudioProcessor::getNumDroppedGraphFrames() const
+{
+#ifndef Cabbage_No_Csound
+    return graphFrames.getNumDroppedFrames();
 #else
-        float *temp;
+    return 0;
 #endif
-        if(tableSize>0)
-            points = Array<float, CriticalSection>(&temp[0], tableSize);
-    }
+}
+
+
+const Array<float, CriticalSection> CabbagePluginAudioProcessor::getTableFloats(int tableNum)
+{
+    Array<float, CriticalSection> points;
+    if(const CabbageTableSnapshot* snapshot = getTableSnapshot(tableNum))
+        points = Array<float, CriticalSection>(snapshot->data, snapshot->size);
     return points;
 }
 
+//returns the table as of this call without copying it, or nullptr if there is no
+//such table. Compare the snapshot's version with the last one drawn to skip repaints
+const CabbageTableSnapshot* CabbagePluginAudioProcessor::getTableSnapshot(int tableNum)
+{
+#ifndef Cabbage_No_Csound
+    if(csCompileResult==OK)
+        return tableMirror.update(csound, tableNum);
+#endif
+    return nullptr;
+}
+
 int CabbagePluginAudioProcessor::checkTable(int tableNum)
 {
 #ifndef Cabbage_No_Csound
@@ -1614,8 +2051,9 @@ float CabbagePluginAudioProcessor::getParameter (int index)
 {
     if(isPositiveAndBelow(index, getGUICtrlsSize()))
     {
-        float range = getGUICtrls(index).getNumProp(CabbageIDs::range);
-        float min = getGUICtrls(index).getNumProp(CabbageIDs::min);
+        const CabbageGUIType& guiCtrl = getGUICtrls(index);
+        float range = guiCtrl.getRange();
+        float min = guiCtrl.getMin();
         //Logger::writeToLog("parameterGet-"+String(index)+String("-Min:")+String(min)+" Range:"+String(range)+ " Val:"+String(getGUICtrls(index).getNumProp(CabbageIDs::value)));
         //Logger::writeToLog("parameterGet:"+String(index)+String(":")+String(guiCtrls[index].getNumProp(CabbageIDs::value)));
 
@@ -1623,16 +2061,15 @@ float CabbagePluginAudioProcessor::getParameter (int index)
         if(index<(int)guiCtrls.size()) //make sure index isn't out of range
         {
 #ifndef Cabbage_Build_Standalone
-            float val = (getGUICtrls(index).getNumProp(CabbageIDs::value)/range)-(min/range);
-            if(getGUICtrls(index).getStringProp(CabbageIDs::type)==CabbageIDs::combobox)
-                return (getGUICtrls(index).getNumProp(CabbageIDs::value)/getGUICtrls(index).getNumProp(CabbageIDs::comborange));
-            else if(getGUICtrls(index).getStringProp(CabbageIDs::type)==CabbageIDs::checkbox ||
-                    getGUICtrls(index).getStringProp(CabbageIDs::type)==CabbageIDs::button)
-                return getGUICtrls(index).getNumProp(CabbageIDs::value);
+            if(guiCtrl.getKind()==CabbageGUIType::comboboxWidget)
+                return (guiCtrl.getValue()/guiCtrl.getComboRange());
+            else if(guiCtrl.getKind()==CabbageGUIType::checkboxWidget ||
+                    guiCtrl.getKind()==CabbageGUIType::buttonWidget)
+                return guiCtrl.getValue();
             else
-                return (getGUICtrls(index).getNumProp(CabbageIDs::value)/range)-(min/range);
+                return (guiCtrl.getValue()/range)-(min/range);
 #else
-            return guiCtrls[index].getNumProp(CabbageIDs::value);
+            return guiCtrl.getValue();
 #endif
         }
         else
@@ -1652,29 +2089,30 @@ void CabbagePluginAudioProcessor::setParameter (int index, float newValue)
         String stringMessage;
 #ifndef Cabbage_No_Csound
         float range, min, comboRange;
-        //add index of control that was changed to dirty control vector, unless it's a combobox.
+        //mark the control that was changed as dirty, unless it's a combobox.
+        CabbageGUIType& guiCtrl = getGUICtrls(index);
 #ifdef Cabbage_Build_Standalone
-        if(!getGUICtrls(index).getStringProp("filetype").contains("snaps"))
-            dirtyControls.addIfNotAlreadyThere(index);
+        if(!guiCtrl.getStringProp("filetype").contains("snaps"))
+            dirtyWidgets.mark(index);
 #else
-        if(getGUICtrls(index).getStringProp(CabbageIDs::type)!=CabbageIDs::combobox)
-            dirtyControls.addIfNotAlreadyThere(index);
+        if(guiCtrl.getKind()!=CabbageGUIType::comboboxWidget)
+            dirtyWidgets.mark(index);
 #endif
 
         if(index<(int)guiCtrls.size())//make sure index isn't out of range
         {
 #ifndef Cabbage_Build_Standalone
             //scaling in here because incoming values in plugin mode range from 0-1
-            range = getGUICtrls(index).getNumProp(CabbageIDs::range);
-            comboRange = getGUICtrls(index).getNumProp(CabbageIDs::comborange);
-            min = getGUICtrls(index).getNumProp(CabbageIDs::min);
+            range = guiCtrl.getRange();
+            comboRange = guiCtrl.getComboRange();
+            min = guiCtrl.getMin();
 
-            if(getGUICtrls(index).getStringProp(CabbageIDs::type)==CabbageIDs::xypad)
+            if(guiCtrl.getKind()==CabbageGUIType::xypadWidget)
                 newValue = (jmax(0.f, newValue)*range)+min;
-            else if(getGUICtrls(index).getStringProp(CabbageIDs::type)==CabbageIDs::combobox)//combo box value need to be rounded...
+            else if(guiCtrl.getKind()==CabbageGUIType::comboboxWidget)//combo box value need to be rounded...
                 newValue = (newValue*comboRange);
-            else if(getGUICtrls(index).getStringProp(CabbageIDs::type)==CabbageIDs::checkbox ||
-                    getGUICtrls(index).getStringProp(CabbageIDs::type)==CabbageIDs::button)
+            else if(guiCtrl.getKind()==CabbageGUIType::checkboxWidget ||
+                    guiCtrl.getKind()==CabbageGUIType::buttonWidget)
                 range=1;
             else
                 newValue = (newValue*range)+min;
@@ -1682,20 +2120,25 @@ void CabbagePluginAudioProcessor::setParameter (int index, float newValue)
 
 
 #endif
-            if(getGUICtrls(index).getStringProp(CabbageIDs::type)==CabbageIDs::combobox &&
-                    getGUICtrls(index).getStringProp(CabbageIDs::channeltype)==CabbageIDs::stringchannel)
+            bool queued;
+            if(guiCtrl.getKind()==CabbageGUIType::comboboxWidget && guiCtrl.isStringChannel())
             {
-                cUtils::debug(getGUICtrls(index).getStringArrayProp(CabbageIDs::text).size());
-                stringMessage = getGUICtrls(index).getStringArrayPropValue(CabbageIDs::text, newValue-1);
-                messageQueue.addOutgoingChannelMessageToQueue(guiCtrls.getReference(index).getStringProp(CabbageIDs::channel),
-                        stringMessage, CabbageIDs::stringchannel);
+                cUtils::debug(guiCtrl.getStringArrayProp(CabbageIDs::text).size());
+                stringMessage = guiCtrl.getStringArrayPropValue(CabbageIDs::text, newValue-1);
+                queued = messageQueue.addOutgoingChannelMessageToQueue(guiCtrl.getChannel(),
+                         stringMessage, CabbageIDs::stringchannel);
             }
+            //hosts may automate from their audio thread, so use the slot bound
+            //after the last compile rather than look the channel up
+            else if(channelBindings.getControlSlot(index)>=0)
+                queued = messageQueue.addOutgoingSlotMessageToQueue(channelBindings.getControlSlot(index), newValue);
             else
-            {
-                messageQueue.addOutgoingChannelMessageToQueue(guiCtrls.getReference(index).getStringProp(CabbageIDs::channel),
-                        newValue, guiCtrls.getReference(index).getStringProp(CabbageIDs::type));
+                queued = messageQueue.addOutgoingChannelMessageToQueue(guiCtrl.getChannel(),
+                         newValue, guiCtrl.getStringProp(CabbageIDs::type));
 
-            }
+            //the queue counts what it drops, and timerCallback() reports it
+            if(!queued)
+                jassertfalse;
             //guiCtrls.getReference(index).setNumProp(CabbageIDs::value, newValue);
         }
 #endif
@@ -1712,7 +2155,7 @@ void CabbagePluginAudioProcessor::updateCabbageControls()
 {
 #ifndef Cabbage_No_Csound
     bool shouldUpdate = false;
-    String channelMessage;
+    bool identMessagesPosted = false;
     if(csCompileResult==OK)
     {
         //update all control widgets
@@ -1720,40 +2163,45 @@ void CabbagePluginAudioProcessor::updateCabbageControls()
         for(int index=0; index<guiCtrls_count; ++index)
         {
             CabbageGUIType &guiCtrl = guiCtrls.getReference(index);
-            if(guiCtrl.getStringProp(CabbageIDs::channeltype).equalsIgnoreCase(CabbageIDs::stringchannel))
+            if(guiCtrl.isStringChannel())
             {
                 //THIS NEEDS TO ALLOW COMBOBOXEX THAT CONTAIN SNAPSHOTS TO UPDATE..
-                //dirtyControls.addIfNotAlreadyThere(index);
+                //dirtyWidgets.mark(index);
                 //shouldUpdate = true;
             }
             else
             {
-                float value = csound->GetChannel(guiCtrl.getStringProp(CabbageIDs::channel).getCharPointer());
+                MYFLT* channelPtr = channelBindings.getControlChannel(index);
+                float value = channelPtr ? *channelPtr : csound->GetChannel(guiCtrl.getChannel().getCharPointer());
+                //a smoothed channel is reported at its target until it gets there
+                channelSmoother.getTarget(index, value);
                 //cUtils::debug(guiCtrl.getStringProp(CabbageIDs::channel));
-                if(value!=guiCtrl.getNumProp(CabbageIDs::value))
+                if(value!=guiCtrl.getValue())
                 {
                     //Logger::writeToLog("Channel:"+guiCtrls[index].getStringProp(CabbageIDs::channel));
                     //Logger::writeToLog("value:"+String(value));
                     guiCtrl.setNumProp(CabbageIDs::value, value);
-                    dirtyControls.addIfNotAlreadyThere(index);
+                    dirtyWidgets.mark(index);
                     shouldUpdate = true;
                 }
             }
 
-            if(guiCtrl.getStringProp(CabbageIDs::identchannel).isNotEmpty())
+            //if controls has an identifier channel pass its string on to the message
+            //thread, which does the parsing. See handleAsyncUpdate()
+            if(STRINGDAT* identPtr = channelBindings.getIdentChannel(index))
             {
-                //if controls has an identifier channel send data from Csound to control
-                csound->GetStringChannel(guiCtrl.getStringProp(CabbageIDs::identchannel).toUTF8().getAddress(), tmp_string);
-                channelMessage = String(tmp_string);
-                if(channelMessage.isNotEmpty())
+                const CabbageChannelBindings::ScopedChannelLock channelLock(csound, channelBindings.getIdentChannelName(index));
+                if(const char* identMessage = CabbageChannelBindings::getIdentChannelMessage(identPtr))
                 {
-                    guiCtrl.setStringProp(CabbageIDs::identchannelmessage, channelMessage.trim());
-                    guiCtrl.parse(guiCtrl.getStringProp(CabbageIDs::type)+" "+channelMessage, "");
-                    dirtyControls.addIfNotAlreadyThere(index);
-                    shouldUpdate = true;
+                    identMessagesPosted |= identMailbox.post(index, identMessage);
+                    CabbageChannelBindings::clearIdentChannel(identPtr);
                 }
-                //else
-                //guiCtrls.getReference(index).setStringProp(CabbageIDs::identchannelmessage, "");
+            }
+            else if(guiCtrl.getStringProp(CabbageIDs::identchannel).isNotEmpty())
+            {
+                csound->GetStringChannel(guiCtrl.getStringProp(CabbageIDs::identchannel).toUTF8().getAddress(), tmp_string);
+                if(tmp_string[0]!=0)
+                    identMessagesPosted |= identMailbox.post(index, tmp_string);
                 //zero channel message so that we don't keep sending the same string
                 csound->SetChannel(guiCtrl.getStringProp(CabbageIDs::identchannel).toUTF8().getAddress(), "");
             }
@@ -1771,96 +2219,177 @@ void CabbagePluginAudioProcessor::updateCabbageControls()
                 for(int y=0; y<guiLayoutCtrl.getStringArrayProp(CabbageIDs::channel).size(); ++y)
                 {
                     //String test = getGUILayoutCtrls(index).getStringArrayPropValue(CabbageIDs::channel, y);
-                    float value = csound->GetChannel(guiLayoutCtrl.getStringArrayPropValue(CabbageIDs::channel, y).getCharPointer());
+                    MYFLT* channelPtr = channelBindings.getTableChannel(index, y);
+                    float value = channelPtr ? *channelPtr : csound->GetChannel(guiLayoutCtrl.getStringArrayPropValue(CabbageIDs::channel, y).getCharPointer());
                     guiLayoutCtrl.setTableChannelValues(y, value);
                     shouldUpdate=true;
                 }
             }
 
-            if(guiLayoutCtrl.getStringProp(CabbageIDs::identchannel).isNotEmpty())
+            const int mailboxIndex = guiCtrls_count+index;
+            if(STRINGDAT* identPtr = channelBindings.getLayoutIdentChannel(index))
             {
-                //guiLayoutCtrls[index].getStringProp(CabbageIDs::identchannel).toUTF8().getAddress()
-                csound->GetStringChannel(guiLayoutCtrl.getStringProp(CabbageIDs::identchannel).toUTF8().getAddress(), tmp_string);
-                channelMessage = String(tmp_string);
-                //Logger::writeToLog(guiLayoutCtrls[index].getStringProp(CabbageIDs::identchannel));
-                if(channelMessage.isNotEmpty())
+                const CabbageChannelBindings::ScopedChannelLock channelLock(csound, channelBindings.getLayoutIdentChannelName(index));
+                if(const char* identMessage = CabbageChannelBindings::getIdentChannelMessage(identPtr))
                 {
-
-                    guiLayoutCtrl.parse(guiLayoutCtrl.getStringProp(CabbageIDs::type)+" "+channelMessage, channelMessage);
-                    //cUtils::debug(channelMessage);
-                    guiLayoutCtrl.setStringProp(CabbageIDs::identchannelmessage,channelMessage.trim());
-                    shouldUpdate=true;
+                    identMessagesPosted |= identMailbox.post(mailboxIndex, identMessage);
+                    CabbageChannelBindings::clearIdentChannel(identPtr);
                 }
-                //else
-                //	guiLayoutCtrls.getReference(index).setStringProp(CabbageIDs::identchannelmessage, "");
+            }
+            else if(guiLayoutCtrl.getStringProp(CabbageIDs::identchannel).isNotEmpty())
+            {
+                csound->GetStringChannel(guiLayoutCtrl.getStringProp(CabbageIDs::identchannel).toUTF8().getAddress(), tmp_string);
+                if(tmp_string[0]!=0)
+                    identMessagesPosted |= identMailbox.post(mailboxIndex, tmp_string);
                 //zero channel message so that we don't keep sending the same string
                 csound->SetChannel(guiLayoutCtrl.getStringProp(CabbageIDs::identchannel).toUTF8().getAddress(), "");
             }
         }
         if(shouldUpdate)
             sendChangeMessage();
+        if(identMessagesPosted)
+            triggerAsyncUpdate();
     }
 #endif
 }
 
-
 //==============================================================================
-//this method only gets called when it's safe to do so, i.e., between calls to performKsmps()
-//this method sends any channel messages that are in the queue to from Cabbage to Csound
-void CabbagePluginAudioProcessor::sendOutgoingMessagesToCsound()
+//parses any identchannel strings posted by updateCabbageControls(). This runs on
+//the message thread so that the audio thread never has to tokenise strings.
+//Only the message thread changes a widget's layout, so it can be copied and
+//parsed without the callback lock. The audio thread does keep writing values in
+//place, so those are taken again from the live widget when the parsed one is
+//swapped in, unless the message set them itself. Nothing under the lock allocates
+void CabbagePluginAudioProcessor::handleAsyncUpdate()
 {
 #ifndef Cabbage_No_Csound
+    bool shouldUpdate = false;
+    bool truncated = false;
+    String channelMessage;
+
+    const int guiCtrls_count = guiCtrls.size();
+    for(int index=0; index<guiCtrls_count; ++index)
+    {
+        if(identMailbox.fetch(index, channelMessage, truncated))
+        {
+            warnIfIdentMessageTruncated(guiCtrls.getReference(index), truncated);
+            CabbageGUIType guiCtrl(guiCtrls.getReference(index));
+            const float previousValue = guiCtrl.getValue();
+            guiCtrl.setStringProp(CabbageIDs::identchannelmessage, channelMessage.trim());
+            guiCtrl.parse(guiCtrl.getStringProp(CabbageIDs::type)+" "+channelMessage, "");
+            {
+                const ScopedLock sl(getCallbackLock());
+                guiCtrl.copyAudioThreadValuesFrom(guiCtrls.getReference(index), guiCtrl.getValue()==previousValue);
+                guiCtrls.getReference(index).swapWith(guiCtrl);
+            }
+            dirtyWidgets.mark(index);
+            shouldUpdate = true;
+        }
+    }
+
+    const int guiLayoutCtrls_count = getGUILayoutCtrlsSize();
+    for(int index=0; index<guiLayoutCtrls_count; ++index)
+    {
+        if(identMailbox.fetch(guiCtrls_count+index, channelMessage, truncated))
+        {
+            warnIfIdentMessageTruncated(guiLayoutCtrls.getReference(index), truncated);
+            CabbageGUIType guiLayoutCtrl(guiLayoutCtrls.getReference(index));
+            const float previousValue = guiLayoutCtrl.getValue();
+            guiLayoutCtrl.parse(guiLayoutCtrl.getStringProp(CabbageIDs::type)+" "+channelMessage, channelMessage);
+            guiLayoutCtrl.setStringProp(CabbageIDs::identchannelmessage, channelMessage.trim());
+            {
+                const ScopedLock sl(getCallbackLock());
+                guiLayoutCtrl.copyAudioThreadValuesFrom(guiLayoutCtrls.getReference(index), guiLayoutCtrl.getValue()==previousValue);
+                guiLayoutCtrls.getReference(index).swapWith(guiLayoutCtrl);
+            }
+            dirtyWidgets.mark(guiCtrls_count+index);
+            shouldUpdate = true;
+        }
+    }
+
+    if(shouldUpdate)
+        sendChangeMessage();
+#endif
+}
+
+//the identchannel mailbox only has room for so much of each string, so the
+//end of a longer one is lost. Say so rather than parsing half a message quietly
+void CabbagePluginAudioProcessor::warnIfIdentMessageTruncated(CabbageGUIType& guiCtrl, bool truncated)
+{
+    if(truncated)
+        Logger::writeToLog("Cabbage: identchannel message for '"+guiCtrl.getStringProp(CabbageIDs::identchannel)
+                           +"' is longer than "+String(CabbageIdentChannelMailbox::maxMessageLength-1)
+                           +" characters and was cut short");
+}
+
+
+//==============================================================================
+//called once per processBlock() to pass the host's transport info on to Csound
+void CabbagePluginAudioProcessor::updateHostChannels()
+{
+#if !defined(Cabbage_No_Csound) && !defined(Cabbage_Build_Standalone)
     if(csCompileResult==OK)
     {
-#ifndef Cabbage_Build_Standalone
         if (getPlayHead() != 0 && getPlayHead()->getCurrentPosition (hostInfo))
         {
-            csound->SetChannel(CabbageIDs::hostbpm.toUTF8(), hostInfo.bpm);
-            csound->SetChannel(CabbageIDs::timeinseconds.toUTF8(), hostInfo.timeInSeconds);
-            csound->SetChannel(CabbageIDs::isplaying.toUTF8(), hostInfo.isPlaying);
-            csound->SetChannel(CabbageIDs::isrecording.toUTF8(), hostInfo.isRecording);
-            csound->SetChannel(CabbageIDs::hostppqpos.toUTF8(), hostInfo.ppqPosition);
-            csound->SetChannel(CabbageIDs::timeinsamples.toUTF8(), hostInfo.timeInSamples);
-            csound->SetChannel(CabbageIDs::timeSigDenom.toUTF8(), hostInfo.timeSigDenominator);
-            csound->SetChannel(CabbageIDs::timeSigNum.toUTF8(), hostInfo.timeSigNumerator);
+            channelBindings.setHostChannel(CabbageChannelBindings::hostBpm, hostInfo.bpm);
+            channelBindings.setHostChannel(CabbageChannelBindings::timeInSeconds, hostInfo.timeInSeconds);
+            channelBindings.setHostChannel(CabbageChannelBindings::isPlaying, hostInfo.isPlaying);
+            channelBindings.setHostChannel(CabbageChannelBindings::isRecording, hostInfo.isRecording);
+            channelBindings.setHostChannel(CabbageChannelBindings::hostPPQPos, hostInfo.ppqPosition);
+            channelBindings.setHostChannel(CabbageChannelBindings::timeInSamples, hostInfo.timeInSamples);
+            channelBindings.setHostChannel(CabbageChannelBindings::timeSigDenom, hostInfo.timeSigDenominator);
+            channelBindings.setHostChannel(CabbageChannelBindings::timeSigNum, hostInfo.timeSigNumerator);
 
         }
+    }
 #endif
-        const int message_count = messageQueue.getNumberOfOutgoingChannelMessagesInQueue();
-        const int scoreEvents_count = scoreEvents.size();
-        for(int i=0; i<message_count; i++)
+}
+
+//==============================================================================
+//this method only gets called when it's safe to do so, i.e., between calls to performKsmps()
+//this method sends any channel messages that are in the queue to from Cabbage to Csound.
+//It runs on every k-cycle so that host automation lands on the k-cycle it arrived
+//in rather than waiting for the next GUI refresh. Returns true if any function
+//tables were written, or will be by the next performKsmps()
+bool CabbagePluginAudioProcessor::sendOutgoingMessagesToCsound()
+{
+    bool tablesWritten = false;
+#ifndef Cabbage_No_Csound
+    if(csCompileResult==OK)
+    {
+        tablesWritten = tableUpdateMailbox.commit(csound);
+
+        CabbageChannelMessage message;
+        while(messageQueue.getNextOutgoingChannelMessage(message))
         {
-            const CabbageChannelMessage &message = messageQueue.getOutgoingChannelMessageFromQueue(i);
-            //Logger::writeToLog("MessageType:"+messageQueue.getOutgoingChannelMessageFromQueue(i).type);
-            if(message.type=="directoryList")
-            {
-                for(int y=0; y<scoreEvents_count; ++y)
-                    csound->InputMessage(scoreEvents[y].toUTF8());
-                //scoreEvents.clear();
-            }
             //update Csound function tables with values from table widget
-            else if(message.type=="updateTable")
+            if(message.type==CabbageChannelMessage::tableMessage)
             {
-                //Logger::writeToLog(messageQueue.getOutgoingChannelMessageFromQueue(i).fStatement.toUTF8());
-                csound->InputMessage(message.fStatement.getCharPointer());
+                csound->InputMessage(messageQueue.getPayload(message).getCharPointer());
+                tablesWritten = true;
             }
             //catch string messags
-            else if(message.type==CabbageIDs::stringchannel)
+            else if(message.type==CabbageChannelMessage::stringMessage)
+            {
+                csound->SetChannel(messageQueue.getChannelName(message).getCharPointer(),
+                                   const_cast<char*>(messageQueue.getPayload(message).getCharPointer().getAddress()));
+            }
+            else if(MYFLT* channelPtr = channelBindings.getSlotControlChannel(message.slot))
             {
-                //Logger::writeToLog(messageQueue.getOutgoingChannelMessageFromQueue(i).channelName);
-                //Logger::writeToLog(messageQueue.getOutgoingChannelMessageFromQueue(i).stringVal);
-                csound->SetChannel(message.channelName.getCharPointer(),
-                                   message.stringVal.toUTF8().getAddress());
+                if(!channelSmoother.setTarget(channelBindings.getSlotControlIndex(message.slot), message.value))
+                    *channelPtr = message.value;
             }
             else
-                csound->SetChannel(message.channelName.getCharPointer(),
+                csound->SetChannel(messageQueue.getChannelName(message).getCharPointer(),
                                    message.value);
-        }
 
-        messageQueue.flushOutgoingChannelMessages();
+            messageQueue.releaseOutgoingChannelMessage(message);
+        }
     }
 
 #endif
+    return tablesWritten;
 }
 
 
@@ -1982,6 +2511,131 @@ void CabbagePluginAudioProcessor::prepareToPlay (double sampRate, int samplesPer
     //showMessage(String(this->getNumOutputChannels()));
     keyboardState.reset();
     sampleRate = sampRate;
+    levelMeter.prepare(sampRate);
+
+#ifndef Cabbage_No_Csound
+    preparedBlockSize = samplesPerBlock;
+    //new instances are compiled at getSampleRate(), which not every caller sets
+    setRateAndBufferSizeDetails(sampRate, samplesPerBlock);
+    if(csCompileResult==OK)
+    {
+        //Csound runs at the host's rate, and alignksmps(1) asks for a ksmps that divides
+        //the host's block. If the running instance doesn't fit, a new one is compiled in
+        //the background and timerCallback() swaps it in. Until then the current one
+        //keeps playing, so hosts that prepare often aren't held up by compiles
+        const int ksmps = getAlignedKsmps(getRequestedKsmps(csdFile, oversampling));
+        if((ksmps>0 && ksmps!=getCsoundKsmpsSize()) || csound->GetSr()!=sampRate*oversampling)
+        {
+            recompileCsound(csdFile);
+            hostRecompilePending = true;
+        }
+
+        const ScopedLock sl(getCallbackLock());
+        //the host's channel count may have changed
+        if(oversampler!=nullptr)
+            prepareOversampler(oversampler, getCsoundKsmpsSize());
+        chooseLatencyMode();
+    }
+    setLatencySamples(getReportedLatency());
+#endif
+}
+
+//==============================================================================
+//sizes the filters for spans of up to a k-cycle of host samples
+void CabbagePluginAudioProcessor::prepareOversampler(CabbageOversampler* target, int hostKsmps)
+{
+    target->prepare(jmax(1, getNumInputChannels(), getNumOutputChannels()), jmax(1, hostKsmps));
+    target->reset();
+}
+
+//==============================================================================
+//the ksmps the file asks for, in host samples
+int CabbagePluginAudioProcessor::getRequestedKsmps(const File& file, int factor)
+{
+    const float kr = cUtils::getKrFromFile(file.getFullPathName(), (int)getSampleRate()*factor);
+    return kr>0 ? jmax(1, roundToInt(getSampleRate()/kr)) : 1;
+}
+
+//the largest ksmps that divides the host's block, or 0 if there's no need for one.
+//It won't go below a quarter of what was asked for, as the k-rate would get too high
+int CabbagePluginAudioProcessor::getAlignedKsmps(int requestedKsmps) const
+{
+    if(!alignKsmps || preparedBlockSize<=0)
+        return 0;
+
+    for(int ksmps=jmin(requestedKsmps, preparedBlockSize); ksmps*4>=requestedKsmps; ksmps--)
+        if(preparedBlockSize%ksmps==0)
+            return ksmps;
+    return 0;
+}
+
+#ifndef Cabbage_No_Csound
+//Csound runs at the host's rate times factor. ksmps is rounded to a multiple of
+//the factor, so k-cycles start on host samples, or picked to suit the host's block
+void CabbagePluginAudioProcessor::setRateOverrides(CSOUND_PARAMS* params, const File& file, int factor)
+{
+    const int requestedKsmps = getRequestedKsmps(file, factor);
+    alignedKsmps = getAlignedKsmps(requestedKsmps);
+    params->sample_rate_override = getSampleRate()*factor;
+    if(factor>1 || alignedKsmps>0)
+        params->control_rate_override = getSampleRate()/(alignedKsmps>0 ? alignedKsmps : requestedKsmps);
+    else
+        params->control_rate_override = cUtils::getKrFromFile(file.getFullPathName(), (int)getSampleRate());
+}
+
+//the parameters and options for a compile, shared by the first compile and every
+//recompile so the two can't drift apart
+void CabbagePluginAudioProcessor::setCompileOptions(CabbageCsound* instance, const File& file, const String& csdText, int factor)
+{
+    csoundParams = nullptr;
+    csoundParams = new CSOUND_PARAMS();
+#ifndef CABBAGE_HOST
+    csoundParams->nchnls_override = this->getNumOutputChannels();
+#endif
+
+    alignKsmps = cUtils::getFormIdentifierFromFile(csdText, "alignksmps", 0)>0;
+    setRecompileCrossfadeTime(cUtils::getFormIdentifierFromFile(csdText, "crossfade", 50));
+    setRateOverrides(csoundParams, file, factor);
+
+    csoundParams->displays = 0;
+    instance->SetParams(csoundParams);
+    instance->SetOption((char*)"-n");
+    instance->SetOption((char*)"-d");
+    if(compiledAsPlugin)
+        instance->SetOption((char*)"--omacro:IS_A_PLUGIN=\"1\"");
+
+#ifdef AndroidBuild
+    instance->SetOption((char*)"--omacro:IS_ANDROID=\"1\"");
+#endif
+    setScreenMacros(instance);
+    addMacros(instance, csdText);
+}
+#endif
+
+//only call this while the audio thread is locked out
+void CabbagePluginAudioProcessor::chooseLatencyMode()
+{
+#ifndef Cabbage_No_Csound
+    const int hostKsmps = getCsoundKsmpsSize();
+    const LatencyMode mode = (alignKsmps && preparedBlockSize>0 && preparedBlockSize%hostKsmps==0)
+                             ? alignedLatency : bufferedLatency;
+    if(mode==alignedLatency)
+        csndIndex = 0;
+    else if(latencyMode==alignedLatency)
+        csndIndex = hostKsmps;
+    latencyMode = mode;
+#endif
+}
+
+//in host samples, including the oversampling filters
+int CabbagePluginAudioProcessor::getReportedLatency()
+{
+#ifndef Cabbage_No_Csound
+    if(csCompileResult==OK)
+        return (latencyMode==bufferedLatency ? getCsoundKsmpsSize() : 0)
+               + (oversampler!=nullptr ? oversampler->getLatencyInSamples() : 0);
+#endif
+    return 0;
 }
 //==============================================================================
 void CabbagePluginAudioProcessor::releaseResources()
@@ -1996,6 +2650,26 @@ void CabbagePluginAudioProcessor::releaseResources()
 void CabbagePluginAudioProcessor::timerCallback()
 {
 #ifndef Cabbage_No_Csound
+    if(compileThread!=nullptr && compileThread->hasFinished())
+        swapInCompiledCsound(true);
+    //processBlock() takes a compile over between k-cycles. If the host has
+    //stopped calling it, or it isn't running Csound, it's done from here
+    if(preparedCsoundPending.get()!=0 && Time::getMillisecondCounter()-preparedCsoundTime>500)
+        adoptPreparedCsound();
+    deleteReplacedCsound();
+    deleteRetiredCsound();
+    deleteSupersededCompiles();
+    if(latencyChanged.compareAndSetBool(0, 1))
+        setLatencySamples(getReportedLatency());
+
+    const int dropped = messageQueue.getNumDroppedMessages();
+    if(dropped!=reportedDroppedMessages)
+    {
+        Logger::writeToLog("Cabbage: the message queue is full, "+String(dropped-reportedDroppedMessages)
+                           +" channel messages to Csound were dropped");
+        reportedDroppedMessages = dropped;
+    }
+
     for(int y=0; y<xyAutomation.size(); y++)
     {
         if(xyAutomation[y])
@@ -2010,7 +2684,6 @@ void CabbagePluginAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiB
     float** audioBuffers = buffer.getArrayOfWritePointers();
     const int numSamples = buffer.getNumSamples();
     const int output_channel_count = getNumOutputChannels();
-    float samp;
 
     if(stopProcessing || isGuiEnabled())
     {
@@ -2031,66 +2704,86 @@ void CabbagePluginAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiB
 
 
             keyboardState.processNextMidiBuffer (midiMessages, 0, numSamples, true);
-            midiBuffer = midiMessages;
-            //midiBuffer.clear();
-
-#if JucePlugin_ProducesMidiOutput
-            if(!midiOutputBuffer.isEmpty())
+            //clear() keeps midiBuffer's storage, so this doesn't allocate once it has grown
+            midiBuffer.clear();
+            midiBuffer.addEvents(midiMessages, 0, numSamples, 0);
+            midiReadPosition = 0;
+
+            //when oversampling, spans and k-cycles are counted in host samples
+            int hostKsmps = csdKsmps/oversampling;
+            refreshScheduler.startBlock(getSampleRate(), hostKsmps, guiRefreshRate);
+            channelBindings.setHostChannel(CabbageChannelBindings::cpuLoad, refreshScheduler.getLoad());
+            updateHostChannels();
+
+            //a host can send a block that isn't a whole number of k-cycles at any time.
+            //Rather than run a partial one, fall back to buffering. The k-cycle in flight
+            //starts from silence and timerCallback() reports the new latency
+            if(latencyMode==alignedLatency && numSamples%hostKsmps!=0)
             {
-                midiMessages.swapWith(midiOutputBuffer);
+                latencyMode = bufferedLatency;
+                zeromem(CSspin, sizeof(MYFLT)*csdKsmps*output_channel_count);
+                csndIndex = hostKsmps;
+                latencyChanged.set(1);
             }
-            else
-                midiMessages.clear();
-#endif
-
-            const CriticalSection &callback_lock = getCallbackLock();
+            bool aligned = latencyMode==alignedLatency;
 
-            for(int i=0; i<numSamples; i++, ++csndIndex)
+            //work in spans that end on the next ksmps boundary. When buffering, a k-cycle
+            //runs as a span reaches the boundary and reads the input gathered over the
+            //previous one. When aligned to the host's blocks, every span is a whole k-cycle
+            //that runs as soon as its own input is written
+            for(int i=0; i<numSamples;)
             {
-                if(csndIndex == csdKsmps)
+                //a compile swapInCompiledCsound() has handed over is taken on at a
+                //k-cycle boundary, once the outgoing instance has played its last one out
+                if(preparedCsoundPending.get()!=0 && csndIndex==(aligned ? 0 : hostKsmps))
                 {
-                    callback_lock.enter();
-                    //slow down calls to these functions, no need for them to be firing at k-rate
-                    if (guiRefreshRate < yieldCounter)
+                    adoptPreparedCsound();
+                    hostKsmps = csdKsmps/oversampling;
+                    if(latencyMode==alignedLatency && (numSamples-i)%hostKsmps!=0)
                     {
-                        yieldCounter = 0;
-                        sendOutgoingMessagesToCsound();
-                        updateCabbageControls();
-                        sendChangeMessage();
+                        latencyMode = bufferedLatency;
+                        zeromem(CSspin, sizeof(MYFLT)*csdKsmps*output_channel_count);
+                        csndIndex = hostKsmps;
                     }
-                    else
-                        ++yieldCounter;
-
-                    csCompileResult = csound->PerformKsmps();
-
-                    if(csCompileResult!=OK)
-                        stopProcessing = true;
-                    else
-                        ++ksmpsOffset;
+                    aligned = latencyMode==alignedLatency;
+                }
 
-                    callback_lock.exit();
+                if(!aligned && csndIndex == hostKsmps)
+                {
+                    performCsoundKsmps(i, hostKsmps);
                     csndIndex = 0;
                 }
                 if(csCompileResult==OK)
                 {
+                    const int span = jmin(numSamples-i, hostKsmps-csndIndex);
                     pos = csndIndex * output_channel_count;
-                    for(int channel = 0; channel < output_channel_count; ++channel)
+                    writeCsoundInput(audioBuffers, i, span, output_channel_count, pos);
+                    if(aligned)
+                        performCsoundKsmps(i, hostKsmps);
+                    if(csCompileResult!=OK)
                     {
-                        float *&current_buffer = audioBuffers[channel];
-                        samp = *current_buffer * cs_scale;
-                        CSspin[pos] = samp;
-                        *current_buffer = (CSspout[pos] / cs_scale);
-                        ++current_buffer;
-                        ++pos;
-
+                        buffer.clear();
+                        break;
                     }
-
+                    readCsoundOutput(audioBuffers, i, span, output_channel_count, pos);
+                    if(!aligned)
+                        csndIndex += span;
+                    i += span;
                 }
                 else
+                {
                     buffer.clear();
+                    break;
+                }
+            }
 
+            //events after the last k-cycle that started in this block go to the next one
+            queueMidiInput(midiReadPosition, numSamples);
 
-            }
+#if JucePlugin_ProducesMidiOutput
+            midiMessages.swapWith(midiOutputBuffer);
+#endif
+            midiOutputBuffer.clear();
 
             if (activeWriter != 0 && !isWinXP)
                 activeWriter->write (buffer.getArrayOfReadPointers(), numSamples);
@@ -2098,8 +2791,7 @@ void CabbagePluginAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiB
             if(isMuted)
                 buffer.clear();
 
-            rmsLeft = buffer.getRMSLevel(0, 0, numSamples);
-            rmsRight = buffer.getRMSLevel(1, 0, numSamples);
+            refreshScheduler.endBlock(numSamples);
 
         }//if not compiled just mute output
         else
@@ -2118,12 +2810,117 @@ void CabbagePluginAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiB
 #endif
     }
 
-    vuCounter = (vuCounter>5) ? 0 : vuCounter+1;
-    if(vuCounter==0)
-        sendActionMessage("rmsValues "+String(rmsLeft)+" "+String(rmsRight));
+    levelMeter.process(buffer, numSamples);
 }
 
 
+//==============================================================================
+//one k-cycle, starting at startSample in the host's block
+void CabbagePluginAudioProcessor::performCsoundKsmps(int startSample, int hostKsmps)
+{
+#ifndef Cabbage_No_Csound
+    const ScopedLock sl(getCallbackLock());
+    //parameter changes are applied on every k-cycle, independently of
+    //the GUI refresh rate, so automation isn't quantised to it
+    const bool tablesWritten = sendOutgoingMessagesToCsound();
+    presetBank.process(channelBindings, channelSmoother, channelBindings.getHostChannel(CabbageChannelBindings::presetMorph));
+    channelSmoother.process();
+
+    //slow down calls to these functions, no need for them to be firing at k-rate.
+    //The interval follows the measured load, see CabbageRefreshScheduler
+    if (refreshScheduler.getRefreshInterval() < yieldCounter)
+    {
+        yieldCounter = 0;
+        updateCabbageControls();
+        sendChangeMessage();
+    }
+    else
+        ++yieldCounter;
+
+    //hand Csound the MIDI that arrived along with this k-cycle's input. When
+    //aligned that is the span about to be played. When buffering, the input
+    //was gathered over the previous k-cycle, so MIDI is held back by one
+    //k-cycle as well and reaches the output with the same latency as audio
+    if(latencyMode==alignedLatency)
+        queueMidiInput(midiReadPosition, startSample+hostKsmps);
+    else
+        queueMidiInput(midiReadPosition, startSample);
+    midiWritePosition = startSample;
+    csCompileResult = csound->PerformKsmps();
+    if(retiringCsound!=nullptr && retiringCsoundFinished.get()==0)
+        retiringCsound->PerformKsmps();
+    //f-statements only take effect once Csound has performed
+    if(tablesWritten)
+        tableMirror.markTablesWritten();
+
+    if(csCompileResult!=OK)
+        stopProcessing = true;
+    else
+        ++ksmpsOffset;
+#endif
+}
+
+//copies a span of the host's input into spin, at pos in the current k-cycle
+void CabbagePluginAudioProcessor::writeCsoundInput(float** audioBuffers, int startSample, int numFrames, int numChannels, int pos)
+{
+#ifndef Cabbage_No_Csound
+    if(oversampler!=nullptr)
+    {
+        jassert(oversampler->getNumChannels()>=numChannels);
+        oversampler->upsample(audioBuffers, startSample, numFrames);
+        cUtils::interleaveSamples(CSspin+pos*oversampling, oversampler->getUpsampledChannels(), 0, numChannels, numFrames*oversampling, cs_scale);
+        return;
+    }
+
+    if(retiringCsound!=nullptr && retiringCsoundFinished.get()==0)
+        cUtils::interleaveSamples(retiringSpin+pos, audioBuffers, startSample, numChannels, numFrames, retiringScale);
+    cUtils::interleaveSamples(CSspin+pos, audioBuffers, startSample, numChannels, numFrames, cs_scale);
+#endif
+}
+
+//the reverse of writeCsoundInput(), mixing in any instance that's being faded out
+void CabbagePluginAudioProcessor::readCsoundOutput(float** audioBuffers, int startSample, int numFrames, int numChannels, int pos)
+{
+#ifndef Cabbage_No_Csound
+    const float outputScale = 1.f/cs_scale;
+    if(oversampler!=nullptr)
+    {
+        cUtils::deinterleaveSamples(oversampler->getDownsamplerInput(), 0, CSspout+pos*oversampling, numChannels, numFrames*oversampling, outputScale);
+        oversampler->downsample(audioBuffers, startSample, numFrames);
+        return;
+    }
+
+    cUtils::deinterleaveSamples(audioBuffers, startSample, CSspout+pos, numChannels, numFrames, outputScale);
+    if(retiringCsound!=nullptr && retiringCsoundFinished.get()==0)
+        crossfadeRetiringCsound(audioBuffers, startSample, numFrames, numChannels, pos);
+#endif
+}
+
+//==============================================================================
+//mixes the instance being replaced by recompileCsound() into a span that already
+//holds the new instance's output, using an equal power crossfade
+void CabbagePluginAudioProcessor::crossfadeRetiringCsound(float** audioBuffers, int startSample, int numFrames, int numChannels, int pos)
+{
+#ifndef Cabbage_No_Csound
+    const float outputScale = 1.f/retiringScale;
+    for(int i=0; i<numFrames; i++, ++crossfadePosition)
+    {
+        const bool fading = crossfadePosition<crossfadeLength;
+        const float fadeIn = fading ? crossfadeGains[crossfadePosition] : 1.f;
+        const float fadeOut = fading ? crossfadeGains[crossfadeLength-1-crossfadePosition]*outputScale : 0.f;
+        const MYFLT* retiringFrame = retiringSpout+pos+i*numChannels;
+        for(int channel=0; channel<numChannels; channel++)
+        {
+            float& sample = audioBuffers[channel][startSample+i];
+            sample = sample*fadeIn + float(retiringFrame[channel])*fadeOut;
+        }
+    }
+
+    if(crossfadePosition>=crossfadeLength)
+        retiringCsoundFinished.set(1);
+#endif
+}
+
 //==============================================================================
 // MIDI functions
 //==============================================================================
@@ -2140,7 +2937,7 @@ int CabbagePluginAudioProcessor::OpenMidiInputDevice(CSOUND * csound, void **use
 //==============================================================================
 // Reads MIDI input data from host, gets called every time there is MIDI input to our plugin
 //==============================================================================
-int CabbagePluginAudioProcessor::ReadMidiData(CSOUND* /*csound*/, void *userData,
+int CabbagePluginAudioProcessor::ReadMidiData(CSOUND* csound, void *userData,
         unsigned char *mbuf, int nbytes)
 {
     CabbagePluginAudioProcessor *midiData = (CabbagePluginAudioProcessor *)userData;
@@ -2150,29 +2947,53 @@ int CabbagePluginAudioProcessor::ReadMidiData(CSOUND* /*csound*/, void *userData
         return 0;
     }
 
+    //instances that are still compiling, or being faded out, don't get any MIDI
+    if(midiData->csound==nullptr || midiData->csound->GetCsound()!=csound)
+        return 0;
+
+    //only pass on whole messages, whatever doesn't fit waits for the next call
+    const uint8* queue = midiData->midiInputQueue;
     int cnt=0;
+    while(cnt < midiData->midiInputQueueUsed)
+    {
+        const int length = MidiMessage::getMessageLengthFromFirstByte(queue[cnt]);
+        if(cnt+length > nbytes)
+            break;
+        memcpy(mbuf+cnt, queue+cnt, length);
+        cnt+=length;
+    }
+
+    midiData->midiInputQueueUsed -= cnt;
+    memmove(midiData->midiInputQueue, queue+cnt, midiData->midiInputQueueUsed);
+    return cnt;
+
+}
 
-    if(!midiData->midiBuffer.isEmpty() && cnt <= (nbytes - 3))
+//==============================================================================
+// Moves the host's MIDI events between startSample and endSample into the queue
+// read by ReadMidiData(). Csound only reads MIDI once per k-cycle, so this is
+// called once for each k-cycle performed in processBlock()
+//==============================================================================
+void CabbagePluginAudioProcessor::queueMidiInput(int startSample, int endSample)
+{
+    if(endSample<=startSample)
+        return;
+
+    MidiBuffer::Iterator i(midiBuffer);
+    i.setNextSamplePosition(startSample);
+    const uint8* data;
+    int size, samplePosition;
+    while(i.getNextEvent(data, size, samplePosition) && samplePosition<endSample)
     {
-        MidiMessage message(0xf4, 0, 0, 0);
-        MidiBuffer::Iterator i (midiData->midiBuffer);
-        int messageFrameRelativeTothisProcess;
-        while (i.getNextEvent (message, messageFrameRelativeTothisProcess))
+        //sysex isn't passed on
+        if(size<=3 && midiInputQueueUsed+size<=midiInputQueueSize)
         {
-            const uint8* data = message.getRawData();
-            *mbuf++ = *data++;
-            *mbuf++ = *data++;
-            *mbuf++ = *data++;
-
-            if(message.isProgramChange() || message.isChannelPressure())
-                cnt+=2;
-            else
-                cnt+=3;
+            memcpy(midiInputQueue+midiInputQueueUsed, data, size);
+            midiInputQueueUsed+=size;
         }
-        midiData->midiBuffer.clear();
     }
-    return cnt;
 
+    midiReadPosition = endSample;
 }
 
 //==============================================================================
@@ -2193,7 +3014,7 @@ int CabbagePluginAudioProcessor::OpenMidiOutputDevice(CSOUND * csound, void **us
 // Write MIDI data to plugin's MIDI output. Each time Csound outputs a midi message this
 // method should be called. Note: you must have -Q set in your CsOptions
 //==============================================================================
-int CabbagePluginAudioProcessor::WriteMidiData(CSOUND* /*csound*/, void *_userData,
+int CabbagePluginAudioProcessor::WriteMidiData(CSOUND* csound, void *_userData,
         const unsigned char *mbuf, int nbytes)
 {
     CabbagePluginAudioProcessor *userData = (CabbagePluginAudioProcessor *)_userData;
@@ -2203,9 +3024,13 @@ int CabbagePluginAudioProcessor::WriteMidiData(CSOUND* /*csound*/, void *_userDa
         return 0;
     }
 
+    if(userData->csound==nullptr || userData->csound->GetCsound()!=csound)
+        return nbytes;
+
+    //timestamp with the start of the k-cycle that produced the message
     MidiMessage message(mbuf, nbytes, 0);
     //Logger::writeToLog(String(message.getNoteNumber()));
-    userData->midiOutputBuffer.addEvent(message, 0);
+    userData->midiOutputBuffer.addEvent(message, userData->midiWritePosition);
     return nbytes;
 }
 
@@ -2224,13 +3049,12 @@ AudioProcessorEditor* CabbagePluginAudioProcessor::createEditor()
 //==============================================================================
 void CabbagePluginAudioProcessor::getStateInformation (MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // Here's an example of how you can use XML to make it easy and more robust:
-    // Create an outer XML element..
-    XmlElement xml ("CABBAGE_PLUGIN_SETTINGS");
-    cUtils::debug(guiCtrls.size());
+    // The state is a CabbagePluginState chunk, see CabbagePluginState.h for its layout.
+    CabbagePluginState state;
+    state.csdHash = runningCsdHash;
+
     for(int i=0; i<guiCtrls.size(); i++)
-        xml.setAttribute(guiCtrls[i].getStringProp(CabbageIDs::channel),getParameter(i));
+        state.addValue(guiCtrls[i].getStringProp(CabbageIDs::channel), getParameter(i));
 
     for(int i=0; i<guiLayoutCtrls.size(); i++)
         if(guiLayoutCtrls[i].getStringProp(CabbageIDs::type)==CabbageIDs::filebutton)
@@ -2238,29 +3062,85 @@ void CabbagePluginAudioProcessor::getStateInformation (MemoryBlock& destData)
             //save filebutton last opened file...
             char string[4096] = {0};
             csound->GetStringChannel(guiLayoutCtrls[i].getStringProp(CabbageIDs::channel).toUTF8().getAddress(), string);
-            xml.setAttribute ("filebutton_"+guiLayoutCtrls[i].getStringProp(CabbageIDs::channel), String(string));
+            state.addString(CabbagePluginState::fileButton, guiLayoutCtrls[i].getStringProp(CabbageIDs::channel), String(string));
         }
         else if(guiLayoutCtrls[i].getStringProp(CabbageIDs::type)==CabbageIDs::sourcebutton)
         {
-            xml.setAttribute("sourcebutton", csdFile.getFullPathName());
+            state.csdPath = csdFile.getFullPathName();
         }
         else if(guiLayoutCtrls[i].getStringProp(CabbageIDs::type)==CabbageIDs::texteditor)
         {
-            xml.setAttribute(guiLayoutCtrls[i].getStringProp(CabbageIDs::name), guiLayoutCtrls[i].getStringProp(CabbageIDs::text));
+            state.addString(CabbagePluginState::textEditor, guiLayoutCtrls[i].getStringProp(CabbageIDs::name), guiLayoutCtrls[i].getStringProp(CabbageIDs::text));
         }
 
 #ifdef CABBAGE_AU
-    xml.setAttribute("sourcefile", csdFile.getFullPathName());
+    state.csdPath = csdFile.getFullPathName();
 #endif
-    // then use this helper function to stuff it into the binary blob and return it..
-    copyXmlToBinary (xml, destData);
-
+    state.writeTo(destData);
 }
 
 void CabbagePluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    if(!CabbagePluginState::isBinaryState(data, sizeInBytes))
+    {
+        setXmlStateInformation(data, sizeInBytes);
+        return;
+    }
+
+    CabbagePluginState state;
+    if(!state.readFrom(data, sizeInBytes))
+        return;
+
+    //only AU builds and instruments with a sourcebutton save their .csd
+    if(state.csdPath.isNotEmpty())
+        restoreCsdFile(File(state.csdPath), state.csdHash);
+
+    for(int i=0; i<getNumParameters(); i++)
+    {
+        float value;
+        if(state.getValue(guiCtrls[i].getStringProp(CabbageIDs::channel), value))
+            setParameter(i, value);
+    }
+
+    for(int i=0; i<state.getNumStrings(); i++)
+    {
+        const CabbagePluginState::StringEntry& entry = state.getString(i);
+        if(entry.kind==CabbagePluginState::fileButton)
+            messageQueue.addOutgoingChannelMessageToQueue(entry.name, entry.value, "string");
+        else if(entry.kind==CabbagePluginState::textEditor)
+        {
+            for(int y=0; y<guiLayoutCtrls.size(); y++)
+                if(guiLayoutCtrls[y].getStringProp(CabbageIDs::type)==CabbageIDs::texteditor
+                        && guiLayoutCtrls[y].getStringProp(CabbageIDs::name)==entry.name)
+                    guiLayoutCtrls.getReference(y).setStringProp(CabbageIDs::text, entry.value);
+        }
+    }
+}
+
+//==============================================================================
+// Reloads the instrument a state was saved with, unless that is exactly what is
+// running already, in which case there is nothing to recompile. The compile
+// happens here rather than in the background, so that the new instance is
+// running, and swapInCompiledCsound() has sent it its defaults, before the caller
+// restores the saved values
+//==============================================================================
+void CabbagePluginAudioProcessor::restoreCsdFile(const File& file, int64 hash)
+{
+    if(csCompileResult==OK && file==csdFile && hash==runningCsdHash)
+        return;
+
+    csdFile = file;
+    initialiseWidgets(csdFile.loadFileAsString(), true);
+    addWidgetsToEditor(true);
+    recompileCsound(csdFile, false);
+    updateHostDisplay();
+}
+
+//==============================================================================
+// States saved before CabbagePluginState were XML, with one attribute per channel
+//==============================================================================
+void CabbagePluginAudioProcessor::setXmlStateInformation (const void* data, int sizeInBytes)
+{
     // This getXmlFromBinary() helper function retrieves our XML from the binary blob..
     ScopedPointer<XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
 
@@ -2272,11 +3152,8 @@ void CabbagePluginAudioProcessor::setStateInformation (const void* data, int siz
             if(xmlState->getAttributeName(i).contains("sourcefile"))
             {
                 //showMessage(xmlState->getAttributeValue(i));
-                csdFile = File(xmlState->getAttributeValue(i));
-                initialiseWidgets(csdFile.loadFileAsString(), true);
-                addWidgetsToEditor(true);
-                recompileCsound(csdFile);
-                updateHostDisplay();
+                const File file(xmlState->getAttributeValue(i));
+                restoreCsdFile(file, file.loadFileAsString().hashCode64());
             }
             else if(xmlState->getAttributeName(i).contains("texteditor"))
             {
@@ -2288,6 +3165,17 @@ void CabbagePluginAudioProcessor::setStateInformation (const void* data, int siz
         // make sure that it's actually our type of XML object..
         if (xmlState->hasTagName ("CABBAGE_PLUGIN_SETTINGS"))
         {
+            //the instrument has to be reloaded before its values are restored
+            for(int i=0; i<xmlState->getNumAttributes(); i++)
+            {
+                if(xmlState->getAttributeName(i).contains("sourcebutton"))
+                {
+                    //showMessage(xmlState->getAttributeValue(i));
+                    const File file(xmlState->getAttributeValue(i));
+                    restoreCsdFile(file, file.loadFileAsString().hashCode64());
+                }
+            }
+
             for(int i=0; i<this->getNumParameters(); i++)
             {
                 this->setParameter(i, (float)xmlState->getDoubleAttribute(guiCtrls[i].getStringProp(CabbageIDs::channel)));
@@ -2304,14 +3192,6 @@ void CabbagePluginAudioProcessor::setStateInformation (const void* data, int siz
                     //Logger::writeToLog(xmlState->getAttributeValue(i));
                     csound->SetChannel(channel.toUTF8().getAddress(), xmlState->getAttributeValue(i).toUTF8().getAddress());
                 }
-                else  if(xmlState->getAttributeName(i).contains("sourcebutton"))
-                {
-                    //showMessage(xmlState->getAttributeValue(i));
-                    csdFile = File(xmlState->getAttributeValue(i));
-                    initialiseWidgets(csdFile.loadFileAsString(), true);
-                    addWidgetsToEditor(true);
-                    recompileCsound(csdFile);
-                }
             }
         }
     }
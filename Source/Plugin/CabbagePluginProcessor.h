@@ -25,6 +25,16 @@
 #include "../CabbageGUIClass.h"
 #include "../XYPadAutomation.h"
 #include "../CabbageMessageSystem.h"
+#include "../CabbageChannelBindings.h"
+#include "../CabbageRefreshScheduler.h"
+#include "../CabbageLevelMeter.h"
+#include "../CabbageTableMirror.h"
+#include "../CabbageGraphFrameStore.h"
+#include "../CabbageConsoleBuffer.h"
+#include "../CabbagePluginState.h"
+#include "../CabbagePresetBank.h"
+#include "../CabbageChannelSmoother.h"
+#include "../CabbageOversampler.h"
 //sample widget
 #include "../Soundfiler.h"
 #ifndef AndroidBuild
@@ -68,6 +78,97 @@ class CodeWindow;
 #include <csdebug.h>
 #endif
 
+#ifndef Cabbage_No_Csound
+#if !defined(AndroidBuild)
+typedef Csound CabbageCsound;
+#else
+typedef AndroidCsound CabbageCsound;
+#endif
+
+//==============================================================================
+// Compiles and pre-rolls a Csound instance on its own thread, so that
+// recompileCsound() doesn't hold up the message or audio threads. Csound
+// can't be interrupted part way through a compile, so a compile that is no
+// longer wanted is told to exit, skips the pre-roll, and is deleted once its
+// thread has stopped
+//==============================================================================
+class CsoundCompileThread : public Thread
+{
+public:
+    CsoundCompileThread(CabbageCsound* instance, const File& file)
+        : Thread("Csound compiler"), csound(instance), csdFile(file), compileResult(-1)
+    {}
+
+    ~CsoundCompileThread()
+    {
+        stopThread(-1);
+    }
+
+    void run()
+    {
+        compileResult = csound->Compile(const_cast<char*>(csdFile.getFullPathName().toUTF8().getAddress()));
+        if(compileResult==OK && !threadShouldExit())
+        {
+            //simple hack to allow tables to be set up correctly. The pre-roll runs
+            //alongside the instance that is playing, so it is given no host data and
+            //the processor's console and graph callbacks ignore it
+            void* hostData = csound->GetHostData();
+            csound->SetHostData(nullptr);
+            csound->PerformKsmps();
+            csound->SetScoreOffsetSeconds(0);
+            csound->RewindScore();
+            csound->SetHostData(hostData);
+        }
+        finished.set(1);
+    }
+
+    bool hasFinished() const
+    {
+        return finished.get()==1;
+    }
+
+    int getCompileResult() const
+    {
+        return compileResult;
+    }
+
+    CabbageCsound* releaseInstance()
+    {
+        return csound.release();
+    }
+
+private:
+    ScopedPointer<CabbageCsound> csound;
+    File csdFile;
+    int compileResult;
+    Atomic<int> finished;
+};
+
+//==============================================================================
+// A compiled instance along with everything that has to change with it. The
+// message thread sets one up in swapInCompiledCsound() while the current
+// instance keeps playing, and the audio thread takes it over between two
+// k-cycles by swapping pointers, see adoptPreparedCsound(). Afterwards it
+// holds whatever it replaced, until the message thread deletes it
+//==============================================================================
+struct CabbagePreparedCsound
+{
+    CabbagePreparedCsound() : oversampling(1), fadeLength(0), csdHash(0) {}
+
+    ScopedPointer<CabbageCsound> instance;
+    ScopedPointer<CabbageOversampler> oversampler;
+    int oversampling;
+    CabbageChannelBindings bindings;
+    CabbageChannelSmoother smoother;
+    HeapBlock<float> fadeGains;
+    int fadeLength;                             //0 to switch without a crossfade
+    int64 csdHash;
+    ScopedPointer<CabbageCsound> retired;       //an instance that was still being faded out
+
+    JUCE_DECLARE_NON_COPYABLE(CabbagePreparedCsound)
+};
+#endif
+
 
 //==============================================================================
 // CabbagePluginAudioProcessor definition
@@ -78,17 +179,23 @@ class CabbagePluginAudioProcessor  : public AudioProcessor,
     public Timer,
     public ActionBroadcaster,
     public ChangeListener,
-    public ActionListener
+    public ActionListener,
+    public AsyncUpdater
 {
     //==============================================================================
     File csdFile;
+    int64 runningCsdHash;                      //hash of the .csd text the running instance compiled
+    void restoreCsdFile(const File& file, int64 hash);
+    void setXmlStateInformation(const void* data, int sizeInBytes);
     int masterCounter;
     String filename;
     String pluginName;
     bool csoundStatus;
     int csCompileResult;
     void timerCallback();
-    String csoundOutput;
+    void handleAsyncUpdate();
+    void warnIfIdentMessageTruncated(CabbageGUIType& guiCtrl, bool truncated);
+    CabbageConsoleBuffer console;              //the last lines Csound printed
     String debuggerMessage;
     void changeListenerCallback(ChangeBroadcaster *source);
     String changeMessageType;
@@ -116,10 +223,9 @@ class CabbagePluginAudioProcessor  : public AudioProcessor,
     File logFile;
     bool isAutomator;
     bool isWinXP;
-    bool updateFFTDisplay;
     bool isNativeThreadRunning;
     String csoundDebuggerOutput;
-    float rmsLeft, rmsRight;
+    CabbageLevelMeter levelMeter;
 
     //============== Csound related variables/methods ==============================
 #ifndef Cabbage_No_Csound
@@ -138,6 +244,44 @@ class CabbagePluginAudioProcessor  : public AudioProcessor,
     int CSCompResult;                       //result of Csound performKsmps
     controlChannelInfo_s* csoundChanList;
     int numCsoundChannels;          //number of Csound channels
+    CabbageChannelBindings channelBindings;    //pre-resolved channel pointers
+    CabbageTableMirror tableMirror;            //float copies of the tables the GUI shows
+    CabbageGraphFrameStore graphFrames;        //latest frames from Csound's graph callbacks
+    CabbagePresetBank presetBank;              //recalled and morphed on the audio thread
+    File presetBankFile;                       //where presetBank was loaded from, and is saved to
+    CabbageChannelSmoother channelSmoother;    //k-rate ramps for widgets that use smooth()
+    ScopedPointer<CabbageOversampler> oversampler;  //only while the form asks for oversample()
+    int oversampling;                          //Csound runs at this many times the host rate
+    void prepareOversampler(CabbageOversampler* target, int hostKsmps);
+    void bindCsoundChannels();
+    void allocateIdentMailbox();
+    void resolveCsoundChannels(CabbageCsound* instance, CabbageChannelBindings& bindings, CabbageChannelSmoother& smoother);
+    CabbageIdentChannelMailbox identMailbox;   //identchannel strings waiting to be parsed
+    //recompiling in the background and crossfading to the new instance
+    ScopedPointer<CsoundCompileThread> compileThread;
+    OwnedArray<CsoundCompileThread> supersededCompiles;   //still finishing, see deleteSupersededCompiles()
+    File recompileFile;
+    int64 recompileCsdHash;
+    int recompileOversampling;
+    ScopedPointer<CabbageCsound> retiringCsound;  //previous instance, faded out by the audio thread
+    MYFLT *retiringSpin, *retiringSpout;
+    MYFLT retiringScale;
+    HeapBlock<float> crossfadeGains;
+    int crossfadeLength, crossfadePosition;
+    Atomic<int> retiringCsoundFinished;
+    int recompileCrossfadeTime;                 //in milliseconds, from the form's crossfade()
+    ScopedPointer<CabbagePreparedCsound> preparedCsound;  //waiting for the audio thread, under the callback lock
+    ScopedPointer<CabbagePreparedCsound> replacedCsound;  //what it replaced, deleted by timerCallback()
+    Atomic<int> preparedCsoundPending, csoundReplaced;
+    uint32 preparedCsoundTime;                  //when it was handed over, see timerCallback()
+    void configureCsoundInstance(CabbageCsound* instance);
+    void setInitialChannelValues(CabbageCsound* instance);
+    void swapInCompiledCsound(bool crossfade);
+    void adoptPreparedCsound();
+    void deleteRetiredCsound();
+    void deleteReplacedCsound();
+    void deleteSupersededCompiles();
+    void crossfadeRetiringCsound(float** audioBuffers, int startSample, int numFrames, int numChannels, int pos);
     static void messageCallback(CSOUND *csound, int attr, const char *fmt, va_list args);  //message callback function
 #if defined(BUILD_DEBUGGER) && !defined(Cabbage_No_Csound)
     static void breakpointCallback(CSOUND *csound, debug_bkpt_info_t *bkpt_info, void *udata);
@@ -156,7 +300,8 @@ class CabbagePluginAudioProcessor  : public AudioProcessor,
 #endif
 
     void updateCabbageControls();
-    void sendOutgoingMessagesToCsound();
+    bool sendOutgoingMessagesToCsound();
+    void updateHostChannels();
     int ksmpsOffset;
     bool CS_DEBUG_MODE;
     int pos;
@@ -170,6 +315,12 @@ class CabbagePluginAudioProcessor  : public AudioProcessor,
     //channel messages to Csound.
     Array<CabbageGUIType, CriticalSection> guiLayoutCtrls;
     Array<CabbageGUIType, CriticalSection> guiCtrls;
+    //what the editor's components were built from before the last refresh
+    Array<CabbageGUIType, CriticalSection> previousGuiLayoutCtrls;
+    Array<CabbageGUIType, CriticalSection> previousGuiCtrls;
+    bool canReuseWidgetComponents();
+    bool isWidgetUnchanged(CabbageGUIType& cAttr, bool isLayout, int index, const StringArray& rebuiltPlants,
+                           BigInteger& matched, int& previousIndex);
     String plantFlag, presetFlag;
     String debugMessage;
     StringArray debugMessageArray;
@@ -178,11 +329,7 @@ class CabbagePluginAudioProcessor  : public AudioProcessor,
     OwnedArray<XYPadAutomation, CriticalSection> xyAutomation;
     void updateGUIControlsKsmps(int speed);
     int guiRefreshRate;
-#ifdef Cabbage_No_Csound
-    std::vector<float> temp;
-#else
-    std::vector<MYFLT> temp;
-#endif
+    CabbageRefreshScheduler refreshScheduler;  //stretches guiRefreshRate to fit the CPU headroom
     TimeSliceThread backgroundThread; // the thread that will write our audio data to disk
     ScopedPointer<AudioFormatWriter::ThreadedWriter> threadedWriter; // the FIFO used to buffer the incoming data
     int64 nextSampleNum;
@@ -197,7 +344,8 @@ class CabbagePluginAudioProcessor  : public AudioProcessor,
 public:
 
     String changeMessage;
-    Array<int> dirtyControls;
+    CabbageDirtyWidgetSet dirtyWidgets;     //widgets the editor needs to refresh, see updateGUIControls()
+    Array<int> polledLayoutCtrls;           //layout widgets that are refreshed every time regardless
     bool CSOUND_DEBUG_MODE;
     int indexOfLastLayoutCtrl;
     int indexOfLastGUICtrl;
@@ -209,26 +357,16 @@ public:
     void initAllChannels();
     void createAndShowSourceEditor(LookAndFeel* looky);
     void actionListenerCallback (const String& message);
-    void addMacros(String csdText);
+    void addMacros(CabbageCsound* instance, String csdText);
     int screenWidth, screenHeight;
     int compileCsoundAndCreateGUI(bool isPlugin);
-    void setScreenMacros();
+    void setScreenMacros(CabbageCsound* instance);
 
     bool isFirstTime()
     {
         return firstTime;
     }
 
-    bool shouldUpdateFFTDisplay()
-    {
-        return updateFFTDisplay;
-    }
-
-    void resetUpdateFFTDisplayFlag()
-    {
-        updateFFTDisplay = false;
-    }
-
     int getNumberCsoundOutChannels()
     {
         return csound->GetNchnls();
@@ -239,14 +377,73 @@ public:
         return csound->GetNchnls();
     }
 
+    //these are at the host's rate, which is lower than Csound's when oversampling
     int getCsoundSamplingRate()
     {
-        return csound->GetSr();
+        return csound->GetSr()/oversampling;
     }
 
     int getCsoundKsmpsSize()
     {
-        return csound->GetKsmps();
+        return csound->GetKsmps()/oversampling;
+    }
+
+    int getOversampling() const
+    {
+        return oversampling;
+    }
+
+    //how processBlock() lines Csound's k-cycles up with the host's blocks
+    enum LatencyMode
+    {
+        bufferedLatency = 0,    //a k-cycle of input is buffered, adding ksmps of latency
+        alignedLatency          //k-cycles start on block boundaries and add nothing
+    };
+
+    LatencyMode getLatencyMode() const
+    {
+        return latencyMode;
+    }
+
+private:
+    LatencyMode latencyMode;
+    Atomic<int> latencyChanged;     //set by the audio thread, reported by timerCallback()
+    int reportedDroppedMessages;    //messageQueue drops logged so far
+    bool alignKsmps;                //the form asked for alignksmps(1)
+    int alignedKsmps;               //ksmps picked to divide the host block, in host samples, or 0
+    int preparedBlockSize;
+    bool hostRecompilePending;      //prepareToPlay() asked for the compile in flight, see swapInCompiledCsound()
+    bool compiledAsPlugin;          //compileCsoundAndCreateGUI() was told it's running as a plugin
+    int getRequestedKsmps(const File& file, int factor);
+    int getAlignedKsmps(int requestedKsmps) const;
+#ifndef Cabbage_No_Csound
+    void setRateOverrides(CSOUND_PARAMS* params, const File& file, int factor);
+    void setCompileOptions(CabbageCsound* instance, const File& file, const String& csdText, int factor);
+#endif
+    void chooseLatencyMode();
+    int getReportedLatency();
+    void performCsoundKsmps(int startSample, int hostKsmps);
+    void writeCsoundInput(float** audioBuffers, int startSample, int numFrames, int numChannels, int pos);
+    void readCsoundOutput(float** audioBuffers, int startSample, int numFrames, int numChannels, int pos);
+
+public:
+
+    //per-channel output levels, written by processBlock()
+    const CabbageLevelMeter& getLevelMeter() const
+    {
+        return levelMeter;
+    }
+
+    //smoothed audio thread load, as a fraction of the block deadline
+    float getCpuLoad() const
+    {
+        return refreshScheduler.getLoad();
+    }
+
+    //k-cycles between GUI updates before the scheduler adapts it, normally ksmps*2 or guirefresh()
+    void setGuiRefreshRate(int kCycles)
+    {
+        guiRefreshRate = jmax(1, kCycles);
     }
 
     void shouldBypass(bool val)
@@ -305,7 +502,11 @@ public:
 
     void startRecording();
     void stopRecording();
-    int recompileCsound(File file);
+    int recompileCsound(File file, bool inBackground=true);
+    void setRecompileCrossfadeTime(int milliseconds)
+    {
+        recompileCrossfadeTime = milliseconds;
+    }
     void openFile(LookAndFeel* looky);
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock);
@@ -346,7 +547,15 @@ public:
     StringArray getTableStatement(int tableNum);
     //const Array<double, CriticalSection> getTable(int tableNum);
     const Array<float, CriticalSection> getTableFloats(int tableNum);
-    fftDisplay* getFFTTable(int tableNum);
+    const CabbageTableSnapshot* getTableSnapshot(int tableNum);
+    const CabbageTableSnapshot* getGraphFrame(int windowNum);
+    //preset bank, see CabbagePresetBank
+    File getPresetBankFile() const;
+    bool loadPresetBank(const File& file);
+    void storePreset(const String& name);
+    bool recallPreset(const String& name);
+    void setMorphPresets(const Array<int>& presetIndexes);
+    int getNumDroppedGraphFrames() const;
     void initialiseWidgets(String source, bool refresh);
     void addWidgetsToEditor(bool refresh);
     int checkTable(int tableNum);
@@ -354,12 +563,22 @@ public:
     //midiBuffers
     MidiBuffer midiBuffer;
     MidiBuffer midiOutputBuffer;
+    //MIDI waiting to be read by Csound, queued one k-cycle at a time by processBlock()
+    enum { midiInputQueueSize = 4096 };
+    HeapBlock<uint8> midiInputQueue;
+    int midiInputQueueUsed;
+    int midiReadPosition;           //host block sample up to which input has been queued
+    int midiWritePosition;          //host block sample at which the current k-cycle starts
+    void queueMidiInput(int startSample, int endSample);
     MidiBuffer ccBuffer;
     bool showMIDI;
     bool yieldCallbackBool;
-    int yieldCounter, vuCounter;
+    int yieldCounter;
     bool nativePluginEditor;
     CabbageMessageQueue messageQueue;
+#ifndef Cabbage_No_Csound
+    CabbageTableUpdateMailbox tableUpdateMailbox;  //edited gentables waiting for the next k-cycle
+#endif
     StringArray scoreEvents;
     int averageSampleIndex;
     bool stopProcessing;
@@ -474,7 +693,18 @@ public:
 
     void clearDebugMessage()
     {
-        csoundOutput="";
+        console.clear();
+    }
+
+    //appends or replaces, as the return value says, what a console shows
+    bool readCsoundOutput(CabbageConsoleBuffer::Reader& reader, String& text)
+    {
+        return console.read(reader, text);
+    }
+
+    void setConsoleMaxLines(int maxLines)
+    {
+        console.setMaxLines(maxLines);
     }
 
     void setPluginName(String name)
@@ -489,9 +719,6 @@ public:
 
     //hold values from function tables
     Array<Array <float > > tableArrays;
-    //holds value from FFT function table created using dispfft
-    OwnedArray <fftDisplay, CriticalSection> fftArrays;
-    Array<int> windowIDs;
 
 
     Array<float> getTableArray(int index)
@@ -621,6 +848,8 @@ public:
         guiCtrls.add(cAttr);
     }
 
+    void resetDirtyWidgets();
+
 
     bool isGuiEnabled()
     {
@@ -0,0 +1,388 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+
+*/
+
+#include "../Plugin/CabbagePluginProcessor.h"
+
+//==============================================================================
+// cabbage-render: bounces a .csd to a float WAV file without an audio device.
+// The instrument is loaded into a CabbagePluginAudioProcessor and driven
+// through processBlock() as fast as the CPU allows, so channels, identchannels
+// and widget state go through exactly the same code as in the standalone.
+//
+// usage: cabbage-render file.csd -o out.wav [-b blocksize] [-d seconds]
+//                       [-a automation.txt] [-m file.mid]
+//
+// An automation script holds one event per line: "time channel value", where
+// time is in seconds and value is in the widget's own range. Comboboxes take
+// the item number and checkboxes and buttons 0 or 1. Lines starting with ';'
+// or '#' are ignored. Timing results are printed to stdout as JSON.
+//
+// With a MIDI file, every note on is matched to the nearest point where the
+// output starts to sound after a silence, and the distance between the two is
+// reported. With an instrument that responds to notes straight away, each
+// offset should equal the latency the processor reports.
+//==============================================================================
+
+//these are normally provided by StandaloneFilterApp.cpp
+ApplicationProperties* appProperties = nullptr;
+PropertySet* defaultPropSet = nullptr;
+String currentApplicationDirectory;
+StringArray undoHistory;
+
+extern CabbagePluginAudioProcessor* JUCE_CALLTYPE createCabbagePluginFilter(String inputfile, bool guiOnOff, int plugType);
+
+struct AutomationEvent
+{
+    int64 samplePosition;
+    int parameterIndex;
+    float value;
+};
+
+class AutomationEventSorter
+{
+public:
+    static int compareElements(const AutomationEvent& a, const AutomationEvent& b)
+    {
+        return a.samplePosition<b.samplePosition ? -1 : (a.samplePosition>b.samplePosition ? 1 : 0);
+    }
+};
+
+static int findParameterIndex(CabbagePluginAudioProcessor& processor, const String& channel)
+{
+    for(int i=0; i<processor.getGUICtrlsSize(); i++)
+        if(processor.getGUICtrls(i).getStringProp(CabbageIDs::channel)==channel)
+            return i;
+    return -1;
+}
+
+//setParameter() takes the 0-1 values a host sends, so script values are
+//scaled back the same way it scales them up
+static float normaliseForHost(const CabbageGUIType& guiCtrl, float value)
+{
+    const float range = guiCtrl.getRange();
+    const float comboRange = guiCtrl.getComboRange();
+
+    if(guiCtrl.getKind()==CabbageGUIType::comboboxWidget)
+        return comboRange!=0 ? value/comboRange : 0.f;
+    else if(guiCtrl.getKind()==CabbageGUIType::checkboxWidget ||
+            guiCtrl.getKind()==CabbageGUIType::buttonWidget)
+        return value;
+    else if(range!=0)
+        return (value-guiCtrl.getMin())/range;
+    return 0.f;
+}
+
+static bool loadAutomation(const File& file, CabbagePluginAudioProcessor& processor, double sampleRate, Array<AutomationEvent>& events)
+{
+    StringArray lines;
+    lines.addLines(file.loadFileAsString());
+    for(int i=0; i<lines.size(); i++)
+    {
+        const String line = lines[i].trim();
+        if(line.isEmpty() || line.startsWithChar(';') || line.startsWithChar('#'))
+            continue;
+
+        StringArray tokens;
+        tokens.addTokens(line, " \t", "\"");
+        tokens.removeEmptyStrings();
+        if(tokens.size()!=3)
+        {
+            std::cerr << file.getFileName() << ":" << i+1 << ": expected \"time channel value\"" << std::endl;
+            return false;
+        }
+
+        AutomationEvent event;
+        event.samplePosition = (int64)(tokens[0].getDoubleValue()*sampleRate);
+        event.parameterIndex = findParameterIndex(processor, tokens[1].unquoted());
+        event.value = tokens[2].getFloatValue();
+        if(event.parameterIndex<0)
+        {
+            std::cerr << file.getFileName() << ":" << i+1 << ": no widget uses channel " << tokens[1] << std::endl;
+            return false;
+        }
+        event.value = normaliseForHost(processor.getGUICtrls(event.parameterIndex), event.value);
+        events.add(event);
+    }
+
+    AutomationEventSorter sorter;
+    events.sort(sorter, true);
+    return true;
+}
+
+static bool loadMidiFile(const File& file, double sampleRate, MidiMessageSequence& sequence)
+{
+    FileInputStream stream(file);
+    MidiFile midiFile;
+    if(!stream.openedOk() || !midiFile.readFrom(stream))
+        return false;
+
+    midiFile.convertTimestampTicksToSeconds();
+    for(int i=0; i<midiFile.getNumTracks(); i++)
+        sequence.addSequence(*midiFile.getTrack(i), 0, 0, 1e9);
+    sequence.sort();
+
+    //from here on timestamps are sample positions
+    for(int i=0; i<sequence.getNumEvents(); i++)
+    {
+        MidiMessage& message = sequence.getEventPointer(i)->message;
+        message.setTimeStamp(message.getTimeStamp()*sampleRate);
+    }
+    return true;
+}
+
+//finds where sounds start in the rendered output: the first sample above
+//threshold after at least minGap samples at or below it
+class OnsetDetector
+{
+public:
+    OnsetDetector(int gapSamples) : minGap(gapSamples), quietSamples(gapSamples) {}
+
+    void process(const AudioSampleBuffer& buffer, int numSamples, int64 startPosition)
+    {
+        for(int i=0; i<numSamples; i++)
+        {
+            float peak = 0;
+            for(int channel=0; channel<buffer.getNumChannels(); channel++)
+                peak = jmax(peak, std::abs(buffer.getReadPointer(channel)[i]));
+
+            if(peak>threshold)
+            {
+                if(quietSamples>=minGap)
+                    onsets.add(startPosition+i);
+                quietSamples = 0;
+            }
+            else
+                quietSamples++;
+        }
+    }
+
+    const Array<int64>& getOnsets() const
+    {
+        return onsets;
+    }
+
+private:
+    static const float threshold;
+    int minGap, quietSamples;
+    Array<int64> onsets;
+};
+
+const float OnsetDetector::threshold = 0.001f;     //-60dB
+
+static double percentile(const Array<double>& sorted, double fraction)
+{
+    if(sorted.size()==0)
+        return 0;
+    return sorted[jlimit(0, sorted.size()-1, roundToInt(fraction*(sorted.size()-1)))];
+}
+
+//distance in samples from each note on to the onset nearest to it. Onsets
+//more than 50ms away are taken to belong to something else
+static String getOnsetTiming(const MidiMessageSequence& sequence, const Array<int64>& onsets,
+                             int latencySamples, double sampleRate)
+{
+    const int64 maxDistance = (int64)(0.05*sampleRate);
+    Array<double> offsets;
+    int notes = 0;
+    int onset = 0;
+    for(int i=0; i<sequence.getNumEvents(); i++)
+    {
+        const MidiMessage& message = sequence.getEventPointer(i)->message;
+        if(!message.isNoteOn())
+            continue;
+
+        notes++;
+        const int64 position = (int64)message.getTimeStamp();
+        while(onset+1<onsets.size() && std::abs(onsets[onset+1]-position)<=std::abs(onsets[onset]-position))
+            onset++;
+        if(onset<onsets.size() && std::abs(onsets[onset]-position)<=maxDistance)
+            offsets.add(double(onsets[onset]-position));
+    }
+
+    offsets.sort();
+    return "{\"notes\": "+String(notes)
+           +", \"matched\": "+String(offsets.size())
+           +", \"latencySamples\": "+String(latencySamples)
+           +", \"offsetSamples\": {\"min\": "+String(percentile(offsets, 0.0), 0)
+           +", \"p50\": "+String(percentile(offsets, 0.5), 0)
+           +", \"max\": "+String(percentile(offsets, 1.0), 0)+"}}";
+}
+
+static String getOption(const StringArray& args, const String& option, const String& defaultValue=String::empty)
+{
+    const int index = args.indexOf(option);
+    return (index>=0 && index<args.size()-1) ? args[index+1] : defaultValue;
+}
+
+static int usage()
+{
+    std::cerr << "usage: cabbage-render file.csd -o out.wav [-b blocksize] [-d seconds] "
+              "[-a automation.txt] [-m file.mid]" << std::endl;
+    return 1;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    StringArray args;
+    for(int i=1; i<argc; i++)
+        args.add(argv[i]);
+
+    if(args.size()==0 || !args[0].endsWithIgnoreCase(".csd") || getOption(args, "-o").isEmpty())
+        return usage();
+
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    const File csdFile(File::getCurrentWorkingDirectory().getChildFile(args[0]));
+    const File outputFile(File::getCurrentWorkingDirectory().getChildFile(getOption(args, "-o")));
+    const int blockSize = jmax(1, getOption(args, "-b", "512").getIntValue());
+
+    ScopedPointer<CabbagePluginAudioProcessor> processor = createCabbagePluginFilter(csdFile.getFullPathName(), false, AUDIO_PLUGIN);
+    if(processor->getCompileStatus()!=OK)
+    {
+        std::cerr << "Csound couldn't compile " << csdFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    const double sampleRate = processor->getCsoundSamplingRate();
+    const int numChannels = jmax(processor->getNumInputChannels(), processor->getNumOutputChannels());
+
+    Array<AutomationEvent> automation;
+    if(getOption(args, "-a").isNotEmpty()
+       && !loadAutomation(File::getCurrentWorkingDirectory().getChildFile(getOption(args, "-a")), *processor, sampleRate, automation))
+        return 1;
+
+    MidiMessageSequence midiSequence;
+    if(getOption(args, "-m").isNotEmpty()
+       && !loadMidiFile(File::getCurrentWorkingDirectory().getChildFile(getOption(args, "-m")), sampleRate, midiSequence))
+    {
+        std::cerr << "couldn't read MIDI file " << getOption(args, "-m") << std::endl;
+        return 1;
+    }
+
+    //without -d, render until the score ends. MIDI files get two seconds of tail
+    //on top of their last event, and scores that never end are stopped at ten minutes
+    double duration = getOption(args, "-d", "0").getDoubleValue();
+    const bool untilScoreEnds = duration<=0;
+    if(untilScoreEnds)
+        duration = midiSequence.getNumEvents()>0 ? midiSequence.getEndTime()/sampleRate+2.0 : 600.0;
+    const int64 totalSamples = (int64)(duration*sampleRate);
+
+    outputFile.deleteFile();
+    ScopedPointer<FileOutputStream> outputStream = outputFile.createOutputStream();
+    ScopedPointer<AudioFormatWriter> writer;
+    if(outputStream!=nullptr)
+        writer = WavAudioFormat().createWriterFor(outputStream, sampleRate, numChannels, 32, StringPairArray(), 0);
+    if(writer==nullptr)
+    {
+        std::cerr << "couldn't write to " << outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+    outputStream.release();     //the writer owns the stream now
+
+    //nothing is waiting on the output, so the processor can take its time
+    processor->setNonRealtime(true);
+    processor->prepareToPlay(sampleRate, blockSize);
+
+    AudioSampleBuffer buffer(numChannels, blockSize);
+    MidiBuffer midiBuffer;
+    Array<double> blockTimes;
+    blockTimes.ensureStorageAllocated((int)(totalSamples/blockSize)+1);
+    OnsetDetector onsetDetector((int)(0.01*sampleRate));
+    int nextAutomationEvent = 0;
+    int nextMidiEvent = 0;
+    int64 samplesRendered = 0;
+
+    const int64 renderStart = Time::getHighResolutionTicks();
+    while(samplesRendered<totalSamples && processor->getCompileStatus()==OK)
+    {
+        const int numSamples = (int)jmin((int64)blockSize, totalSamples-samplesRendered);
+        buffer.clear();
+        float** channels = buffer.getArrayOfWritePointers();
+
+        const int64 blockStart = Time::getHighResolutionTicks();
+        //split the block wherever an automation event falls, so each one reaches
+        //Csound on the k-cycle it belongs to, as it would from a sample accurate host
+        for(int start=0; start<numSamples;)
+        {
+            while(nextAutomationEvent<automation.size()
+                  && automation.getReference(nextAutomationEvent).samplePosition<=samplesRendered+start)
+            {
+                const AutomationEvent& event = automation.getReference(nextAutomationEvent++);
+                processor->setParameter(event.parameterIndex, event.value);
+            }
+
+            int end = numSamples;
+            if(nextAutomationEvent<automation.size())
+                end = (int)jmin((int64)numSamples, automation.getReference(nextAutomationEvent).samplePosition-samplesRendered);
+
+            midiBuffer.clear();
+            while(nextMidiEvent<midiSequence.getNumEvents()
+                  && midiSequence.getEventTime(nextMidiEvent)<samplesRendered+end)
+            {
+                const MidiMessage& message = midiSequence.getEventPointer(nextMidiEvent++)->message;
+                const int position = jmax(0, (int)((int64)message.getTimeStamp()-samplesRendered)-start);
+                midiBuffer.addEvent(message, position);
+            }
+
+            AudioSampleBuffer span(channels, numChannels, start, end-start);
+            processor->processBlock(span, midiBuffer);
+            start = end;
+        }
+        blockTimes.add(Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-blockStart));
+
+        writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+        if(midiSequence.getNumEvents()>0)
+            onsetDetector.process(buffer, numSamples, samplesRendered);
+        samplesRendered += numSamples;
+
+        //let identchannel updates and change messages run as they would on the GUI thread
+        MessageManager::getInstance()->runDispatchLoopUntil(0);
+    }
+    const double renderSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks()-renderStart);
+
+    writer = nullptr;
+    processor->releaseResources();
+
+    if(untilScoreEnds && processor->getCompileStatus()==OK && midiSequence.getNumEvents()==0)
+        std::cerr << "the score didn't end, stopped after " << duration << " seconds" << std::endl;
+
+    const double audioSeconds = samplesRendered/sampleRate;
+    blockTimes.sort();
+    const double blockDeadline = blockSize/sampleRate;
+    std::cout << "{\n"
+              << "  \"file\": \"" << csdFile.getFileName() << "\",\n"
+              << "  \"output\": \"" << outputFile.getFullPathName() << "\",\n"
+              << "  \"sampleRate\": " << sampleRate << ",\n"
+              << "  \"channels\": " << numChannels << ",\n"
+              << "  \"blockSize\": " << blockSize << ",\n"
+              << "  \"audioSeconds\": " << String(audioSeconds, 3) << ",\n"
+              << "  \"renderSeconds\": " << String(renderSeconds, 3) << ",\n"
+              << "  \"realtimeFactor\": " << String(renderSeconds>0 ? audioSeconds/renderSeconds : 0.0, 2) << ",\n"
+              << "  \"blockDeadlineUs\": " << String(blockDeadline*1.0e6, 1) << ",\n"
+              << "  \"blockUs\": {\"p50\": " << String(percentile(blockTimes, 0.5)*1.0e6, 1)
+              << ", \"p90\": " << String(percentile(blockTimes, 0.9)*1.0e6, 1)
+              << ", \"p99\": " << String(percentile(blockTimes, 0.99)*1.0e6, 1)
+              << ", \"max\": " << String(percentile(blockTimes, 1.0)*1.0e6, 1) << "}";
+    if(midiSequence.getNumEvents()>0)
+        std::cout << ",\n  \"midiOnsets\": "
+                  << getOnsetTiming(midiSequence, onsetDetector.getOnsets(), processor->getLatencySamples(), sampleRate);
+    std::cout << "\n}" << std::endl;
+    return 0;
+}
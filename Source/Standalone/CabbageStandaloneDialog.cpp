@@ -77,6 +77,7 @@ StandaloneFilterWindow::StandaloneFilterWindow (const String& title,
     JUCE_TRY
     {
         filter = createCabbagePluginFilter("", false, AUDIO_PLUGIN);
+        resetConsoles();
         filter->addChangeListener(this);
         filter->addActionListener(this);
         filter->sendChangeMessage();
@@ -371,17 +372,28 @@ void StandaloneFilterWindow::timerCallback()
     }
 
 
+    //only lines printed since the last tick are added to each console
+    String consoleText;
     if(outputConsole)
-        if(outputConsole->getText()!=filter->getCsoundOutput())
-            outputConsole->setText(filter->getCsoundOutput());
+    {
+        if(filter->readCsoundOutput(outputConsoleReader, consoleText))
+        {
+            if(consoleText.isNotEmpty())
+                outputConsole->appendText(consoleText);
+        }
+        else
+            outputConsole->setText(consoleText);
+    }
 
     if(cabbageCsoundEditor->isVisible())
     {
-        if(cabbageCsoundEditor->csoundOutputComponent->getText()!=filter->getCsoundOutput())
+        if(filter->readCsoundOutput(editorConsoleReader, consoleText))
         {
-            cabbageCsoundEditor->csoundOutputComponent->setText(filter->getCsoundOutput());
-            filter->clearDebugMessage();
+            if(consoleText.isNotEmpty())
+                cabbageCsoundEditor->csoundOutputComponent->appendText(consoleText);
         }
+        else
+            cabbageCsoundEditor->csoundOutputComponent->setText(consoleText);
 #ifdef BUILD_DEBUGGER
         cabbageCsoundEditor->csoundDebuggerComponent->setText(filter->getDebuggerOutput());
 #endif
@@ -617,6 +629,22 @@ void StandaloneFilterWindow::deleteFilter()
     filter = nullptr;
 }
 
+//==============================================================================
+// Start the consoles reading from a newly created filter
+//==============================================================================
+void StandaloneFilterWindow::resetConsoles()
+{
+    const int maxLines = getPreference(appProperties, "ConsoleMaxLines");
+    if(maxLines>0)
+        filter->setConsoleMaxLines(maxLines);
+
+    //the output console only shows the current filter, the editor's keeps what it had
+    if(outputConsole)
+        outputConsole->setText("");
+    outputConsoleReader = CabbageConsoleBuffer::Reader();
+    editorConsoleReader = CabbageConsoleBuffer::Reader();
+}
+
 //==============================================================================
 // Reset filter
 //==============================================================================
@@ -640,6 +668,7 @@ void StandaloneFilterWindow::resetFilter(bool shouldResetFilter)
             savedState = globalSettings->getXmlValue ("audioSetup");
 
         filter = createCabbagePluginFilter(csdFile.getFullPathName(), false, AUDIO_PLUGIN);
+        resetConsoles();
         filter->addChangeListener(this);
         filter->addActionListener(this);
         if(cabbageCsoundEditor)
@@ -1097,7 +1126,9 @@ void StandaloneFilterWindow::buttonClicked (Button*)
                                             getPosition().getY()+getHeight(),
                                             getPosition().getX());
                                     outputConsole->setLookAndFeel(lookAndFeel);
-                                    outputConsole->setText(filter->getCsoundOutput());
+                                    //the timer fills it from the start of the buffer
+                                    outputConsole->setText("");
+                                    outputConsoleReader = CabbageConsoleBuffer::Reader();
                                     if(getPreference(appProperties, "ShowConsoleWithEditor"))
                                     {
                                         outputConsole->setAlwaysOnTop(true);
@@ -1144,7 +1175,9 @@ void StandaloneFilterWindow::buttonClicked (Button*)
                         getPosition().getY()+getHeight(),
                         getPosition().getX());
                 outputConsole->setLookAndFeel(lookAndFeel);
-                outputConsole->setText(filter->getCsoundOutput());
+                //the timer fills it from the start of the buffer
+                outputConsole->setText("");
+                outputConsoleReader = CabbageConsoleBuffer::Reader();
                 outputConsole->setAlwaysOnTop(true);
                 outputConsole->toFront(true);
                 outputConsole->setVisible(true);
@@ -1489,6 +1522,7 @@ void StandaloneFilterWindow::showEditorConsole()
 {
 
     cabbageCsoundEditor->csoundOutputComponent->setText("");
+    editorConsoleReader = CabbageConsoleBuffer::Reader();
     cabbageCsoundEditor->splitWindow->SetSplitBarPosition(cabbageCsoundEditor->getHeight()-(cabbageCsoundEditor->getHeight()/4));
 }
 
@@ -1516,7 +1550,9 @@ void StandaloneFilterWindow::openTextEditor()
                                 getPosition().getY()+getHeight(),
                                 getPosition().getX());
                         outputConsole->setLookAndFeel(lookAndFeel);
-                        outputConsole->setText(filter->getCsoundOutput());
+                        //the timer fills it from the start of the buffer
+                        outputConsole->setText("");
+                        outputConsoleReader = CabbageConsoleBuffer::Reader();
                         outputConsole->setAlwaysOnTop(true);
                         outputConsole->toFront(true);
                         outputConsole->setVisible(true);
@@ -45,6 +45,7 @@ public:
         textEditor->setColour(TextEditor::backgroundColourId, Colours::black);
         textEditor->setColour(TextEditor::textColourId, Colours::red);
         textEditor->setMultiLine(true);
+        textEditor->setReadOnly(true);
         setSize(700, 200);
         setTopLeftPosition(top, left);
         setAlwaysOnTop(true);
@@ -67,7 +68,13 @@ public:
     {
         textEditor->setColour(TextEditor::textColourId, Colours::cornflowerblue);
         textEditor->setText(text);
-        textEditor->setCaretPosition(textEditor->getText().length());
+        textEditor->moveCaretToEnd();
+    }
+
+    void appendText(String text)
+    {
+        textEditor->moveCaretToEnd();
+        textEditor->insertTextAtCaret(text);
     }
 
     String getText()
@@ -184,6 +191,8 @@ private:
     ScopedPointer<CodeWindow> cabbageCsoundEditor;
     String consoleMessages;
     ScopedPointer<CsoundMessageConsole> outputConsole;
+    CabbageConsoleBuffer::Reader outputConsoleReader, editorConsoleReader;
+    void resetConsoles();
     StringArray previousScoreEvents;
     ScopedPointer<CabbageSlider> gridSizeSlider;
 
@@ -59,6 +59,7 @@ public:
         defaultPropSet->setValue("DisableCompilerErrorWarning", 0);
         defaultPropSet->setValue("SetAlwaysOnTop", 1);
         defaultPropSet->setValue("GridSize", 4);
+        defaultPropSet->setValue("ConsoleMaxLines", CabbageConsoleBuffer::defaultMaxLines);
         defaultPropSet->setValue("PlantRepository", xml);
         defaultPropSet->setValue("EditorColourScheme", 0);
         defaultPropSet->setValue("showTabs", 1);